@@ -0,0 +1,95 @@
+#include <sourcerer/node.hpp>
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr std::size_t keys = 64;
+
+// Half of the probed keys are missing, like optional settings usually are.
+Node settings() {
+  Node root;
+  for (std::size_t i = 0; i < keys; i += 2) {
+    root.insert("key" + std::to_string(i), static_cast<int>(i));
+  }
+  return root;
+}
+
+std::vector<std::string> probes() {
+  std::vector<std::string> names;
+  for (std::size_t i = 0; i < keys; ++i) names.push_back("key" + std::to_string(i));
+  return names;
+}
+
+}  // namespace
+
+int main() {
+  const auto root = settings();
+  const auto names = probes();
+
+#if SOURCERER_EXCEPTIONS
+  report("at() and catch", measure([&] {
+           int sum = 0;
+           for (const auto& name : names) {
+             try {
+               sum += root.at(name).as<int>();
+             } catch (const std::out_of_range&) {
+               sum += 1;
+             }
+           }
+           do_not_optimize(sum);
+         }),
+         keys);
+#endif
+  report("find()", measure([&] {
+           int sum = 0;
+           for (const auto& name : names) {
+             const auto* child = root.find(name);
+             sum += child != nullptr ? child->as<int>() : 1;
+           }
+           do_not_optimize(sum);
+         }),
+         keys);
+  report("try_at() and try_as()", measure([&] {
+           int sum = 0;
+           for (const auto& name : names) {
+             const auto child = root.try_at(name);
+             sum += child ? child->try_as<int>().value_or(1) : 1;
+           }
+           do_not_optimize(sum);
+         }),
+         keys);
+
+  // Half of the values aren't numbers.
+  std::vector<Node> values;
+  for (std::size_t i = 0; i < keys; ++i) {
+    values.emplace_back(i % 2 == 0 ? std::to_string(i) : "n/a");
+  }
+#if SOURCERER_EXCEPTIONS
+  report("as<int>() and catch", measure([&] {
+           int sum = 0;
+           for (const auto& value : values) {
+             try {
+               sum += value.as<int>();
+             } catch (const std::invalid_argument&) {
+               sum += 1;
+             }
+           }
+           do_not_optimize(sum);
+         }),
+         keys);
+#endif
+  report("try_as<int>()", measure([&] {
+           int sum = 0;
+           for (const auto& value : values) sum += value.try_as<int>().value_or(1);
+           do_not_optimize(sum);
+         }),
+         keys);
+}
@@ -0,0 +1,93 @@
+#include <sourcerer/bind.hpp>
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "documents.hpp"
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr std::size_t services = 10000;
+
+struct Tls {
+  std::string certificate_file;
+  bool verify_peer = false;
+};
+
+struct Service {
+  std::string name;
+  std::string host;
+  int port = 0;
+  double timeout_ms = 0;
+  int retries = 0;
+  bool enabled = false;
+  std::vector<std::string> tags;
+  Tls tls;
+};
+
+struct Config {
+  std::vector<Service> services;
+};
+
+Node parse(std::string text) {
+  StringConjurer conjurer{std::move(text)};
+  return JsonSourcerer{conjurer}.source();
+}
+
+// How it's done by hand.
+Config read_by_hand(const Node& root) {
+  Config config;
+  const auto& list = root.at("services");
+  config.services.reserve(list.size());
+  for (const auto& node : list) {
+    auto& service = config.services.emplace_back();
+    service.name = node.at("name").as<std::string>();
+    service.host = node.at("host").as<std::string>();
+    service.port = node.at("port").as<int>();
+    service.timeout_ms = node.at("timeout_ms").as<double>();
+    service.retries = node.at("retries").as<int>();
+    service.enabled = node.at("enabled").as<bool>();
+    for (const auto& tag : node.at("tags")) {
+      service.tags.push_back(tag.as<std::string>());
+    }
+    service.tls.certificate_file = node.at("tls").at("certificate_file").as<std::string>();
+    service.tls.verify_peer = node.at("tls").at("verify_peer").as<bool>();
+  }
+  return config;
+}
+
+}  // namespace
+
+template <>
+struct sourcerer::binding<Tls> {
+  static constexpr field_list fields{field("certificate_file", &Tls::certificate_file),
+                                     field("verify_peer", &Tls::verify_peer)};
+};
+
+template <>
+struct sourcerer::binding<Service> {
+  static constexpr field_list fields{
+      field("name", &Service::name),       field("host", &Service::host),
+      field("port", &Service::port),       field("timeout_ms", &Service::timeout_ms),
+      field("retries", &Service::retries), field("enabled", &Service::enabled),
+      field("tags", &Service::tags),       field("tls", &Service::tls)};
+};
+
+template <>
+struct sourcerer::binding<Config> {
+  static constexpr field_list fields{field("services", &Config::services)};
+};
+
+int main() {
+  const auto root = parse(services_document(services));
+
+  report("by hand", measure([&] { do_not_optimize(read_by_hand(root)); }), services);
+  report("bind", measure([&] { do_not_optimize(bind<Config>(root)); }), services);
+}
@@ -0,0 +1,49 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/diff.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <cstdio>
+#include <string>
+#include <utility>
+
+#include "documents.hpp"
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr std::size_t services = 10000;
+
+Node parse(std::string text) {
+  StringConjurer conjurer{std::move(text)};
+  return JsonSourcerer{conjurer}.source();
+}
+
+}  // namespace
+
+int main() {
+  const auto document = services_document(services);
+  auto changed_document = document;
+  changed_document[changed_document.rfind("\"port\": ") + 8] = '9';
+
+  const auto tree = parse(document);
+  const auto same = parse(document);
+  const auto changed = parse(changed_document);
+  std::printf("%zu services\n", services);
+
+  // Hashing the first time walks the tree, after that the root has it cached.
+  report("parse", measure([&] { do_not_optimize(parse(document)); }));
+  report("parse and hash", measure([&] { do_not_optimize(parse(document).hash()); }));
+  report("hash/cached", measure([&] { do_not_optimize(tree.hash()); }));
+
+  const auto copy = tree;
+  report("==/copy", measure([&] { do_not_optimize(tree == copy); }));
+  report("==/one value changed", measure([&] { do_not_optimize(tree == changed); }));
+  // Equal hashes are verified by comparing the trees.
+  report("==/equal trees", measure([&] { do_not_optimize(tree == same); }));
+
+  report("diff/equal trees", measure([&] { do_not_optimize(diff(tree, same)); }));
+  report("diff/one value changed", measure([&] { do_not_optimize(diff(tree, changed)); }));
+}
@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sourcerer::benchmarks {
+
+// A JSON configuration of many services, roughly 300 bytes each.
+inline std::string services_document(const std::size_t services) {
+  std::string text = R"({"services": [)";
+  for (std::size_t i = 0; i < services; ++i) {
+    if (i != 0) text += ',';
+    const auto n = std::to_string(i);
+    text += R"({"name": "service_)" + n + R"(", "host": "10.0.)" + std::to_string(i % 256) +
+            R"(.1", "port": )" + std::to_string(8000 + i % 1000) +
+            R"(, "timeout_ms": 250.5, "retries": 3, "enabled": )" +
+            (i % 2 == 0 ? "true" : "false") +
+            R"(, "tags": ["a", "b", "c"], "tls": {"certificate_file": "/etc/ssl/certs/)" + n +
+            R"(.pem", "verify_peer": true}})";
+  }
+  text += "]}";
+  return text;
+}
+
+// The shapes of generated documents.
+enum class shape {
+  // One object with many keys.
+  wide,
+  // Chains of nested objects.
+  deep,
+  // Rows of integers and decimals.
+  numeric,
+  // Records of long strings with escapes.
+  textual,
+};
+
+constexpr std::array<shape, 4> shapes = {shape::wide, shape::deep, shape::numeric, shape::textual};
+
+inline const char* name_of(const shape kind) {
+  switch (kind) {
+    case shape::wide:
+      return "wide";
+    case shape::deep:
+      return "deep";
+    case shape::numeric:
+      return "numeric";
+    case shape::textual:
+      return "textual";
+  }
+  return "";
+}
+
+/**
+ * @brief Pseudo-random numbers that are the same on every platform, unlike the distributions of
+ * <random>. This is splitmix64.
+ */
+class random_numbers {
+ public:
+  explicit random_numbers(const std::uint64_t seed) : state_{seed} {}
+
+  std::uint64_t operator()() {
+    auto z = (state_ += 0x9E3779B97F4A7C15);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EB;
+    return z ^ (z >> 31);
+  }
+
+  // A number in [0, bound).
+  std::uint64_t below(const std::uint64_t bound) { return (*this)() % bound; }
+
+ private:
+  std::uint64_t state_;
+};
+
+inline void append_number(std::string& text, random_numbers& random) {
+  char buffer[32];
+  const auto length =
+      random.below(2) == 0
+          ? std::snprintf(buffer, sizeof(buffer), "%lld",
+                          static_cast<long long>(random.below(2000000001)) - 1000000000)
+          : std::snprintf(buffer, sizeof(buffer), "%.*f", static_cast<int>(1 + random.below(6)),
+                          static_cast<double>(random.below(200000000)) / 1000.0 - 100000.0);
+  text.append(buffer, static_cast<std::size_t>(length));
+}
+
+inline void append_words(std::string& text, random_numbers& random, const std::size_t count) {
+  constexpr std::array<std::string_view, 16> words = {
+      "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+      "india", "juliet", "kilo", "lima", "mike", "tab\\t", "quote\\\"", "line\\n"};
+  for (std::size_t i = 0; i < count; ++i) {
+    if (i != 0) text += ' ';
+    text += words[random.below(words.size())];
+  }
+}
+
+inline void append_value(std::string& text, random_numbers& random) {
+  switch (random.below(4)) {
+    case 0:
+      append_number(text, random);
+      break;
+    case 1:
+      text += random.below(2) == 0 ? "true" : "false";
+      break;
+    case 2:
+      text += '"';
+      append_words(text, random, 1 + random.below(3));
+      text += '"';
+      break;
+    default:
+      text += "null";
+  }
+}
+
+/**
+ * @brief A JSON document of the given shape that is at least bytes bytes long, and not much longer.
+ *
+ * The same arguments always give the same document.
+ */
+inline std::string generate_document(const shape kind, const std::size_t bytes,
+                                     const std::uint64_t seed = 42) {
+  random_numbers random{seed};
+  std::string text;
+  text.reserve(bytes + 1024);
+
+  const auto wide = kind == shape::wide;
+  text += wide ? '{' : '[';
+  for (std::size_t i = 0; text.size() < bytes; ++i) {
+    if (i != 0) text += ',';
+    switch (kind) {
+      case shape::wide:
+        text += "\"key_" + std::to_string(i) + "\": ";
+        append_value(text, random);
+        break;
+      case shape::deep: {
+        const auto depth = 16 + random.below(49);
+        for (std::size_t level = 0; level < depth; ++level) {
+          text += "{\"level\": " + std::to_string(level) + ", \"child\": ";
+        }
+        append_value(text, random);
+        text.append(depth, '}');
+        break;
+      }
+      case shape::numeric:
+        text += '[';
+        for (std::size_t column = 0; column < 16; ++column) {
+          if (column != 0) text += ", ";
+          append_number(text, random);
+        }
+        text += ']';
+        break;
+      case shape::textual:
+        text += "{\"title\": \"";
+        append_words(text, random, 2 + random.below(4));
+        text += "\", \"description\": \"";
+        append_words(text, random, 16 + random.below(32));
+        text += "\", \"path\": \"C:\\\\data\\\\" + std::to_string(i) + ".txt\"}";
+        break;
+    }
+  }
+  text += wide ? '}' : ']';
+  return text;
+}
+
+// The sizes of generated documents to benchmark with, and their names. Larger ones than
+// SOURCERER_BENCHMARK_MAX_BYTES, if it's set, are left out for small machines.
+inline std::vector<std::pair<std::size_t, std::string>> document_sizes() {
+  std::vector<std::pair<std::size_t, std::string>> sizes = {
+      {1000, "1 KB"}, {1000000, "1 MB"}, {100000000, "100 MB"}};
+  if (const char* max = std::getenv("SOURCERER_BENCHMARK_MAX_BYTES"); max != nullptr) {
+    const auto max_bytes = std::strtoull(max, nullptr, 10);
+    std::erase_if(sizes, [&](const auto& size) { return size.first > max_bytes; });
+  }
+  return sizes;
+}
+
+}  // namespace sourcerer::benchmarks
@@ -0,0 +1,27 @@
+#include <sourcerer/conjurers/file_conjurer.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "documents.hpp"
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+int main() {
+  // The file was just written, so this measures reading it from the page cache.
+  const auto path = std::filesystem::temp_directory_path() / "sourcerer_file_conjurer.json";
+  for (const auto& [bytes, size] : document_sizes()) {
+    const auto document = generate_document(shape::textual, bytes);
+    std::ofstream{path, std::ios::binary} << document;
+
+    FileConjurer conjurer{path.string()};
+    const auto ns =
+        measure([&] { do_not_optimize(conjurer.conjure()); }, std::chrono::milliseconds{200});
+    report_throughput("conjure/" + size, ns, document.size());
+  }
+  std::filesystem::remove(path);
+}
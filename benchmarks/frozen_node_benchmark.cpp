@@ -0,0 +1,93 @@
+#include <sourcerer/frozen_node.hpp>
+#include <sourcerer/node.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+std::vector<std::string> make_keys(const std::size_t size) {
+  std::vector<std::string> keys;
+  keys.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    keys.push_back("config_key_" + std::to_string(i));
+  }
+
+  std::ranges::shuffle(keys, std::mt19937{42});
+  return keys;
+}
+
+void run(const std::vector<std::string>& keys) {
+  Node node;
+  for (const auto& key : keys) {
+    node.insert(key, Node::array_t{Node{1}, Node{2}, Node{3}});
+  }
+  const auto& source = std::as_const(node);
+  const auto tree = freeze(node);
+  const auto& frozen = tree.root();
+
+  std::vector<Key> interned;
+  for (const auto& key : keys) {
+    interned.push_back(node.keys()->intern(key));
+  }
+
+  const auto size = std::to_string(keys.size());
+
+  report("Node/lookup/" + size, measure([&] {
+           for (const auto& key : keys) {
+             do_not_optimize(source.at(std::string_view{key}));
+           }
+         }),
+         keys.size());
+  report("FrozenNode/lookup/" + size, measure([&] {
+           for (const auto& key : keys) {
+             do_not_optimize(frozen.at(std::string_view{key}));
+           }
+         }),
+         keys.size());
+
+  report("Node/lookup interned/" + size, measure([&] {
+           for (const auto& key : interned) {
+             do_not_optimize(source.at(key));
+           }
+         }),
+         keys.size());
+  report("FrozenNode/lookup interned/" + size, measure([&] {
+           for (const auto& key : interned) {
+             do_not_optimize(frozen.at(key));
+           }
+         }),
+         keys.size());
+
+  report("Node/iterate/" + size, measure([&] {
+           for (const auto& child : source) {
+             for (const auto& element : child) {
+               do_not_optimize(element.as<int>());
+             }
+           }
+         }),
+         keys.size());
+  report("FrozenNode/iterate/" + size, measure([&] {
+           for (const auto& child : frozen) {
+             for (const auto& element : child) {
+               do_not_optimize(element.as<int>());
+             }
+           }
+         }),
+         keys.size());
+}
+
+}  // namespace
+
+int main() {
+  for (const std::size_t size : {4, 16, 64, 1024, 65536}) {
+    run(make_keys(size));
+  }
+}
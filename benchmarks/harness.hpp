@@ -0,0 +1,161 @@
+#pragma once
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sourcerer::benchmarks {
+
+// Keeps the compiler from optimizing away the computation of value.
+template <class T>
+inline void do_not_optimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @brief Runs fn repeatedly for at least min_time and returns the mean duration of one call in
+ * nanoseconds.
+ */
+template <class Fn>
+double measure(Fn&& fn, const std::chrono::nanoseconds min_time = std::chrono::milliseconds{100}) {
+  using clock = std::chrono::steady_clock;
+
+  // Warm up caches and branch predictors.
+  fn();
+
+  std::size_t iterations = 0;
+  const auto start = clock::now();
+  auto elapsed = clock::duration{};
+  do {
+    fn();
+    ++iterations;
+    elapsed = clock::now() - start;
+  } while (elapsed < min_time);
+
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+  return static_cast<double>(ns) / static_cast<double>(iterations);
+}
+
+/**
+ * @brief The results a benchmark reported, written as JSON when the process exits.
+ *
+ * The file is the one SOURCERER_BENCHMARK_JSON names, if it's set. It holds an array of
+ * {"name", "value", "unit"} objects in the order they were reported, so two runs can be diffed.
+ */
+class Results {
+ public:
+  Results() = default;
+  Results(const Results&) = delete;
+  Results& operator=(const Results&) = delete;
+
+  ~Results() {
+    const char* path = std::getenv("SOURCERER_BENCHMARK_JSON");
+    if (path == nullptr || *path == '\0') return;
+
+    auto* file = std::fopen(path, "w");
+    if (file == nullptr) {
+      std::fprintf(stderr, "Can't write benchmark results to %s\n", path);
+      return;
+    }
+    std::fputs("[", file);
+    for (std::size_t i = 0; i < results_.size(); ++i) {
+      const auto& result = results_[i];
+      std::fprintf(file, "%s\n  {\"name\": \"%s\", \"value\": %.6g, \"unit\": \"%s\"}",
+                   i == 0 ? "" : ",", escaped(result.name).c_str(), result.value,
+                   escaped(result.unit).c_str());
+    }
+    std::fputs("\n]\n", file);
+    std::fclose(file);
+  }
+
+  void add(std::string_view name, const double value, std::string_view unit) {
+    results_.push_back({std::string{name}, value, std::string{unit}});
+  }
+
+ private:
+  struct result {
+    std::string name;
+    double value;
+    std::string unit;
+  };
+
+  static std::string escaped(std::string_view text) {
+    std::string json;
+    for (const auto c : text) {
+      if (c == '"' || c == '\\') json += '\\';
+      json += c;
+    }
+    return json;
+  }
+
+  std::vector<result> results_;
+};
+
+inline Results& results() {
+  static Results results;
+  return results;
+}
+
+// Prints a result of a benchmark and records it for the JSON output.
+inline void record(std::string_view name, const double value, std::string_view unit) {
+  std::printf("%-48.*s %12.3f %.*s\n", static_cast<int>(name.size()), name.data(), value,
+              static_cast<int>(unit.size()), unit.data());
+  results().add(name, value, unit);
+}
+
+// Prints the time per item of a benchmark, where one run of it processed items items.
+inline void report(std::string_view name, const double ns_per_run, const std::size_t items = 1) {
+  record(name, ns_per_run / static_cast<double>(items), "ns/item");
+}
+
+// Prints the throughput of a benchmark, where one run of it processed bytes bytes.
+inline void report_throughput(std::string_view name, const double ns_per_run,
+                              const std::size_t bytes) {
+  record(name, static_cast<double>(bytes) / ns_per_run, "GB/s");
+}
+
+// The peak resident set size of this process so far, in KiB.
+inline long max_rss_kb() {
+  rusage usage{};
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+/**
+ * @brief Runs fn once in a child process and returns how far it raised the peak resident set size,
+ * in KiB.
+ *
+ * Every call starts from a copy of the current heap. Memory this process freed before is reused
+ * by the child without growing its resident set, so measure before running anything big here.
+ */
+template <class Fn>
+long peak_rss_growth_kb(Fn&& fn) {
+  int fds[2];
+  if (pipe(fds) != 0) std::abort();
+
+  const auto child = fork();
+  if (child == 0) {
+    close(fds[0]);
+    const auto before = max_rss_kb();
+    fn();
+    const auto grown = max_rss_kb() - before;
+    if (write(fds[1], &grown, sizeof(grown)) != sizeof(grown)) std::_Exit(1);
+    std::_Exit(0);
+  }
+
+  close(fds[1]);
+  long grown = -1;
+  if (read(fds[0], &grown, sizeof(grown)) != sizeof(grown)) grown = -1;
+  close(fds[0]);
+  waitpid(child, nullptr, 0);
+  return grown;
+}
+
+}  // namespace sourcerer::benchmarks
@@ -0,0 +1,69 @@
+#include <sourcerer/node.hpp>
+
+#include <cstdint>
+#include <string>
+
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr std::size_t elements = 1000000;
+constexpr std::size_t members = 100000;
+
+}  // namespace
+
+int main() {
+  Node array{Node::array_t{}};
+  array.reserve(elements);
+  for (std::size_t i = 0; i < elements; ++i) array.push_back(static_cast<std::int64_t>(i));
+  Node object{Node::object_t{}};
+  object.reserve(members);
+  for (std::size_t i = 0; i < members; ++i) {
+    object.insert("key_" + std::to_string(i), static_cast<std::int64_t>(i));
+  }
+  const auto& const_array = array;
+  const auto& const_object = object;
+
+  report("array/Node::iterator", measure([&] {
+           std::int64_t sum = 0;
+           for (const auto& element : const_array) sum += element.as<std::int64_t>();
+           do_not_optimize(sum);
+         }),
+         elements);
+  report("array/operator[]", measure([&] {
+           std::int64_t sum = 0;
+           for (std::size_t i = 0; i < elements; ++i) sum += const_array[i].as<std::int64_t>();
+           do_not_optimize(sum);
+         }),
+         elements);
+  report("array/as_array()", measure([&] {
+           std::int64_t sum = 0;
+           for (const auto& element : const_array.as_array()) sum += element.as<std::int64_t>();
+           do_not_optimize(sum);
+         }),
+         elements);
+  report("array/numbers()", measure([&] {
+           std::int64_t sum = 0;
+           for (const auto number : const_array.numbers<std::int64_t>()) sum += number;
+           do_not_optimize(sum);
+         }),
+         elements);
+
+  report("object/Node::iterator", measure([&] {
+           std::int64_t sum = 0;
+           for (const auto& value : const_object) sum += value.as<std::int64_t>();
+           do_not_optimize(sum);
+         }),
+         members);
+  report("object/items()", measure([&] {
+           std::int64_t sum = 0;
+           for (const auto& [key, value] : const_object.items()) {
+             sum += value.as<std::int64_t>() + static_cast<std::int64_t>(key.size());
+           }
+           do_not_optimize(sum);
+         }),
+         members);
+}
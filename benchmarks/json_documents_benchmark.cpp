@@ -0,0 +1,46 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <chrono>
+#include <string>
+#include <utility>
+
+#include "documents.hpp"
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr std::pair<JsonSourcerer::parse_mode, const char*> modes[] = {
+    {JsonSourcerer::parse_mode::sax, "sax"},
+    {JsonSourcerer::parse_mode::dom, "dom"},
+    {JsonSourcerer::parse_mode::simd, "simd"}};
+
+}  // namespace
+
+int main() {
+  for (const auto& [bytes, size] : document_sizes()) {
+    for (const auto kind : shapes) {
+      const auto document = generate_document(kind, bytes);
+      const auto mb = static_cast<double>(document.size()) / 1e6;
+      StringConjurer conjurer{document};
+      for (const auto& [mode, mode_name] : modes) {
+        const auto ns = measure(
+            [&] {
+              JsonSourcerer sourcerer{conjurer, nullptr, mode};
+              do_not_optimize(sourcerer.source());
+            },
+            std::chrono::milliseconds{200});
+        record(std::string{mode_name} + "/" + name_of(kind) + "/" + size, mb * 1e9 / ns, "MB/s");
+      }
+
+      JsonSourcerer sourcerer{conjurer};
+      const auto usage = sourcerer.source().memory_usage();
+      record(std::string{"memory/"} + name_of(kind) + "/" + size,
+             static_cast<double>(usage.total()) / static_cast<double>(document.size()),
+             "tree bytes/text byte");
+    }
+  }
+}
@@ -0,0 +1,72 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/detail/json_index.hpp>
+#include <sourcerer/detail/json_scanner.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <cstdint>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "documents.hpp"
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+const char* name_of(const detail::simd_level level) {
+  switch (level) {
+    case detail::simd_level::avx2:
+      return "avx2";
+    case detail::simd_level::sse42:
+      return "sse4.2";
+    default:
+      return "portable";
+  }
+}
+
+}  // namespace
+
+int main() {
+  const auto document = services_document(20000);
+  std::printf("%.1f MB document\n", static_cast<double>(document.size()) / 1e6);
+
+  const auto best = detail::detect_simd_level();
+  for (const auto level :
+       {detail::simd_level::portable, detail::simd_level::sse42, detail::simd_level::avx2}) {
+    if (level > best) continue;
+
+    std::vector<std::uint32_t> positions;
+    report_throughput(std::string{"scan/"} + name_of(level), measure([&] {
+                        detail::json_scanner scanner{document, level};
+                        while (scanner.next(positions)) {
+                          positions.clear();
+                        }
+                      }),
+                      document.size());
+    report_throughput(std::string{"index/"} + name_of(level), measure([&] {
+                        do_not_optimize(detail::json_index{document, level}.size());
+                      }),
+                      document.size());
+  }
+
+  // nlohmann's parser alone, without building anything.
+  report_throughput("nlohmann/parse", measure([&] {
+                      do_not_optimize(nlohmann::json::accept(document));
+                    }),
+                    document.size());
+
+  StringConjurer conjurer{document};
+  for (const auto& [name, mode] :
+       {std::pair{"JsonSourcerer/sax", JsonSourcerer::parse_mode::sax},
+        std::pair{"JsonSourcerer/simd", JsonSourcerer::parse_mode::simd}}) {
+    report_throughput(name, measure([&] {
+                        JsonSourcerer sourcerer{conjurer, nullptr, mode};
+                        do_not_optimize(sourcerer.source());
+                      }),
+                      document.size());
+  }
+}
@@ -0,0 +1,54 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <string>
+
+#include "documents.hpp"
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr JsonSourcerer::parse_mode modes[] = {JsonSourcerer::parse_mode::dom,
+                                               JsonSourcerer::parse_mode::sax};
+
+std::string name_of(const JsonSourcerer::parse_mode mode) {
+  return mode == JsonSourcerer::parse_mode::sax ? "sax" : "dom";
+}
+
+}  // namespace
+
+int main() {
+  const std::string documents[] = {services_document(10000), services_document(50000)};
+
+  // Memory is measured before anything is loaded in this process.
+  for (const auto& document : documents) {
+    const auto mb = static_cast<double>(document.size()) / 1e6;
+    for (const auto mode : modes) {
+      StringConjurer conjurer{document};
+      const auto grown = peak_rss_growth_kb([&] {
+        JsonSourcerer sourcerer{conjurer, nullptr, mode};
+        do_not_optimize(sourcerer.source());
+      });
+      record(name_of(mode) + "/peak rss/" + std::to_string(mb).substr(0, 4) + " MB",
+             static_cast<double>(grown), "KiB peak RSS growth");
+    }
+  }
+
+  for (const auto& document : documents) {
+    const auto mb = static_cast<double>(document.size()) / 1e6;
+    for (const auto mode : modes) {
+      StringConjurer conjurer{document};
+      const auto ns = measure(
+          [&] {
+            JsonSourcerer sourcerer{conjurer, nullptr, mode};
+            do_not_optimize(sourcerer.source());
+          },
+          std::chrono::milliseconds{500});
+      record(name_of(mode) + "/load/" + std::to_string(mb).substr(0, 4) + " MB", mb * 1e9 / ns,
+             "MB/s");
+    }
+  }
+}
@@ -0,0 +1,93 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/key_pool.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <cstdio>
+#include <memory_resource>
+#include <nlohmann/json.hpp>
+#include <string>
+
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+// A configuration of many services, which all use the same handful of keys.
+nlohmann::json make_document(const std::size_t services) {
+  auto document = nlohmann::json::object();
+  auto& list = document["services"] = nlohmann::json::array();
+  for (std::size_t i = 0; i < services; ++i) {
+    list.push_back({{"name", "service_" + std::to_string(i)},
+                    {"host", "10.0.0." + std::to_string(i % 256)},
+                    {"port", 8000 + i},
+                    {"timeout_ms", 250},
+                    {"retries", 3},
+                    {"enabled", i % 2 == 0},
+                    {"health_check_endpoint", "/healthz"},
+                    {"tls", {{"certificate_file", "cert.pem"}, {"verify_peer", true}}}});
+  }
+  return document;
+}
+
+struct KeyStats {
+  std::size_t occurrences = 0;
+  // The bytes the keys took when every object stored its own std::pmr::string copies.
+  std::size_t string_bytes = 0;
+};
+
+void count_keys(const nlohmann::json& json, KeyStats& stats) {
+  // The capacity of an empty string is the one of its small string buffer.
+  static const auto small_capacity = std::pmr::string{}.capacity();
+
+  if (json.is_object()) {
+    for (const auto& [key, value] : json.items()) {
+      ++stats.occurrences;
+      stats.string_bytes += sizeof(std::pmr::string);
+      if (key.size() > small_capacity) {
+        stats.string_bytes += key.size() + 1;
+      }
+      count_keys(value, stats);
+    }
+  } else if (json.is_array()) {
+    for (const auto& element : json) {
+      count_keys(element, stats);
+    }
+  }
+}
+
+}  // namespace
+
+int main() {
+  const auto document = make_document(10000);
+  KeyStats stats;
+  count_keys(document, stats);
+
+  StringConjurer conjurer{document.dump()};
+  JsonSourcerer sourcerer{conjurer};
+  const auto node = sourcerer.source();
+
+  const auto& services = node.at("services");
+  const auto keys = services.at(0).keys();
+  const auto interned_bytes = stats.occurrences * sizeof(Key) + keys->bytes();
+
+  std::printf("%zu key occurrences, %zu distinct keys\n", stats.occurrences, keys->size());
+  std::printf("keys as strings: %zu bytes, interned: %zu bytes, saved: %zu bytes\n",
+              stats.string_bytes, interned_bytes, stats.string_bytes - interned_bytes);
+
+  const auto timeout_ms = keys->intern("timeout_ms");
+  report("lookup/string_view", measure([&] {
+           for (const auto& service : services) {
+             do_not_optimize(service.at("timeout_ms"));
+           }
+         }),
+         services.size());
+
+  report("lookup/interned key", measure([&] {
+           for (const auto& service : services) {
+             do_not_optimize(service.at(timeout_ms));
+           }
+         }),
+         services.size());
+}
@@ -0,0 +1,119 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+#include <sourcerer/sourcerers/layered_sourcerer.hpp>
+
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr std::size_t services = 20000;
+// The services that are read, 1% of them.
+constexpr std::size_t accessed = services / 100;
+
+// The defaults of every service, keyed by name.
+std::string defaults_document() {
+  std::string text = R"({"services": {)";
+  for (std::size_t i = 0; i < services; ++i) {
+    if (i != 0) text += ',';
+    text += R"("service_)" + std::to_string(i) + R"(": {"port": )" +
+            std::to_string(8000 + i % 1000) +
+            R"(, "retries": 3, "tls": {"certificate_file": "/etc/ssl/cert.pem",)"
+            R"( "verify_peer": true}, "limits": {"connections": 100, "timeout_ms": 250}})";
+  }
+  text += "}}";
+  return text;
+}
+
+// A layer that overrides a few settings of every two hundredth service, so half of the services
+// that are read are merged from all layers and the rest come from the defaults only.
+std::string override_document(const std::size_t layer) {
+  std::string text = R"({"services": {)";
+  for (std::size_t i = 0; i < services; i += 200) {
+    if (i != 0) text += ',';
+    text += R"("service_)" + std::to_string(i) + R"(": {"tls": {"verify_peer": false}, "limits": )"
+            R"({"connections": )" +
+            std::to_string(layer) + "}}";
+  }
+  text += "}}";
+  return text;
+}
+
+class Fixed : public Sourcerer {
+ public:
+  explicit Fixed(const std::string& text) {
+    StringConjurer conjurer{text};
+    node_ = JsonSourcerer{conjurer}.source();
+  }
+
+  Node source() override { return node_; }
+
+ private:
+  Node node_;
+};
+
+// Reads a few values of every hundredth service.
+template <class N>
+void read_some(const N& root) {
+  const auto& list = root.at("services");
+  for (std::size_t i = 0; i < services; i += services / accessed) {
+    const auto& service = list.at("service_" + std::to_string(i));
+    do_not_optimize(service.at("port").template as<int>());
+    do_not_optimize(service.at("tls").at("verify_peer").template as<bool>());
+    do_not_optimize(service.at("limits").at("connections").template as<int>());
+  }
+}
+
+}  // namespace
+
+int main() {
+  std::vector<Fixed> layers;
+  layers.reserve(8);
+  layers.emplace_back(defaults_document());
+  for (std::size_t layer = 1; layer < 8; ++layer) {
+    layers.emplace_back(override_document(layer));
+  }
+  std::printf("%zu services, reading %zu of them\n", services, accessed);
+
+  for (const std::size_t count : {2, 4, 8}) {
+    const std::vector<std::reference_wrapper<Sourcerer>> stack(layers.begin(),
+                                                               layers.begin() + count);
+    const auto name = std::to_string(count) + " layers";
+
+    record("layered/" + name + ", read", static_cast<double>(peak_rss_growth_kb([&] {
+             LayeredSourcerer sourcerer{stack};
+             read_some(sourcerer.root());
+           })),
+           "KiB peak RSS growth");
+    record("deep merge/" + name + ", read", static_cast<double>(peak_rss_growth_kb([&] {
+             LayeredSourcerer sourcerer{stack};
+             read_some(sourcerer.source());
+           })),
+           "KiB peak RSS growth");
+
+    report("layered/" + name + ", first reads", measure([&] {
+             LayeredSourcerer sourcerer{stack};
+             read_some(sourcerer.root());
+           }),
+           accessed);
+    report("deep merge/" + name + ", merge", measure([&] {
+             LayeredSourcerer sourcerer{stack};
+             do_not_optimize(sourcerer.source());
+           }));
+
+    LayeredSourcerer sourcerer{stack};
+    const auto root = sourcerer.root();
+    const auto merged = sourcerer.source();
+    read_some(root);
+    report("layered/" + name + ", lookups", measure([&] { read_some(root); }), accessed);
+    report("deep merge/" + name + ", lookups", measure([&] { read_some(merged); }), accessed);
+    std::printf("%zu merged objects\n\n", sourcerer.merged());
+  }
+}
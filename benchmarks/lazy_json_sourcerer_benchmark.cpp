@@ -0,0 +1,78 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+#include <sourcerer/sourcerers/lazy_json_sourcerer.hpp>
+
+#include <cstdio>
+#include <string>
+
+#include "documents.hpp"
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr std::size_t services = 50000;
+// The services a process reads, 1% of them.
+constexpr std::size_t accessed = services / 100;
+
+// Reads a few values of every hundredth service.
+template <class N>
+void read_some(const N& root) {
+  const auto& list = root.at("services");
+  for (std::size_t i = 0; i < services; i += services / accessed) {
+    const auto& service = list.at(i);
+    do_not_optimize(service.at("port").template as<int>());
+    do_not_optimize(service.at("tls").at("verify_peer").template as<bool>());
+  }
+}
+
+}  // namespace
+
+int main() {
+  const auto document = services_document(services);
+  std::printf("%.1f MB document, reading %zu services\n",
+              static_cast<double>(document.size()) / 1e6, accessed);
+  StringConjurer conjurer{document};
+
+  // Memory is measured before anything is loaded in this process.
+  record("eager/load and read", static_cast<double>(peak_rss_growth_kb([&] {
+           JsonSourcerer sourcerer{conjurer};
+           read_some(sourcerer.source());
+         })),
+         "KiB peak RSS growth");
+  record("lazy/load and read", static_cast<double>(peak_rss_growth_kb([&] {
+           LazyJsonSourcerer sourcerer{conjurer};
+           read_some(sourcerer.root());
+         })),
+         "KiB peak RSS growth");
+
+  report("eager/load", measure([&] {
+           JsonSourcerer sourcerer{conjurer};
+           do_not_optimize(sourcerer.source());
+         }));
+  report("lazy/load", measure([&] {
+           LazyJsonSourcerer sourcerer{conjurer};
+           do_not_optimize(sourcerer.root());
+         }));
+
+  report("eager/load and read", measure([&] {
+           JsonSourcerer sourcerer{conjurer};
+           read_some(sourcerer.source());
+         }));
+  report("lazy/load and read", measure([&] {
+           LazyJsonSourcerer sourcerer{conjurer};
+           read_some(sourcerer.root());
+         }));
+
+  JsonSourcerer eager{conjurer};
+  LazyJsonSourcerer lazy{conjurer};
+  const auto tree = eager.source();
+  const auto root = lazy.root();
+  read_some(root);
+  report("eager/read", measure([&] { read_some(tree); }), accessed);
+  report("lazy/read, cached directories", measure([&] { read_some(root); }), accessed);
+  std::printf("lazy index: %zu bytes for %zu bytes of text\n", lazy.index_bytes() - document.size(),
+              document.size());
+}
@@ -0,0 +1,65 @@
+#include <sourcerer/conjurers/file_conjurer.hpp>
+#include <sourcerer/loader.hpp>
+
+#include <cstdio>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "documents.hpp"
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+// Loads the fragments one after the other, like a startup without a Loader does.
+void load_serially(std::deque<FileConjurer>& conjurers) {
+  for (auto& conjurer : conjurers) {
+    do_not_optimize(Loader::parse_json(conjurer));
+  }
+}
+
+}  // namespace
+
+int main() {
+  const auto directory = std::filesystem::temp_directory_path() / "sourcerer_loader_benchmark";
+  std::filesystem::create_directories(directory);
+
+  // Fragments of uneven size, from a few to a few hundred services.
+  constexpr std::size_t fragments = 64;
+  std::deque<FileConjurer> conjurers;
+  std::size_t bytes = 0;
+  for (std::size_t i = 0; i < fragments; ++i) {
+    const auto path = directory / ("fragment_" + std::to_string(i) + ".json");
+    const auto text = services_document(5 + (i * 37) % 300);
+    std::ofstream{path} << text;
+    bytes += text.size();
+    conjurers.emplace_back(path.string());
+  }
+  std::printf("%zu fragments, %.2f MB, %zu cores\n", fragments, static_cast<double>(bytes) / 1e6,
+              ThreadPool::default_size());
+
+  report("serial", measure([&] { load_serially(conjurers); }), fragments);
+
+  for (std::size_t threads = 1; threads <= 2 * ThreadPool::default_size(); threads *= 2) {
+    ThreadPool pool{threads};
+    Loader loader{pool};
+    for (auto& conjurer : conjurers) {
+      loader.add(conjurer);
+    }
+    report("loader/" + std::to_string(threads) + " threads",
+           measure([&] { do_not_optimize(loader.load()); }), fragments);
+  }
+
+  // With the pool it starts itself.
+  Loader loader;
+  for (auto& conjurer : conjurers) {
+    loader.add(conjurer);
+  }
+  report("loader/own pool", measure([&] { do_not_optimize(loader.load()); }), fragments);
+
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,142 @@
+#include <sourcerer/node.hpp>
+
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr std::size_t size = 1000;
+
+std::vector<std::string> make_keys() {
+  std::vector<std::string> keys;
+  for (std::size_t i = 0; i < size; ++i) keys.push_back("config_key_" + std::to_string(i));
+  return keys;
+}
+
+Node make_array() {
+  Node array{Node::array_t{}};
+  for (std::size_t i = 0; i < size; ++i) array.push_back(static_cast<int>(i));
+  return array;
+}
+
+Node make_object(const std::vector<std::string>& keys) {
+  Node object{Node::object_t{}};
+  for (std::size_t i = 0; i < size; ++i) object.insert(keys[i], static_cast<int>(i));
+  return object;
+}
+
+}  // namespace
+
+int main() {
+  const auto keys = make_keys();
+
+  report("construct/integer", measure([] {
+           for (std::size_t i = 0; i < size; ++i) do_not_optimize(Node{static_cast<int>(i)});
+         }),
+         size);
+  report("construct/double", measure([] {
+           for (std::size_t i = 0; i < size; ++i) do_not_optimize(Node{static_cast<double>(i)});
+         }),
+         size);
+  report("construct/inline string", measure([&] {
+           for (std::size_t i = 0; i < size; ++i) do_not_optimize(Node{keys[i]});
+         }),
+         size);
+  report("construct/long string", measure([&] {
+           for (std::size_t i = 0; i < size; ++i) do_not_optimize(Node{keys[i] + keys[i]});
+         }),
+         size);
+  report("construct/array", measure([] { do_not_optimize(make_array()); }), size);
+  report("construct/object", measure([&] { do_not_optimize(make_object(keys)); }), size);
+
+  const auto array = make_array();
+  const auto object = make_object(keys);
+
+  // Copies share the container until one of them is written to, which clones it.
+  report("copy/array", measure([&] { do_not_optimize(Node{array}); }));
+  report("copy/object", measure([&] { do_not_optimize(Node{object}); }));
+  report("copy and write/array", measure([&] {
+           Node copy{array};
+           copy.at(0) = 1;
+           do_not_optimize(copy);
+         }),
+         size);
+  report("copy and write/object", measure([&] {
+           Node copy{object};
+           copy.at(keys[0]) = 1;
+           do_not_optimize(copy);
+         }),
+         size);
+
+  report("lookup/index", measure([&] {
+           int sum = 0;
+           for (std::size_t i = 0; i < size; ++i) sum += array[i].as<int>();
+           do_not_optimize(sum);
+         }),
+         size);
+  report("lookup/key", measure([&] {
+           int sum = 0;
+           for (const auto& key : keys) sum += object[key].as<int>();
+           do_not_optimize(sum);
+         }),
+         size);
+  std::vector<Key> interned;
+  for (const auto& key : keys) interned.push_back(object.keys()->intern(key));
+  report("lookup/interned key", measure([&] {
+           int sum = 0;
+           for (const auto& key : interned) sum += object[key].as<int>();
+           do_not_optimize(sum);
+         }),
+         size);
+
+  report("iterate/array", measure([&] {
+           int sum = 0;
+           for (const auto& child : array) sum += child.as<int>();
+           do_not_optimize(sum);
+         }),
+         size);
+  report("iterate/object", measure([&] {
+           int sum = 0;
+           for (const auto& child : object) sum += child.as<int>();
+           do_not_optimize(sum);
+         }),
+         size);
+
+  std::vector<Node> integers;
+  std::vector<Node> numbers;
+  std::vector<Node> texts;
+  for (std::size_t i = 0; i < size; ++i) {
+    integers.emplace_back(static_cast<int>(i));
+    numbers.emplace_back(static_cast<double>(i) / 2);
+    texts.emplace_back(std::to_string(i));
+  }
+  report("as<int>/integer", measure([&] {
+           int sum = 0;
+           for (const auto& integer : integers) sum += integer.as<int>();
+           do_not_optimize(sum);
+         }),
+         size);
+  report("as<double>/double", measure([&] {
+           double sum = 0;
+           for (const auto& number : numbers) sum += number.as<double>();
+           do_not_optimize(sum);
+         }),
+         size);
+  report("as<int>/string", measure([&] {
+           int sum = 0;
+           for (const auto& text : texts) sum += text.as<int>();
+           do_not_optimize(sum);
+         }),
+         size);
+  report("as<std::string>/integer", measure([&] {
+           std::size_t length = 0;
+           for (const auto& integer : integers) length += integer.as<std::string>().size();
+           do_not_optimize(length);
+         }),
+         size);
+}
@@ -0,0 +1,96 @@
+#include <sourcerer/detail/parse_number.hpp>
+#include <sourcerer/node.hpp>
+
+#include <charconv>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr std::size_t count = 1000000;
+
+std::vector<std::string> decimals() {
+  std::mt19937_64 random{42};
+  std::vector<std::string> texts;
+  texts.reserve(count);
+  for (std::size_t i = 0; i < count; ++i) {
+    auto text = std::to_string(random() % 100000000);
+    text.insert(text.size() - random() % 4, ".");
+    if (text.front() == '.') text.insert(0, "0");
+    if (text.back() == '.') text.push_back('0');
+    texts.push_back(std::move(text));
+  }
+  return texts;
+}
+
+double sum(const Node& array) {
+  double total = 0;
+  for (const auto& element : array) total += element.as<double>();
+  return total;
+}
+
+double sum(const std::span<const double> numbers) {
+  double total = 0;
+  for (const auto number : numbers) total += number;
+  return total;
+}
+
+}  // namespace
+
+int main() {
+  const auto texts = decimals();
+  const std::vector<std::string_view> views(texts.begin(), texts.end());
+
+  // emplace_back() leaks the arrays, their copies cache packed numbers.
+  Node built;
+  for (std::size_t i = 0; i < count; ++i) built.emplace_back(static_cast<double>(i) / 8);
+  Node doubles = built;
+  built = Node{};
+  for (const auto& text : texts) built.emplace_back(text);
+  const Node strings = built;
+
+  report("array of doubles: as<double>() per element",
+         measure([&] { do_not_optimize(sum(doubles)); }), count);
+  report("array of doubles: as<vector<double>>()",
+         measure([&] { do_not_optimize(doubles.as<std::vector<double>>()); }), count);
+  report("array of doubles: numbers<double>(), first call", measure([&] {
+           // A write drops the packed numbers.
+           doubles.reserve(count);
+           do_not_optimize(sum(doubles.numbers<double>()));
+         }),
+         count);
+  report("array of doubles: numbers<double>(), cached",
+         measure([&] { do_not_optimize(sum(doubles.numbers<double>())); }), count);
+
+  report("array of strings: as<double>() per element",
+         measure([&] { do_not_optimize(sum(strings)); }), count);
+  report("array of strings: copy, numbers<double>()", measure([&] {
+           const Node copy = built;
+           do_not_optimize(sum(copy.numbers<double>()));
+         }),
+         count);
+  report("array of strings: numbers<double>(), cached",
+         measure([&] { do_not_optimize(sum(strings.numbers<double>())); }), count);
+
+  std::vector<double> values(count);
+  report("std::from_chars", measure([&] {
+           for (std::size_t i = 0; i < count; ++i) {
+             std::from_chars(views[i].data(), views[i].data() + views[i].size(), values[i]);
+           }
+           do_not_optimize(values);
+         }),
+         count);
+  report("detail::parse_numbers", measure([&] {
+           do_not_optimize(detail::parse_numbers(views, values));
+           do_not_optimize(values);
+         }),
+         count);
+}
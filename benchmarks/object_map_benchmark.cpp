@@ -0,0 +1,86 @@
+#include <sourcerer/detail/object_map.hpp>
+#include <sourcerer/node.hpp>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+std::vector<std::string> make_keys(const std::size_t size) {
+  std::vector<std::string> keys;
+  keys.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    keys.push_back("config_key_" + std::to_string(i));
+  }
+
+  std::ranges::shuffle(keys, std::mt19937{42});
+  return keys;
+}
+
+template <class Map>
+void run(std::string_view name, const std::vector<std::string>& keys) {
+  Map map;
+  for (const auto& key : keys) {
+    if constexpr (std::is_same_v<Map, Node::object_t>) {
+      map.try_emplace(key, Node{"value"});
+    } else {
+      map.try_emplace(typename Map::key_type{key}, Node{"value"});
+    }
+  }
+
+  const auto size = std::to_string(keys.size());
+
+  report(std::string{name} + "/lookup/" + size, measure([&] {
+           for (const auto& key : keys) {
+             do_not_optimize(map.find(std::string_view{key})->second);
+           }
+         }),
+         keys.size());
+
+  if constexpr (std::is_same_v<Map, Node::object_t>) {
+    std::vector<Key> interned;
+    for (const auto& key : keys) {
+      interned.push_back(map.keys()->intern(key));
+    }
+
+    report(std::string{name} + "/lookup interned/" + size, measure([&] {
+             for (const auto& key : interned) {
+               do_not_optimize(map.find(key)->second);
+             }
+           }),
+           keys.size());
+  }
+
+  report(std::string{name} + "/miss/" + size, measure([&] {
+           for (const auto& key : keys) {
+             do_not_optimize(map.find(std::string_view{key}.substr(1)) == map.end());
+           }
+         }),
+         keys.size());
+
+  report(std::string{name} + "/iterate/" + size, measure([&] {
+           for (const auto& [key, value] : map) {
+             do_not_optimize(value);
+           }
+         }),
+         keys.size());
+}
+
+}  // namespace
+
+int main() {
+  for (const std::size_t size : {4, 16, 64, 1024, 65536}) {
+    const auto keys = make_keys(size);
+    run<std::pmr::map<std::pmr::string, Node, std::less<>>>("std::map", keys);
+    run<Node::object_t>("object_map", keys);
+  }
+}
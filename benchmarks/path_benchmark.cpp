@@ -0,0 +1,90 @@
+#include <sourcerer/node.hpp>
+#include <sourcerer/path.hpp>
+
+#include <string>
+#include <vector>
+
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr int servers = 16;
+
+Node make_tree() {
+  Node root;
+  for (int i = 0; i < servers; ++i) {
+    Node server;
+    server["name"] = "server" + std::to_string(i);
+    server["port"] = 8000 + i;
+    server["tls"]["cert"] = "/etc/tls/cert" + std::to_string(i);
+    server["tls"]["key"] = "/etc/tls/key" + std::to_string(i);
+    server["tls"]["ciphers"] = "HIGH:!aNULL";
+    root["servers"].push_back(std::move(server));
+  }
+  return root;
+}
+
+}  // namespace
+
+int main() {
+  const auto tree = make_tree();
+  const auto& root = tree;
+
+  // Every server's tls settings, as a plugin would ask for them.
+  std::vector<std::string> texts;
+  for (int i = 0; i < servers; ++i) {
+    for (const auto* leaf : {"cert", "key", "ciphers"}) {
+      texts.push_back("servers[" + std::to_string(i) + "].tls." + leaf);
+    }
+  }
+
+  report("chained at()", measure([&] {
+           for (int i = 0; i < servers; ++i) {
+             for (const auto* leaf : {"cert", "key", "ciphers"}) {
+               do_not_optimize(root.at(std::string{"servers"})
+                                   .at(static_cast<std::size_t>(i))
+                                   .at(std::string{"tls"})
+                                   .at(std::string{leaf}));
+             }
+           }
+         }),
+         texts.size());
+
+  report("parse and find", measure([&] {
+           for (const auto& text : texts) {
+             do_not_optimize(Path{text}.find(root));
+           }
+         }),
+         texts.size());
+
+  std::vector<Path> paths;
+  for (const auto& text : texts) {
+    paths.emplace_back(text);
+  }
+  report("compiled find", measure([&] {
+           for (const auto& path : paths) {
+             do_not_optimize(path.find(root));
+           }
+         }),
+         texts.size());
+
+  PathSet set;
+  for (const auto& path : paths) {
+    set.add(path);
+  }
+  std::vector<const Node*> results(set.size());
+  report("path set resolve", measure([&] {
+           set.resolve(root, results);
+           do_not_optimize(results.front());
+         }),
+         texts.size());
+
+  const Path wildcard{"servers[*].tls.cert"};
+  report("wildcard for_each", measure([&] {
+           wildcard.for_each(root, [](const Node& node) { do_not_optimize(node); });
+         }),
+         servers);
+}
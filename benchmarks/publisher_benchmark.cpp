@@ -0,0 +1,123 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/publisher.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "documents.hpp"
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr std::size_t services = 1000;
+constexpr auto duration = std::chrono::milliseconds{200};
+// How often the writer publishes a new version.
+constexpr auto reload_interval = std::chrono::milliseconds{1};
+
+Node parse(std::string text) {
+  StringConjurer conjurer{std::move(text)};
+  return JsonSourcerer{conjurer}.source();
+}
+
+// What a request reads.
+int read_request(const Node& root, const std::size_t request) {
+  const auto& service = root.at("services").at(request % services);
+  return service.at("port").as<int>() + service.at("tls").at("verify_peer").as<bool>();
+}
+
+// The tree behind a mutex, how it was done before.
+class Locked {
+ public:
+  explicit Locked(Node root) : root_{std::move(root)} {}
+
+  int read(const std::size_t request) {
+    std::scoped_lock lock{mutex_};
+    return read_request(root_, request);
+  }
+
+  void publish(Node root) {
+    std::scoped_lock lock{mutex_};
+    root_.swap(root);
+  }
+
+ private:
+  std::mutex mutex_;
+  Node root_;
+};
+
+// Runs threads readers that read for duration while a writer publishes versions, and returns the
+// reads per second of all of them.
+template <class Read, class Publish>
+double run(const std::size_t threads, Read&& make_reader, Publish&& publish) {
+  std::atomic<bool> stop{false};
+  std::atomic<std::size_t> reads{0};
+
+  std::vector<std::thread> readers;
+  for (std::size_t i = 0; i < threads; ++i) {
+    readers.emplace_back([&, i] {
+      auto read = make_reader();
+      std::size_t count = 0;
+      for (auto request = i * 7919; !stop.load(std::memory_order_relaxed); ++request) {
+        do_not_optimize(read(request));
+        ++count;
+      }
+      reads += count;
+    });
+  }
+
+  const auto start = std::chrono::steady_clock::now();
+  for (std::size_t version = 0; std::chrono::steady_clock::now() - start < duration; ++version) {
+    publish(version);
+    std::this_thread::sleep_for(reload_interval);
+  }
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+  const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+  return static_cast<double>(reads) / elapsed.count();
+}
+
+void print(const std::string& name, const std::size_t threads, const double reads_per_second) {
+  record(name + "/" + std::to_string(threads) + " threads", reads_per_second / 1e6, "Mreads/s");
+}
+
+}  // namespace
+
+int main() {
+  const Node versions[] = {parse(services_document(services)), parse(services_document(services))};
+  std::printf("%zu services, a new version every %lld ms, %u cores\n", services,
+              static_cast<long long>(reload_interval.count()), std::thread::hardware_concurrency());
+
+  for (const std::size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+    Locked locked{versions[0]};
+    const auto locked_reader = [&] {
+      return [&](const std::size_t request) { return locked.read(request); };
+    };
+    const auto locked_publish = [&](const std::size_t version) {
+      locked.publish(versions[version % 2]);
+    };
+    print("mutex", threads, run(threads, locked_reader, locked_publish));
+
+    Publisher publisher{versions[0]};
+    const auto publisher_reader = [&] {
+      return [reader = publisher.reader()](const std::size_t request) mutable {
+        return read_request(*reader.read(), request);
+      };
+    };
+    const auto publisher_publish = [&](const std::size_t version) {
+      publisher.publish(versions[version % 2]);
+    };
+    print("publisher", threads, run(threads, publisher_reader, publisher_publish));
+  }
+}
@@ -0,0 +1,76 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+#include <sourcerer/sourcerers/reloading_sourcerer.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "documents.hpp"
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+constexpr std::size_t services = 1000;
+
+Node parse(std::string text) {
+  StringConjurer conjurer{std::move(text)};
+  return JsonSourcerer{conjurer}.source();
+}
+
+// The document with the port of every step-th service changed.
+std::string changed_document(const std::size_t step) {
+  auto text = services_document(services);
+  std::size_t position = 0;
+  for (std::size_t i = 0; i < services; ++i) {
+    position = text.find("\"port\": ", position) + 8;
+    if (i % step == 0) text[position] = '9';
+  }
+  return text;
+}
+
+// Patches a file that alternates between the document and a changed one, which the parser hands
+// out already parsed so only the patching is measured.
+void patch(const std::filesystem::path& file, const std::string& name, const std::size_t step) {
+  const Node variants[] = {parse(services_document(services)), parse(changed_document(step))};
+  std::size_t next = 0;
+  ReloadingSourcerer sourcerer{file, [&](Conjurer&) { return variants[next++ % 2]; }};
+
+  std::size_t changed = 0;
+  report("patch/" + name, measure([&] { changed = sourcerer.reload(0).changed.size(); }));
+  std::printf("%zu paths changed\n", changed);
+}
+
+}  // namespace
+
+int main() {
+  const auto directory = std::filesystem::temp_directory_path() / "sourcerer_reloading_benchmark";
+  std::filesystem::create_directories(directory);
+
+  constexpr std::size_t fragments = 16;
+  std::vector<std::pair<std::string, std::filesystem::path>> files;
+  for (std::size_t i = 0; i < fragments; ++i) {
+    const auto name = "fragment_" + std::to_string(i);
+    files.emplace_back(name, directory / (name + ".json"));
+    std::ofstream{files.back().second} << services_document(services);
+  }
+  std::printf("%zu files of %zu services\n", fragments, services);
+
+  report("load/all files", measure([&] { ReloadingSourcerer sourcerer{files}; }));
+
+  ReloadingSourcerer sourcerer{files};
+  report("reload/all files, unchanged", measure([&] { do_not_optimize(sourcerer.reload()); }));
+  report("reload/one file, unchanged", measure([&] { do_not_optimize(sourcerer.reload(0)); }));
+
+  patch(files.front().second, "one value of one file", services + 1);
+  patch(files.front().second, "1% of one file", 100);
+  patch(files.front().second, "every service of one file", 1);
+
+  std::filesystem::remove_all(directory);
+}
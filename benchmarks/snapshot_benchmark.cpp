@@ -0,0 +1,73 @@
+#include <sourcerer/conjurers/file_conjurer.hpp>
+#include <sourcerer/snapshot.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include "documents.hpp"
+#include "harness.hpp"
+
+using namespace sourcerer;
+using namespace sourcerer::benchmarks;
+
+namespace {
+
+// Reads a few values of every hundredth service.
+template <class N>
+void read_some(const N& root) {
+  const auto list = root.at("services");
+  for (std::size_t i = 0; i < list.size(); i += 100) {
+    const auto service = list.at(i);
+    do_not_optimize(service.at("port").template as<int>());
+    do_not_optimize(service.at("tls").at("verify_peer").template as<bool>());
+  }
+}
+
+void run(const std::filesystem::path& directory, const std::size_t services) {
+  const auto source = directory / ("services_" + std::to_string(services) + ".json");
+  std::ofstream{source} << services_document(services);
+  FileConjurer conjurer{source.string()};
+  const auto text = conjurer.conjure();
+  std::printf("%.2f MB document\n", static_cast<double>(text.size()) / 1e6);
+
+  report("parse/JsonSourcerer", measure([&] {
+           JsonSourcerer sourcerer{conjurer};
+           do_not_optimize(sourcerer.source());
+         }));
+
+  JsonSourcerer sourcerer{conjurer};
+  const auto tree = sourcerer.source();
+  report("snapshot/encode", measure([&] { do_not_optimize(Snapshot::encode(tree)); }));
+
+  const auto file = directory / "tree.snapshot";
+  Snapshot::write(tree, file);
+  report("snapshot/open", measure([&] { do_not_optimize(Snapshot::open(file)); }));
+  report("snapshot/content hash", measure([&] { do_not_optimize(detail::content_hash(text)); }));
+
+  SnapshotCache cache{directory / "cache"};
+  cache.load(conjurer);
+  report("cache/load, in memory", measure([&] { do_not_optimize(cache.load(conjurer)); }));
+  report("cache/load, from the directory", measure([&] {
+           SnapshotCache fresh{directory / "cache"};
+           do_not_optimize(fresh.load(conjurer));
+         }));
+
+  const auto snapshot = cache.load(conjurer);
+  report("read/Node", measure([&] { read_some(tree); }), services / 100);
+  report("read/Snapshot", measure([&] { read_some(snapshot.root()); }), services / 100);
+  std::printf("snapshot: %zu bytes\n\n", snapshot.bytes());
+}
+
+}  // namespace
+
+int main() {
+  const auto directory = std::filesystem::temp_directory_path() / "sourcerer_snapshot_benchmark";
+  std::filesystem::create_directories(directory);
+  for (const auto services : {100, 10000}) {
+    run(directory, services);
+  }
+  std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,290 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/node.hpp"
+
+namespace sourcerer {
+
+/**
+ * @brief Describes how the struct T is bound to an object, specialize it for every struct.
+ *
+ * A specialization has a static constexpr member fields, a field_list of the keys and the members
+ * they are bound to:
+ *
+ *   template <>
+ *   struct sourcerer::binding<Database> {
+ *     static constexpr field_list fields{field("host", &Database::host),
+ *                                        field("port", &Database::port),
+ *                                        field("pool_size", &Database::pool_size, if_present)};
+ *   };
+ */
+template <class T>
+struct binding;
+
+// Marks a field that keeps the value it was initialized with if its key is missing or null.
+struct if_present_t {
+  explicit if_present_t() = default;
+};
+inline constexpr if_present_t if_present{};
+
+// A key of an object and the member of T it's bound to.
+template <class T, class M>
+struct Field {
+  std::string_view name;
+  M T::*member;
+  // Whether a missing key is an error. Fields of type std::optional never are, they're reset.
+  bool required;
+};
+
+template <class T, class M>
+constexpr Field<T, M> field(const std::string_view name, M T::*member) {
+  return {name, member, true};
+}
+
+template <class T, class M>
+constexpr Field<T, M> field(const std::string_view name, M T::*member, if_present_t /*unused*/) {
+  return {name, member, false};
+}
+
+/**
+ * @brief The fields of a struct, and the plan to look them up in an object.
+ *
+ * The plan is built at compile time: the fields are ordered by their keys, the order the entries
+ * of an object are stored in. So binding an object is a single pass over its entries alongside the
+ * fields. Keys can only be bound once, a key used twice doesn't compile.
+ */
+template <class... Fields>
+struct field_list {
+  static constexpr std::size_t size = sizeof...(Fields);
+
+  constexpr explicit field_list(Fields... fields) : fields{fields...}, names{fields.name...} {
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::ranges::sort(order, std::less<>{}, [&](const std::size_t field) { return names[field]; });
+    for (std::size_t i = 1; i < size; ++i) {
+      if (names[order[i - 1]] == names[order[i]]) {
+        SOURCERER_THROW(std::invalid_argument("A key is bound to two fields"));
+      }
+    }
+  }
+
+  std::tuple<Fields...> fields;
+  std::array<std::string_view, size> names;
+  // The positions of the fields, ordered by their names.
+  std::array<std::size_t, size> order{};
+};
+
+// Why a value couldn't be bound.
+struct BindError {
+  // The path of the value, see Path.
+  std::string path;
+  std::string message;
+};
+
+// Thrown by bind() with every value that couldn't be bound.
+class SOURCERER_API BindErrors : public std::invalid_argument {
+ public:
+  explicit BindErrors(std::vector<BindError> errors);
+
+  const std::vector<BindError>& errors() const noexcept { return errors_; }
+
+ private:
+  std::vector<BindError> errors_;
+};
+
+namespace detail {
+
+template <class T>
+inline constexpr bool is_optional = false;
+template <class T>
+inline constexpr bool is_optional<std::optional<T>> = true;
+
+template <class T>
+concept bound_struct = requires { binding<T>::fields; };
+
+template <class T>
+concept bound_sequence = requires(T sequence) {
+  typename T::value_type;
+  sequence.push_back(std::declval<typename T::value_type>());
+  sequence.reserve(std::size_t{0});
+} && !std::constructible_from<T, std::string_view>;
+
+template <class T>
+concept bound_map = requires(T map) {
+  typename T::key_type;
+  typename T::mapped_type;
+  map.try_emplace(std::declval<typename T::key_type>());
+} && std::constructible_from<typename T::key_type, std::string_view>;
+
+}  // namespace detail
+
+// Walks a tree alongside the value it's bound to.
+class Binder {
+ public:
+  explicit Binder(std::vector<BindError>& errors) : errors_{errors} {}
+
+  template <class T>
+  void bind(const Node& node, T& value) {
+    bind(node, value, nullptr);
+  }
+
+ private:
+  // A step of the path to the current node, only turned into text for errors.
+  struct Step {
+    static constexpr std::size_t key = -1;
+
+    const Step* parent;
+    std::string_view name;
+    // The index of an element, or key for the value of a key.
+    std::size_t index;
+  };
+
+  template <class T>
+  void bind(const Node& node, T& value, const Step* step) {
+    if constexpr (std::same_as<T, Node>) {
+      value = node;
+    } else if constexpr (detail::is_optional<T>) {
+      if (node.is_null()) {
+        value.reset();
+      } else {
+        bind(node, value.emplace(), step);
+      }
+    } else if constexpr (detail::bound_struct<T>) {
+      if (expect(node, detail::node_kind::object, step)) {
+        bind_fields(node.get<Node::object_t>(), value, step,
+                    std::make_index_sequence<binding<T>::fields.size>{});
+      }
+    } else if constexpr (detail::bound_map<T>) {
+      if (expect(node, detail::node_kind::object, step)) {
+        value.clear();
+        for (const auto& [key, child] : node.get<Node::object_t>()) {
+          const Step next{step, key.view(), Step::key};
+          bind(child, value.try_emplace(typename T::key_type{key.view()}).first->second, &next);
+        }
+      }
+    } else if constexpr (detail::bound_sequence<T>) {
+      if (expect(node, detail::node_kind::array, step)) {
+        const auto& array = node.get<Node::array_t>();
+        value.clear();
+        value.reserve(array.size());
+        for (std::size_t i = 0; i < array.size(); ++i) {
+          const Step next{step, {}, i};
+          bind(array[i], value.emplace_back(), &next);
+        }
+      }
+    } else {
+      bind_value(node, value, step);
+    }
+  }
+
+  template <class T>
+  void bind_value(const Node& node, T& value, const Step* step) {
+    if (!node.is_value()) {
+      fail(step, "Expected " + detail::type_name<T>() + ", got " + detail::type_name(node.kind_));
+      return;
+    }
+    if (auto converted = node.try_as<T>()) {
+      value = *std::move(converted);
+    } else {
+      fail(step, converted.error().message());
+    }
+  }
+
+  template <class T, std::size_t... I>
+  void bind_fields(const Node::object_t& object, T& value, const Step* step,
+                   std::index_sequence<I...> /*unused*/) {
+    static constexpr const auto& list = binding<T>::fields;
+    using binder = void (*)(Binder&, const Node*, T&, const Step*);
+    static constexpr std::array<binder, sizeof...(I)> binders{
+        +[](Binder& self, const Node* child, T& value, const Step* step) {
+          self.bind_field(std::get<I>(list.fields), child, value, step);
+        }...};
+
+    if (object.order() == Node::key_order::sorted) {
+      // Both are ordered by key, so every entry is compared at most once.
+      auto it = object.begin();
+      for (const auto field : list.order) {
+        const auto name = list.names[field];
+        while (it != object.end() && it->first.view() < name) {
+          ++it;
+        }
+        const auto found = it != object.end() && it->first.view() == name;
+        binders[field](*this, found ? &it->second : nullptr, value, step);
+      }
+    } else {
+      // The hashes of the keys are computed on first use.
+      static const std::array<std::uint32_t, sizeof...(I)> hashes{Key::hash(list.names[I])...};
+      for (std::size_t field = 0; field < list.size; ++field) {
+        const auto it = object.find(list.names[field], hashes[field]);
+        binders[field](*this, it != object.end() ? &it->second : nullptr, value, step);
+      }
+    }
+  }
+
+  template <class T, class M>
+  void bind_field(const Field<T, M>& field, const Node* child, T& value, const Step* step) {
+    auto& member = value.*field.member;
+    const Step next{step, field.name, Step::key};
+    if (child == nullptr || (child->is_null() && !field.required)) {
+      if constexpr (detail::is_optional<M>) {
+        member.reset();
+      } else if (field.required) {
+        fail(&next, "Missing");
+      }
+      return;
+    }
+
+    bind(*child, member, &next);
+  }
+
+  // Fails unless node is of kind.
+  SOURCERER_API bool expect(const Node& node, detail::node_kind kind, const Step* step);
+  SOURCERER_API void fail(const Step* step, std::string message);
+
+  std::vector<BindError>& errors_;
+};
+
+/**
+ * @brief Binds node to value, and returns the errors of the values that couldn't be bound.
+ *
+ * Structs with a binding are bound to objects, std::optional to a value or null, containers like
+ * std::vector to arrays and maps with string keys like std::map to objects. Node is copied and
+ * anything else is read with Node::as(). Keys without a field are ignored.
+ *
+ * Binding doesn't stop at the first error, value holds everything that could be bound.
+ */
+template <class T>
+std::vector<BindError> bind(const Node& node, T& value) {
+  std::vector<BindError> errors;
+  Binder{errors}.bind(node, value);
+  return errors;
+}
+
+// Binds node to a new T, throws BindErrors with all errors if any value couldn't be bound.
+template <class T>
+  requires std::default_initializable<T>
+T bind(const Node& node) {
+  T value{};
+  if (auto errors = bind(node, value); !errors.empty()) {
+    SOURCERER_THROW(BindErrors{std::move(errors)});
+  }
+  return value;
+}
+
+}  // namespace sourcerer
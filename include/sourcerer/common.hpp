@@ -13,3 +13,32 @@
 #define SOURCERER_API
 #endif
 #endif
+
+// Builds without exceptions (-fno-exceptions, cpp_eh=none in Meson) print what would have been
+// thrown and abort. The non-throwing API reports every error a caller can recover from instead.
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define SOURCERER_EXCEPTIONS 1
+#define SOURCERER_THROW(...) throw __VA_ARGS__
+#define SOURCERER_TRY try
+#define SOURCERER_CATCH(...) catch (__VA_ARGS__)
+#define SOURCERER_RETHROW throw
+#else
+#include <cstdio>
+#include <cstdlib>
+
+#define SOURCERER_EXCEPTIONS 0
+#define SOURCERER_THROW(...) ::sourcerer::detail::abort_with(__VA_ARGS__)
+#define SOURCERER_TRY if (true)
+#define SOURCERER_CATCH(...) if (false)
+#define SOURCERER_RETHROW std::abort()
+
+namespace sourcerer::detail {
+
+template <class Exception>
+[[noreturn]] void abort_with(const Exception& exception) noexcept {
+  std::fprintf(stderr, "sourcerer: %s\n", exception.what());
+  std::abort();
+}
+
+}  // namespace sourcerer::detail
+#endif
@@ -5,6 +5,7 @@
 #include <sstream>
 #include <string>
 
+#include "sourcerer/common.hpp"
 #include "sourcerer/conjurers/conjurer.hpp"
 
 namespace sourcerer {
@@ -15,10 +16,10 @@ class FileConjurer : public Conjurer {
 
   inline std::string conjure() override {
     if (!std::filesystem::exists(path_)) {
-      throw std::runtime_error("File does not exist: " + std::string{path_});
+      SOURCERER_THROW(std::runtime_error("File does not exist: " + std::string{path_}));
     }
     if (!std::filesystem::is_regular_file(path_)) {
-      throw std::runtime_error("Path is not a file: " + std::string{path_});
+      SOURCERER_THROW(std::runtime_error("Path is not a file: " + std::string{path_}));
     }
 
     std::ifstream file{path_};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory_resource>
+
+#include "sourcerer/common.hpp"
+
+namespace sourcerer {
+
+// What a CountingResource counted.
+struct AllocationStats {
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+  // The bytes allocated and not deallocated yet, and the most there were at once.
+  std::size_t bytes = 0;
+  std::size_t peak_bytes = 0;
+  // The bytes of all allocations.
+  std::size_t total_bytes = 0;
+};
+
+/**
+ * @brief A memory resource that counts the allocations it passes on to upstream.
+ *
+ * Building a tree into one instruments it, like a JsonSourcerer loading into it:
+ *
+ *     CountingResource counting;
+ *     JsonSourcerer sourcerer{conjurer, &counting};
+ *     const auto stats = counting.stats();
+ *
+ * Only what goes through the resource is counted: the nodes, strings and containers of the tree,
+ * but not its key pool, the conjured text or the parser's own allocations. Counting is thread
+ * safe, so the resource may be shared by loads on several threads, which are counted together.
+ * Like any resource not known to outlive its nodes, copies of its trees into other resources are
+ * deep.
+ */
+class SOURCERER_API CountingResource : public std::pmr::memory_resource {
+ public:
+  explicit CountingResource(
+      std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) noexcept
+      : upstream_{upstream} {}
+
+  CountingResource(const CountingResource&) = delete;
+  CountingResource& operator=(const CountingResource&) = delete;
+
+  std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+
+  AllocationStats stats() const noexcept;
+  // Starts counting anew from the bytes currently allocated, to count the next load on its own.
+  void reset() noexcept;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+  std::pmr::memory_resource* upstream_;
+  std::atomic<std::size_t> allocations_{0};
+  std::atomic<std::size_t> deallocations_{0};
+  std::atomic<std::size_t> bytes_{0};
+  std::atomic<std::size_t> peak_bytes_{0};
+  std::atomic<std::size_t> total_bytes_{0};
+};
+
+}  // namespace sourcerer
@@ -4,6 +4,7 @@
 #include <iterator>
 #include <type_traits>
 #include <variant>
+#include <vector>
 
 #include "sourcerer/detail/node_forwards.hpp"
 
@@ -13,11 +14,13 @@ template <class T>
 concept number = std::is_arithmetic_v<T> && !std::same_as<T, bool>;
 
 template <class T>
-concept child = std::same_as<T, null_t> || std::same_as<T, value_t> || std::same_as<T, array_t> ||
-                std::same_as<T, object_t>;
+inline constexpr bool is_vector = false;
+template <class T, class Allocator>
+inline constexpr bool is_vector<std::vector<T, Allocator>> = true;
 
 template <class T>
-concept child_variant = std::same_as<T, std::variant<null_t, value_t, array_t, object_t>>;
+concept child = std::same_as<T, null_t> || std::same_as<T, value_t> || std::same_as<T, array_t> ||
+                std::same_as<T, object_t>;
 
 template <class T>
 concept basic_node =
@@ -31,7 +34,6 @@ concept basic_node =
       requires std::same_as<typename T::const_pointer, const T*>;
       requires std::same_as<typename T::reference, std::remove_const_t<T>&>;
       requires std::same_as<typename T::const_reference, const T&>;
-    } && std::bidirectional_iterator<typename T::array_t::iterator> &&
-    std::bidirectional_iterator<typename T::object_t::iterator>;
+    };
 
 }  // namespace sourcerer::detail
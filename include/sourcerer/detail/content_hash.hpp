@@ -0,0 +1,13 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "sourcerer/common.hpp"
+
+namespace sourcerer::detail {
+
+// A 64 bit hash of text, after XXH64. Fast enough to hash a whole file on every load.
+SOURCERER_API std::uint64_t content_hash(std::string_view text) noexcept;
+
+}  // namespace sourcerer::detail
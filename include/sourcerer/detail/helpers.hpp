@@ -1,27 +1,34 @@
 #pragma once
 
 #include <iomanip>
+#include <stdexcept>
 
+#include "sourcerer/common.hpp"
 #include "sourcerer/detail/concepts.hpp"
 #include "sourcerer/detail/node_forwards.hpp"
 #include "sourcerer/detail/type_name.hpp"
 
 namespace sourcerer::detail {
 
+// The kind tag a Node holding a T carries.
 template <child T>
-T& try_get(children_t& variant) {
-  if (!std::holds_alternative<T>(variant)) {
-    throw std::invalid_argument("Node is not of the requested type: " + type_name(variant));
+inline constexpr node_kind kind_of = [] {
+  if constexpr (std::is_same_v<T, null_t>) {
+    return node_kind::null;
+  } else if constexpr (std::is_same_v<T, value_t>) {
+    return node_kind::string;
+  } else if constexpr (std::is_same_v<T, array_t>) {
+    return node_kind::array;
+  } else {
+    return node_kind::object;
   }
-  return std::get<T>(variant);
-}
+}();
 
-template <child T>
-const T& try_get(const children_t& variant) {
-  if (!std::holds_alternative<T>(variant)) {
-    throw std::invalid_argument("Node is not of the requested type: " + type_name(variant));
+inline void throw_if_not(const node_kind expected, const node_kind actual) {
+  if (expected != actual) {
+    SOURCERER_THROW(
+        std::invalid_argument("Node is not of the requested type: " + type_name(actual)));
   }
-  return std::get<T>(variant);
 }
 
 }  // namespace sourcerer::detail
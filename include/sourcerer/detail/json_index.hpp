@@ -0,0 +1,105 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/detail/json_scanner.hpp"
+#include "sourcerer/detail/node_forwards.hpp"
+
+namespace sourcerer {
+
+class NodeBuilder;
+
+namespace detail {
+
+// One token of an indexed JSON text.
+struct json_token {
+  // The offset of the first character of the token: a bracket, a quote or the start of a literal.
+  std::uint32_t offset;
+  // For containers the position of the token after their last child. For strings the length of
+  // their contents, with json_index::escaped set if they contain escapes. For numbers and literals
+  // their length.
+  std::uint32_t extent;
+};
+
+/**
+ * @brief The structural index of a JSON text: all of its tokens in document order.
+ *
+ * Building the index validates the text in one pass and records eight bytes per value and key
+ * instead of parsing anything. A json_scanner finds the structural characters with SIMD
+ * instructions, and only those, plus the characters of numbers, literals and escapes, are looked
+ * at one by one. The children of a container follow it on the tape, in an object each value after
+ * its key, and every container knows where it ends, so whole subtrees are skipped in O(1). Strings
+ * and numbers are only decoded when asked for.
+ *
+ * The index refers to the text, which has to outlive it. Texts of up to 2 GiB can be indexed.
+ */
+class SOURCERER_API json_index {
+ public:
+  using number_t = std::variant<std::int64_t, std::uint64_t, double>;
+
+  // Marks the extent of a string with escapes.
+  static constexpr std::uint32_t escaped = 1U << 31;
+
+  // Throws std::invalid_argument if text isn't valid JSON, std::length_error if it is too large.
+  explicit json_index(std::string_view text, simd_level level = detect_simd_level());
+
+  std::string_view text() const noexcept { return text_; }
+
+  // The number of tokens, the root is the first one.
+  std::uint32_t size() const noexcept { return static_cast<std::uint32_t>(tape_.size()); }
+  const json_token& operator[](const std::uint32_t pos) const noexcept { return tape_[pos]; }
+
+  // The kind of the value at pos. Numbers are parsed to tell integers from floating point ones.
+  node_kind kind(std::uint32_t pos) const;
+
+  bool is_object(const std::uint32_t pos) const noexcept { return first_char(pos) == '{'; }
+  bool is_array(const std::uint32_t pos) const noexcept { return first_char(pos) == '['; }
+  bool is_number(const std::uint32_t pos) const noexcept {
+    const auto c = first_char(pos);
+    return c == '-' || (c >= '0' && c <= '9');
+  }
+
+  // The position of the token after the value at pos and all of its children.
+  std::uint32_t skip(const std::uint32_t pos) const noexcept {
+    return is_object(pos) || is_array(pos) ? tape_[pos].extent : pos + 1;
+  }
+
+  // The contents of the string at pos as they appear in the text, with their escapes.
+  std::string_view raw_string(const std::uint32_t pos) const noexcept {
+    return text_.substr(tape_[pos].offset + 1, tape_[pos].extent & ~escaped);
+  }
+  bool is_escaped(const std::uint32_t pos) const noexcept {
+    return (tape_[pos].extent & escaped) != 0;
+  }
+  // The contents of the string at pos with their escapes resolved.
+  std::string string(std::uint32_t pos) const;
+
+  bool boolean(const std::uint32_t pos) const noexcept { return first_char(pos) == 't'; }
+  number_t number(std::uint32_t pos) const;
+
+  // Adds the value at pos and all of its children to builder.
+  void build(NodeBuilder& builder, std::uint32_t pos = 0) const;
+
+  // The bytes taken by the tape.
+  std::size_t bytes() const noexcept { return tape_.capacity() * sizeof(json_token); }
+
+  // Appends raw with its escapes resolved to out. raw must be a string of a json_index, whose
+  // escapes are validated.
+  static void unescape(std::string_view raw, std::string& out);
+
+ private:
+  char first_char(const std::uint32_t pos) const noexcept { return text_[tape_[pos].offset]; }
+
+  std::string_view text_;
+  std::vector<json_token> tape_;
+};
+
+}  // namespace detail
+
+}  // namespace sourcerer
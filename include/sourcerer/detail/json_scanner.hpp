@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+
+namespace sourcerer::detail {
+
+// The instruction sets a json_scanner can use, each one a superset of the ones before it.
+enum class simd_level : std::uint8_t { portable, sse42, avx2 };
+
+// The best level the CPU supports, portable on anything but x86-64.
+SOURCERER_API simd_level detect_simd_level() noexcept;
+
+// What a json_scanner carries from one block to the next.
+struct json_scan_state {
+  // All bits set if the block ends inside a string, respectively in the middle of a scalar.
+  std::uint64_t in_string = 0;
+  std::uint64_t in_scalar = 0;
+  // 1 if the first character of the next block is escaped.
+  std::uint64_t escaped = 0;
+
+  // The continuation bytes the current UTF-8 sequence still needs, and the range of the next one.
+  std::uint8_t utf8_pending = 0;
+  std::uint8_t utf8_low = 0x80;
+  std::uint8_t utf8_high = 0xbf;
+
+  // The first error found, if any.
+  const char* error = nullptr;
+  std::size_t error_position = 0;
+};
+
+/**
+ * @brief Finds the structural characters of a JSON text, 64 bytes at a time.
+ *
+ * Every block is classified with a few vector compares, and the rest is bit arithmetic on 64 bit
+ * masks: quotes that aren't escaped delimit the strings, a prefix XOR over them masks the
+ * characters inside strings, and what remains are the brackets, colons and commas, the quotes and
+ * the first character of every number and literal. Those are reported by their position. Blocks
+ * that aren't plain ASCII have their UTF-8 validated, and control characters in strings are
+ * rejected. Everything else is left to the consumer of the positions, which only has to visit
+ * them instead of every character.
+ *
+ * The kernel is picked at runtime: AVX2 or SSE4.2 on x86-64 CPUs that have them, portable code
+ * everywhere else.
+ */
+class SOURCERER_API json_scanner {
+ public:
+  // Texts of up to 4 GiB can be scanned. A level the CPU doesn't support is lowered to one it does.
+  explicit json_scanner(std::string_view text, simd_level level = detect_simd_level());
+
+  simd_level level() const noexcept { return level_; }
+
+  // Appends the positions of the structural characters of the next part of the text to positions,
+  // in order. Returns false once the whole text has been scanned. Throws std::invalid_argument on
+  // invalid UTF-8 and control characters in strings.
+  bool next(std::vector<std::uint32_t>& positions);
+
+ private:
+  // Scans count blocks and writes the positions of their structural characters to out, which
+  // needs room for one per character. Returns the end of the positions, or nullptr on an error.
+  using kernel = std::uint32_t* (*)(const char* blocks, std::size_t count, std::uint32_t offset,
+                                    json_scan_state& state, std::uint32_t* out) noexcept;
+
+  // Runs the kernel and appends the positions it finds to positions.
+  void run(const char* blocks, std::size_t count, std::uint32_t offset,
+           std::vector<std::uint32_t>& positions);
+
+  std::string_view text_;
+  simd_level level_;
+  kernel kernel_;
+  json_scan_state state_;
+  std::size_t scanned_ = 0;
+  bool done_ = false;
+};
+
+}  // namespace sourcerer::detail
@@ -1,68 +1,126 @@
 #pragma once
 
+#include <array>
 #include <charconv>
+#include <cmath>
+#include <cstdint>
 #include <limits>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 
 #include "sourcerer/detail/concepts.hpp"
 #include "sourcerer/detail/node_forwards.hpp"
+#include "sourcerer/detail/parse_number.hpp"
 #include "sourcerer/detail/type_name.hpp"
+#include "sourcerer/error.hpp"
 
 namespace sourcerer::detail {
 
+// The conversions of Node::as<T>() and Node::try_as<T>(). They return the errors they run into,
+// magic_cast() raises them.
 template <class T, class U>
-T magic_cast(const U& /*value*/) {
-  throw std::invalid_argument{"Can't convert magic_cast " + type_name<U>() + " to " +
-                              type_name<T>()};
+result<T> try_magic_cast(const U& /*value*/) {
+  return error{errc::not_convertible, type_name_cstr<U>(), type_name_cstr<T>()};
 }
 
 template <class T>
-  requires std::constructible_from<T, value_t>
-constexpr T magic_cast(const value_t& value) {
-  return value;
-}
-
-template <class T>
-  requires std::constructible_from<value_t, T>
-constexpr value_t magic_cast(const T& value) {
-  return value;
+  requires std::constructible_from<T, std::string_view>
+constexpr result<T> try_magic_cast(std::string_view value) {
+  return T(value);
 }
 
 template <>
-bool magic_cast(const value_t& value) {
+inline result<bool> try_magic_cast(const std::string_view& value) {
   return value == "true" || value == "1";
 }
 
-template <>
-value_t magic_cast(const bool& value) {
-  return value ? "true" : "false";
+template <number T>
+result<T> try_magic_cast(std::string_view value) {
+  // Plain decimal numbers take a fast path with the same result.
+  if constexpr (std::is_same_v<T, double>) {
+    if (double parsed; parse_double(value, parsed)) return parsed;
+  } else if constexpr (std::is_integral_v<T>) {
+    std::uint64_t magnitude = 0;
+    bool negative = false;
+    if (parse_integer(value, magnitude, negative)) {
+      constexpr auto max = static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+      if (!negative && magnitude <= max) return static_cast<T>(magnitude);
+      if (negative && std::is_signed_v<T> && magnitude <= max) {
+        return static_cast<T>(-static_cast<std::int64_t>(magnitude));
+      }
+    }
+  }
+
+  T parsed;
+  if (std::from_chars(value.begin(), value.end(), parsed).ec != std::errc{}) {
+    return error{errc::invalid_number, "string", type_name_cstr<T>()};
+  }
+
+  return parsed;
 }
 
+// Large enough for any integer and the shortest round trip representation of any double.
+inline constexpr std::size_t max_chars = 32;
+
+// Formats value into buffer and returns the part of it that was written.
 template <number T>
-T magic_cast(const value_t& value) {
-  const std::string_view sv{value};
-  T result;
-  auto [ptr, ec]{std::from_chars(sv.begin(), sv.end(), result)};
-  if (ec != std::errc{}) {
-    throw std::invalid_argument{"Failed to convert value to type \"" + type_name<T>() +
-                                "\" with: " + std::make_error_code(ec).message()};
+std::string_view format(const T value, std::array<char, max_chars>& buffer) noexcept {
+  // The buffer is large enough for every value, so this can't fail.
+  const auto end = std::to_chars(buffer.begin(), buffer.end(), value).ptr;
+  return {buffer.data(), static_cast<std::size_t>(end - buffer.data())};
+}
+
+// Numbers are converted between each other if the value is representable in the target type.
+template <number T, number U>
+result<T> try_magic_cast(const U& value) {
+  if constexpr (std::is_integral_v<T> && std::is_integral_v<U>) {
+    if (std::in_range<T>(value)) {
+      return static_cast<T>(value);
+    }
+  } else if constexpr (std::is_integral_v<T>) {
+    // The upper bound is exclusive, the maximum of T is usually not representable in U.
+    if (std::trunc(value) == value && value >= static_cast<U>(std::numeric_limits<T>::lowest()) &&
+        value < static_cast<U>(std::numeric_limits<T>::max()) + 1) {
+      return static_cast<T>(value);
+    }
+  } else {
+    return static_cast<T>(value);
   }
 
-  return result;
+  return error{errc::out_of_range, type_name_cstr<U>(), type_name_cstr<T>()};
 }
 
 template <number T>
-value_t magic_cast(const T& value) {
-  constexpr auto buffer_size{std::is_integral_v<T> ? std::numeric_limits<T>::digits10 + 1 : 100};
-
-  std::array<char, buffer_size> buffer;
-  auto [ptr, ec]{std::to_chars(buffer.begin(), buffer.end(), value)};
-  if (ec != std::errc{}) {
-    throw std::invalid_argument{"Failed to convert value magic_cast type \"" + type_name<T>() +
-                                "\" with: " + std::make_error_code(ec).message()};
+constexpr result<T> try_magic_cast(const bool& value) {
+  return value ? T{1} : T{0};
+}
+
+template <std::same_as<bool> T, number U>
+constexpr result<T> try_magic_cast(const U& value) {
+  return value != U{0};
+}
+
+template <std::same_as<bool> T>
+constexpr result<T> try_magic_cast(const bool& value) {
+  return value;
+}
+
+// Numbers and bools are formatted, to be read as strings.
+template <class T, class U>
+  requires(number<U> || std::same_as<U, bool>) && std::constructible_from<T, std::string_view>
+result<T> try_magic_cast(const U& value) {
+  if constexpr (std::is_same_v<U, bool>) {
+    return T(std::string_view{value ? "true" : "false"});
+  } else {
+    std::array<char, max_chars> buffer;
+    return T(format(value, buffer));
   }
+}
 
-  return std::string{buffer.begin(), ptr};
+template <class T, class U>
+T magic_cast(const U& value) {
+  return try_magic_cast<T>(value).value();
 }
 
 }  // namespace sourcerer::detail
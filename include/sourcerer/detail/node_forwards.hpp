@@ -1,11 +1,14 @@
 #pragma once
 
-#include <map>
+#include <cstdint>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <variant>
 #include <vector>
 
+#include "sourcerer/detail/object_map.hpp"
+
 namespace sourcerer {
 
 class Node;
@@ -13,14 +16,29 @@ class Node;
 namespace detail {
 
 using index_t = size_t;
-using key_t = std::string;
+using key_t = Key;
 
 using null_t = std::monostate;
-using value_t = std::string;
-using array_t = std::vector<std::unique_ptr<Node>>;
-using object_t = std::map<key_t, std::unique_ptr<Node>, std::less<>>;
+using value_t = std::pmr::string;
+using array_t = std::pmr::vector<Node>;
+using object_t = object_map<Node>;
+
+// The tag of the alternative a Node currently holds. The scalar kinds, from boolean up to string,
+// are all values.
+enum class node_kind : std::uint8_t {
+  null,
+  boolean,
+  integer,
+  unsigned_integer,
+  floating,
+  string,
+  array,
+  object
+};
 
-using children_t = std::variant<detail::null_t, detail::value_t, detail::array_t, detail::object_t>;
+constexpr bool is_scalar(const node_kind kind) noexcept {
+  return kind >= node_kind::boolean && kind <= node_kind::string;
+}
 
 // Helper for static asserts.
 template <class>
@@ -34,4 +52,4 @@ struct overloaded : Ts... {
 
 }  // namespace detail
 
-}  // namespace sourcerer
\ No newline at end of file
+}  // namespace sourcerer
@@ -2,7 +2,8 @@
 
 #include <cassert>
 #include <compare>
-#include <variant>
+#include <iterator>
+#include <type_traits>
 
 #include "sourcerer/common.hpp"
 #include "sourcerer/detail/helpers.hpp"
@@ -37,48 +38,76 @@ class iter_impl {
   explicit iter_impl(pointer node) : node_{node} {
     assert(node_ != nullptr);
 
-    std::visit(detail::overloaded{[this](auto&) { iter_.simple = 0; },
-                                  [this](BasicNode::array_t&) {
-                                    iter_.array = typename BasicNode::array_t::iterator{};
-                                  },
-                                  [this](BasicNode::object_t&) {
-                                    iter_.object = typename BasicNode::object_t::iterator{};
-                                  }},
-               node_->children_);
+    switch (node_->kind_) {
+      case node_kind::array:
+        iter_.array = array_iterator{};
+        break;
+      case node_kind::object:
+        iter_.object = object_iterator{};
+        break;
+      default:
+        iter_.simple = 0;
+        break;
+    }
   }
 
  private:
+  using array_iterator =
+      std::conditional_t<std::is_const_v<BasicNode>, typename BasicNode::array_t::const_iterator,
+                         typename BasicNode::array_t::iterator>;
+  using object_iterator =
+      std::conditional_t<std::is_const_v<BasicNode>, typename BasicNode::object_t::const_iterator,
+                         typename BasicNode::object_t::iterator>;
+
   void set_begin() {
     assert(node_ != nullptr);
 
-    std::visit(detail::overloaded{[this](auto&) { iter_.simple = 1; },
-                                  [this](BasicNode::value_t&) { iter_.simple = 0; },
-                                  [this](BasicNode::array_t& v) { iter_.array = std::begin(v); },
-                                  [this](BasicNode::object_t& v) { iter_.object = std::begin(v); }},
-               node_->children_);
+    switch (node_->kind_) {
+      case node_kind::null:
+        iter_.simple = 1;
+        break;
+      case node_kind::array:
+        iter_.array = std::begin(node_->template get<typename BasicNode::array_t>());
+        break;
+      case node_kind::object:
+        iter_.object = std::begin(node_->template get<typename BasicNode::object_t>());
+        break;
+      default:
+        // Values iterate over themselves.
+        iter_.simple = 0;
+        break;
+    }
   }
 
   void set_end() {
     assert(node_ != nullptr);
 
-    std::visit(detail::overloaded{[this](auto&) { iter_.simple = 1; },
-                                  [this](BasicNode::array_t& v) { iter_.array = std::end(v); },
-                                  [this](BasicNode::object_t& v) { iter_.object = std::end(v); }},
-               node_->children_);
+    switch (node_->kind_) {
+      case node_kind::array:
+        iter_.array = std::end(node_->template get<typename BasicNode::array_t>());
+        break;
+      case node_kind::object:
+        iter_.object = std::end(node_->template get<typename BasicNode::object_t>());
+        break;
+      default:
+        iter_.simple = 1;
+        break;
+    }
   }
 
  public:
   pointer operator->() const {
     assert(node_ != nullptr);
 
-    return std::visit(
-        detail::overloaded{[this](auto&) {
-                             if (iter_.simple != 0) throw std::out_of_range{""};
-                             return node_;
-                           },
-                           [this](BasicNode::array_t&) { return iter_.array->get(); },
-                           [this](BasicNode::object_t&) { return iter_.object->second.get(); }},
-        node_->children_);
+    switch (node_->kind_) {
+      case node_kind::array:
+        return &*iter_.array;
+      case node_kind::object:
+        return &iter_.object->second;
+      default:
+        if (iter_.simple != 0) SOURCERER_THROW(std::out_of_range{""});
+        return node_;
+    }
   }
 
   reference operator*() const { return *operator->(); }
@@ -86,13 +115,18 @@ class iter_impl {
   iter_impl& operator++() {
     assert(node_ != nullptr);
 
-    std::visit(detail::overloaded{[this](auto&) {
-                                    if (iter_.simple != 0) throw std::out_of_range{""};
-                                    ++iter_.simple;
-                                  },
-                                  [this](BasicNode::array_t&) { ++iter_.array; },
-                                  [this](BasicNode::object_t&) { ++iter_.object; }},
-               node_->children_);
+    switch (node_->kind_) {
+      case node_kind::array:
+        ++iter_.array;
+        break;
+      case node_kind::object:
+        ++iter_.object;
+        break;
+      default:
+        if (iter_.simple != 0) SOURCERER_THROW(std::out_of_range{""});
+        ++iter_.simple;
+        break;
+    }
     return *this;
   }
 
@@ -105,13 +139,18 @@ class iter_impl {
   iter_impl& operator--() {
     assert(node_ != nullptr);
 
-    std::visit(detail::overloaded{[this](auto&) {
-                                    if (iter_.simple != 1) throw std::out_of_range{""};
-                                    --iter_.simple;
-                                  },
-                                  [this](BasicNode::array_t&) { --iter_.array; },
-                                  [this](BasicNode::object_t&) { --iter_.object; }},
-               node_->children_);
+    switch (node_->kind_) {
+      case node_kind::array:
+        --iter_.array;
+        break;
+      case node_kind::object:
+        --iter_.object;
+        break;
+      default:
+        if (iter_.simple != 1) SOURCERER_THROW(std::out_of_range{""});
+        --iter_.simple;
+        break;
+    }
     return *this;
   }
 
@@ -126,19 +165,21 @@ class iter_impl {
 
     assert(node_ != nullptr);
 
-    return std::visit(
-        detail::overloaded{
-            [this, &other](auto&) { return iter_.simple == other.iter_.simple; },
-            [this, &other](BasicNode::array_t&) { return iter_.array == other.iter_.array; },
-            [this, &other](BasicNode::object_t&) { return iter_.object == other.iter_.object; }},
-        node_->children_);
+    switch (node_->kind_) {
+      case node_kind::array:
+        return iter_.array == other.iter_.array;
+      case node_kind::object:
+        return iter_.object == other.iter_.object;
+      default:
+        return iter_.simple == other.iter_.simple;
+    }
   }
 
  private:
   union iter_t {
     difference_type simple;
-    typename BasicNode::array_t::iterator array;
-    typename BasicNode::object_t::iterator object;
+    array_iterator array;
+    object_iterator object;
   };
   iter_t iter_{};
   pointer node_{nullptr};
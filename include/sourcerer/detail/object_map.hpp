@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "sourcerer/key_pool.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sourcerer::detail {
+
+// The order in which the entries of an object_map are iterated.
+enum class key_order : std::uint8_t { sorted, insertion };
+
+/**
+ * @brief A flat, cache friendly map from string keys to Values.
+ *
+ * Entries live in one contiguous vector, next to a parallel array of their key hashes. Small maps
+ * are searched by scanning the hashes, which fits in a few cache lines, and only matching hashes
+ * compare the actual key. The tiniest ones just compare the keys. Once a map grows past
+ * @ref index_threshold entries, an open addressing index over the entries is maintained so lookups
+ * stay a single probe sequence.
+ *
+ * Entries are kept sorted by key by default, which makes iteration match a std::map. With
+ * @ref key_order::insertion they are iterated in the order they were inserted instead. Inserting
+ * in key order, or in insertion order mode, appends and is amortized O(1). Inserting elsewhere in a
+ * sorted map shifts the following entries, like any sorted vector.
+ *
+ * Keys are interned in a KeyPool, which is usually shared by all objects of a tree. Maps that
+ * weren't given one create their own on the first insertion. Looking up a Key of the same pool
+ * compares handles instead of text.
+ */
+template <class Value>
+class object_map {
+ public:
+  using key_type = Key;
+  using mapped_type = Value;
+  // The key of an entry must not be modified through an iterator.
+  using value_type = std::pair<key_type, Value>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using allocator_type = std::pmr::polymorphic_allocator<value_type>;
+
+  using iterator = typename std::pmr::vector<value_type>::iterator;
+  using const_iterator = typename std::pmr::vector<value_type>::const_iterator;
+
+  // Maps up to this size compare keys directly, hashing the key would cost more than it saves.
+  static constexpr size_type linear_threshold = 4;
+  // Maps with more entries than this keep a hash index.
+  static constexpr size_type index_threshold = 16;
+
+  object_map() = default;
+  explicit object_map(const allocator_type& alloc)
+      : entries_{alloc}, hashes_{alloc}, index_{alloc} {}
+  explicit object_map(const key_order order, const allocator_type& alloc = {})
+      : entries_{alloc}, hashes_{alloc}, index_{alloc}, order_{order} {}
+  explicit object_map(std::shared_ptr<KeyPool> keys, const key_order order = key_order::sorted,
+                      const allocator_type& alloc = {})
+      : entries_{alloc}, hashes_{alloc}, index_{alloc}, keys_{std::move(keys)}, order_{order} {}
+
+  object_map(const object_map& other) = default;
+  object_map(const object_map& other, const allocator_type& alloc)
+      : entries_{other.entries_, alloc},
+        hashes_{other.hashes_, alloc},
+        index_{other.index_, alloc},
+        keys_{other.keys_},
+        order_{other.order_} {}
+  object_map(object_map&& other) noexcept = default;
+  object_map(object_map&& other, const allocator_type& alloc)
+      : entries_{std::move(other.entries_), alloc},
+        hashes_{std::move(other.hashes_), alloc},
+        index_{std::move(other.index_), alloc},
+        keys_{std::move(other.keys_)},
+        order_{other.order_} {}
+
+  object_map& operator=(const object_map& other) = default;
+  object_map& operator=(object_map&& other) = default;
+
+  allocator_type get_allocator() const noexcept { return entries_.get_allocator(); }
+  key_order order() const noexcept { return order_; }
+  // The pool the keys are interned in, nullptr until the first insertion if none was given.
+  const std::shared_ptr<KeyPool>& keys() const noexcept { return keys_; }
+
+  iterator begin() noexcept { return entries_.begin(); }
+  iterator end() noexcept { return entries_.end(); }
+  const_iterator begin() const noexcept { return entries_.begin(); }
+  const_iterator end() const noexcept { return entries_.end(); }
+  const_iterator cbegin() const noexcept { return entries_.cbegin(); }
+  const_iterator cend() const noexcept { return entries_.cend(); }
+
+  size_type size() const noexcept { return entries_.size(); }
+  bool empty() const noexcept { return entries_.empty(); }
+  size_type capacity() const noexcept { return entries_.capacity(); }
+  // The bytes allocated for looking keys up, besides the entries.
+  size_type lookup_bytes() const noexcept {
+    return (hashes_.capacity() + index_.capacity()) * sizeof(std::uint32_t);
+  }
+
+  // Also reserves the index size entries need, so inserting them doesn't grow it.
+  void reserve(const size_type size) {
+    entries_.reserve(size);
+    hashes_.reserve(size);
+    if (size > index_threshold) {
+      index_.reserve(std::bit_ceil(4 * size));
+    }
+  }
+
+  void clear() noexcept {
+    entries_.clear();
+    hashes_.clear();
+    index_.clear();
+  }
+
+  iterator find(std::string_view key) noexcept {
+    return begin() + static_cast<difference_type>(position_of(key));
+  }
+  const_iterator find(std::string_view key) const noexcept {
+    return begin() + static_cast<difference_type>(position_of(key));
+  }
+  iterator find(const Key& key) noexcept {
+    return begin() + static_cast<difference_type>(position_of(key));
+  }
+  const_iterator find(const Key& key) const noexcept {
+    return begin() + static_cast<difference_type>(position_of(key));
+  }
+
+  // The same, for a key whose hash is already known.
+  const_iterator find(std::string_view key, const std::uint32_t key_hash) const noexcept {
+    const auto position =
+        size() <= linear_threshold ? linear_position_of(key) : position_of(key, key_hash);
+    return begin() + static_cast<difference_type>(position);
+  }
+
+  bool contains(std::string_view key) const noexcept { return find(key) != end(); }
+  bool contains(const Key& key) const noexcept { return find(key) != end(); }
+
+  // Inserts a Value constructed from args if key isn't present yet.
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(std::string_view key, Args&&... args) {
+    const auto key_hash = Key::hash(key);
+    if (const auto position = position_of(key, key_hash); position != size()) {
+      return {begin() + static_cast<difference_type>(position), false};
+    }
+
+    return {insert(pool().intern(key, key_hash), std::forward<Args>(args)...), true};
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+    if (const auto position = position_of(key); position != size()) {
+      return {begin() + static_cast<difference_type>(position), false};
+    }
+
+    return {insert(intern(key), std::forward<Args>(args)...), true};
+  }
+
+  // Like try_emplace, but a hint at end() for a key greater than all present ones appends without
+  // looking the key up. Sorted maps are built from keys in sorted order in linear time like that.
+  template <class... Args>
+  iterator emplace_hint(const_iterator hint, const Key& key, Args&&... args) {
+    if (hint == cend() && order_ == key_order::sorted && (empty() || entries_.back().first < key)) {
+      return insert(intern(key), std::forward<Args>(args)...);
+    }
+
+    return try_emplace(key, std::forward<Args>(args)...).first;
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(std::string_view key, Args&&... args) {
+    return try_emplace(key, std::forward<Args>(args)...);
+  }
+
+  template <class... Args>
+  std::pair<iterator, bool> emplace(const Key& key, Args&&... args) {
+    return try_emplace(key, std::forward<Args>(args)...);
+  }
+
+  iterator erase(const_iterator pos) {
+    const auto position = pos - cbegin();
+    hashes_.erase(hashes_.begin() + position);
+    auto it = entries_.erase(pos);
+    rebuild_index();
+    return it;
+  }
+
+  size_type erase(std::string_view key) {
+    auto it = find(key);
+    if (it == end()) return 0;
+
+    erase(it);
+    return 1;
+  }
+
+  // Two maps are equal if they hold the same keys with equal values, regardless of their order.
+  bool operator==(const object_map& other) const {
+    if (size() != other.size()) return false;
+
+    return std::ranges::all_of(entries_, [&other](const auto& entry) {
+      auto it = other.find(entry.first);
+      return it != other.end() && it->second == entry.second;
+    });
+  }
+
+ private:
+  KeyPool& pool() {
+    if (keys_ == nullptr) {
+      keys_ = std::make_shared<KeyPool>();
+    }
+    return *keys_;
+  }
+
+  // Returns key as a key of this map's pool.
+  Key intern(const Key& key) {
+    if (keys_ != nullptr && key.pool() == keys_.get()) {
+      return key;
+    }
+    return pool().intern(key, key.hash());
+  }
+
+  // Inserts a new entry for key, which must not be present yet.
+  template <class... Args>
+  iterator insert(const Key& key, Args&&... args) {
+    const auto position = insert_position(key);
+    entries_.emplace(entries_.begin() + static_cast<difference_type>(position),
+                     std::piecewise_construct, std::forward_as_tuple(key),
+                     std::forward_as_tuple(std::forward<Args>(args)...));
+    hashes_.insert(hashes_.begin() + static_cast<difference_type>(position), key.hash());
+
+    if (position + 1 == size()) {
+      index_append(position);
+    } else {
+      rebuild_index();
+    }
+
+    return begin() + static_cast<difference_type>(position);
+  }
+
+  // Returns the position of key, or size() if it isn't present.
+  size_type position_of(std::string_view key) const noexcept {
+    if (size() <= linear_threshold) {
+      return linear_position_of(key);
+    }
+
+    return position_of(key, Key::hash(key));
+  }
+
+  size_type position_of(const Key& key) const noexcept {
+    if (size() <= linear_threshold) {
+      return linear_position_of(key);
+    }
+
+    return position_of(key, key.hash());
+  }
+
+  // Key compares handles first, string_view only compares text.
+  template <class K>
+  size_type linear_position_of(const K& key) const noexcept {
+    auto it = std::ranges::find_if(entries_,
+                                   [&key](const auto& entry) { return entry.first == key; });
+    return static_cast<size_type>(it - entries_.begin());
+  }
+
+  template <class K>
+  size_type position_of(const K& key, const std::uint32_t key_hash) const noexcept {
+    if (!index_.empty()) {
+      const auto mask = index_.size() - 1;
+      for (auto slot = key_hash & mask; index_[slot] != 0; slot = (slot + 1) & mask) {
+        const auto position = index_[slot] - 1;
+        if (hashes_[position] == key_hash && entries_[position].first == key) {
+          return position;
+        }
+      }
+      return size();
+    }
+
+    for (auto position = scan(key_hash, 0); position < size();
+         position = scan(key_hash, position + 1)) {
+      if (entries_[position].first == key) {
+        return position;
+      }
+    }
+    return size();
+  }
+
+  // Returns the first position from start on whose hash matches, or size() if there is none.
+  size_type scan(const std::uint32_t key_hash, size_type start) const noexcept {
+#if defined(__SSE2__)
+    const auto needle = _mm_set1_epi32(static_cast<int>(key_hash));
+    for (; start + 4 <= size(); start += 4) {
+      const auto hashes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&hashes_[start]));
+      const auto mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(hashes, needle)));
+      if (mask != 0) {
+        return start + static_cast<size_type>(std::countr_zero(static_cast<unsigned>(mask)));
+      }
+    }
+#endif
+    for (; start < size(); ++start) {
+      if (hashes_[start] == key_hash) return start;
+    }
+    return size();
+  }
+
+  size_type insert_position(std::string_view key) const {
+    if (order_ == key_order::insertion || empty() || entries_.back().first.view() < key) {
+      return size();
+    }
+
+    auto it = std::ranges::lower_bound(entries_, key, std::less<>{},
+                                       [](const auto& entry) -> std::string_view {
+                                         return entry.first;
+                                       });
+    return static_cast<size_type>(it - entries_.begin());
+  }
+
+  void index_append(const size_type position) {
+    if (size() <= index_threshold) return;
+
+    // Keep the load factor at or below one half.
+    if (index_.size() < 2 * size()) {
+      rebuild_index();
+      return;
+    }
+
+    index_insert(position);
+  }
+
+  void index_insert(const size_type position) noexcept {
+    const auto mask = index_.size() - 1;
+    auto slot = hashes_[position] & mask;
+    while (index_[slot] != 0) {
+      slot = (slot + 1) & mask;
+    }
+    index_[slot] = static_cast<std::uint32_t>(position + 1);
+  }
+
+  void rebuild_index() {
+    index_.clear();
+    if (size() <= index_threshold) return;
+
+    index_.resize(std::bit_ceil(4 * size()));
+    for (size_type position = 0; position < size(); ++position) {
+      index_insert(position);
+    }
+  }
+
+  std::pmr::vector<value_type> entries_;
+  std::pmr::vector<std::uint32_t> hashes_;
+  // Open addressing table of entry positions plus one, zero marks an empty slot.
+  std::pmr::vector<std::uint32_t> index_;
+  std::shared_ptr<KeyPool> keys_;
+  key_order order_ = key_order::sorted;
+};
+
+}  // namespace sourcerer::detail
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include "sourcerer/detail/concepts.hpp"
+#include "sourcerer/error.hpp"
+#include "sourcerer/key_pool.hpp"
+
+namespace sourcerer::detail {
+
+/**
+ * @brief An iterator over the members of an object as (key, value) pairs.
+ *
+ * It wraps the iterator of the object's container and yields pairs of references, so it costs
+ * what iterating the container does. Keys can't be changed through it, values can unless
+ * BasicNode is const.
+ */
+template <basic_node BasicNode>
+class items_iterator {
+  using object_type =
+      std::conditional_t<std::is_const_v<BasicNode>, const typename BasicNode::object_t,
+                         typename BasicNode::object_t>;
+  using base_iterator = decltype(std::declval<object_type&>().begin());
+
+ public:
+  using iterator_concept = std::bidirectional_iterator_tag;
+  using iterator_category = std::input_iterator_tag;
+  // The pairs are proxies, there are no pairs to refer to.
+  using value_type = std::pair<const Key&, BasicNode&>;
+  using reference = value_type;
+  using difference_type = std::ptrdiff_t;
+
+  items_iterator() = default;
+  explicit items_iterator(const base_iterator it) noexcept : it_{it} {}
+
+  reference operator*() const noexcept { return {it_->first, it_->second}; }
+
+  items_iterator& operator++() noexcept {
+    ++it_;
+    return *this;
+  }
+  items_iterator operator++(int) noexcept { return items_iterator{it_++}; }
+  items_iterator& operator--() noexcept {
+    --it_;
+    return *this;
+  }
+  items_iterator operator--(int) noexcept { return items_iterator{it_--}; }
+
+  bool operator==(const items_iterator& other) const noexcept { return it_ == other.it_; }
+
+ private:
+  base_iterator it_{};
+};
+
+/**
+ * @brief A typed view of the members of an object, see Node::as_object().
+ *
+ * The node's kind was checked when the view was made, so neither iterating nor looking keys up
+ * checks it again. A view of a null node is empty. It is valid as long as the object isn't
+ * changed, like iterators into it.
+ */
+template <basic_node BasicNode>
+class object_view {
+  using object_type =
+      std::conditional_t<std::is_const_v<BasicNode>, const typename BasicNode::object_t,
+                         typename BasicNode::object_t>;
+
+ public:
+  using iterator = items_iterator<BasicNode>;
+  using size_type = std::size_t;
+
+  object_view() = default;
+  explicit object_view(object_type* object) noexcept : object_{object} {}
+
+  iterator begin() const noexcept {
+    return object_ != nullptr ? iterator{object_->begin()} : iterator{};
+  }
+  iterator end() const noexcept {
+    return object_ != nullptr ? iterator{object_->end()} : iterator{};
+  }
+
+  size_type size() const noexcept { return object_ != nullptr ? object_->size() : 0; }
+  bool empty() const noexcept { return size() == 0; }
+
+  // The value of key, or nullptr if there is none.
+  BasicNode* find(std::string_view key) const noexcept { return find_entry(key); }
+  BasicNode* find(const Key& key) const noexcept { return find_entry(key); }
+
+  bool contains(std::string_view key) const noexcept { return find(key) != nullptr; }
+  bool contains(const Key& key) const noexcept { return find(key) != nullptr; }
+
+  // The value of key, throws std::out_of_range if there is none.
+  BasicNode& at(std::string_view key) const { return checked(find(key)); }
+  BasicNode& at(const Key& key) const { return checked(find(key)); }
+
+ private:
+  template <class K>
+  BasicNode* find_entry(const K& key) const noexcept {
+    if (object_ == nullptr) return nullptr;
+    const auto it = object_->find(key);
+    return it != object_->end() ? &it->second : nullptr;
+  }
+
+  static BasicNode& checked(BasicNode* value) {
+    if (value == nullptr) error{errc::key_not_found}.raise();
+    return *value;
+  }
+
+  object_type* object_ = nullptr;
+};
+
+}  // namespace sourcerer::detail
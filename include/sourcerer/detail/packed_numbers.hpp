@@ -0,0 +1,100 @@
+#pragma once
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <span>
+#include <type_traits>
+
+namespace sourcerer::detail {
+
+template <class T>
+concept packed_number = std::same_as<T, std::int64_t> || std::same_as<T, double>;
+
+/**
+ * @brief The elements of an array converted to one number type and packed into a buffer.
+ *
+ * The shared block of an array keeps a list of them, one per type they were requested as. They
+ * are only appended to, so spans into them stay valid until a writer drops the list.
+ */
+class packed_numbers {
+ public:
+  template <packed_number T>
+  static packed_numbers* create(const std::size_t size) {
+    static_assert(sizeof(packed_numbers) % alignof(T) == 0);
+    auto* memory = ::operator new(sizeof(packed_numbers) + size * sizeof(T));
+    return ::new (memory) packed_numbers(std::is_same_v<T, double>, size);
+  }
+
+  // Destroys list and all buffers after it.
+  static void destroy(packed_numbers* list) noexcept {
+    while (list != nullptr) {
+      auto* next = list->next_.load(std::memory_order_relaxed);
+      list->~packed_numbers();
+      ::operator delete(list);
+      list = next;
+    }
+  }
+
+  template <packed_number T>
+  bool holds() const noexcept {
+    return floating_ == std::is_same_v<T, double>;
+  }
+
+  template <packed_number T>
+  std::span<T> values() noexcept {
+    return {reinterpret_cast<T*>(this + 1), size_};
+  }
+  template <packed_number T>
+  std::span<const T> values() const noexcept {
+    return {reinterpret_cast<const T*>(this + 1), size_};
+  }
+
+  // The bytes of list and all buffers after it. Both number types take eight bytes.
+  static std::size_t bytes(const packed_numbers* list) noexcept {
+    std::size_t bytes = 0;
+    for (; list != nullptr; list = list->next_.load(std::memory_order_acquire)) {
+      bytes += sizeof(packed_numbers) + list->size_ * sizeof(std::int64_t);
+    }
+    return bytes;
+  }
+
+  // Finds the buffer of T in list, or nullptr.
+  template <packed_number T>
+  static packed_numbers* find(packed_numbers* list) noexcept {
+    for (; list != nullptr; list = list->next_.load(std::memory_order_acquire)) {
+      if (list->holds<T>()) return list;
+    }
+    return nullptr;
+  }
+
+  // Appends buffer to the list at head, unless another thread appended one of its type first,
+  // which is returned instead while buffer is destroyed.
+  template <packed_number T>
+  static packed_numbers* append(std::atomic<packed_numbers*>& head, packed_numbers* buffer) {
+    auto* link = &head;
+    while (true) {
+      packed_numbers* expected = nullptr;
+      if (link->compare_exchange_strong(expected, buffer, std::memory_order_acq_rel)) {
+        return buffer;
+      }
+      if (expected->holds<T>()) {
+        destroy(buffer);
+        return expected;
+      }
+      link = &expected->next_;
+    }
+  }
+
+ private:
+  packed_numbers(const bool floating, const std::size_t size) noexcept
+      : floating_{floating}, size_{size} {}
+
+  std::atomic<packed_numbers*> next_{nullptr};
+  bool floating_;
+  std::size_t size_;
+};
+
+}  // namespace sourcerer::detail
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+#include "sourcerer/common.hpp"
+
+namespace sourcerer::detail {
+
+/**
+ * @brief Fast paths for turning text into numbers, for the common plain decimal numbers.
+ *
+ * Configurations from the environment, command lines or INI files deliver numbers as text, which
+ * is parsed on every read. These only accept text that is all an optional '-' and decimal digits,
+ * with at most one '.' between digits for doubles, and return false for anything else. So they
+ * give exactly the result std::from_chars gives, and callers fall back to it for the rest.
+ *
+ * Digits are converted eight at a time with SWAR, the SIMD within a register variant of the
+ * vectorized digit conversion of SIMD number parsers, which needs no instruction set extension.
+ * Doubles whose digits fit into 53 bits, with up to 22 decimals, are computed from their integer
+ * mantissa with a single correctly rounded division.
+ */
+SOURCERER_API bool parse_integer(std::string_view text, std::uint64_t& magnitude,
+                                 bool& negative) noexcept;
+SOURCERER_API bool parse_double(std::string_view text, double& value) noexcept;
+
+// Parses every text into the value at its position, and returns how many were parsed before the
+// first one that isn't a number in range, with std::from_chars for the ones the fast paths reject.
+// Like std::from_chars, leading '+' signs, whitespace and trailing characters are not accepted.
+SOURCERER_API std::size_t parse_numbers(std::span<const std::string_view> texts,
+                                        std::span<double> values) noexcept;
+SOURCERER_API std::size_t parse_numbers(std::span<const std::string_view> texts,
+                                        std::span<std::int64_t> values) noexcept;
+
+}  // namespace sourcerer::detail
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+namespace sourcerer::detail {
+
+/**
+ * @brief A minimal perfect hash over the 32 bit hashes of a fixed set of keys.
+ *
+ * Uses hash and displace: the keys are split into buckets by their hash, and every bucket gets a
+ * displacement that moves all of its keys into slots no other key took. Looking up a slot costs
+ * three multiplications and reading the displacement of one bucket, and n keys take exactly n
+ * slots. The hashes must already be well mixed, like the ones of Key are. The displacements live in
+ * memory owned by the caller, so many tables can share one buffer.
+ */
+namespace perfect_hash {
+
+// Tries per bucket before giving up, far more than any realistic set of keys needs.
+inline constexpr std::uint32_t max_displacement = 1U << 20;
+
+// The number of buckets, and with it displacements, used for size keys.
+constexpr std::size_t buckets_for(const std::size_t size) noexcept { return (size + 1) / 2; }
+
+// Maps x to [0, size) with a multiplication instead of a division.
+constexpr std::uint32_t reduce(const std::uint32_t x, const std::uint32_t size) noexcept {
+  return static_cast<std::uint32_t>((std::uint64_t{x} * size) >> 32);
+}
+
+constexpr std::uint32_t bucket_of(const std::uint32_t hash, const std::uint32_t buckets) noexcept {
+  return reduce(hash, buckets);
+}
+
+// The upper half of a multiplicative hash depends on every bit of hash and displacement.
+constexpr std::uint32_t slot_of(const std::uint32_t hash, const std::uint32_t displacement,
+                                const std::uint32_t size) noexcept {
+  const auto mixed = ((std::uint64_t{hash} << 32) | displacement) * 0x9e3779b97f4a7c15ULL;
+  return reduce(static_cast<std::uint32_t>(mixed >> 32), size);
+}
+
+// Returns the slot of hash in a table of size keys, using the displacements the table was built
+// with. Hashes that aren't part of the table land in an arbitrary slot.
+constexpr std::uint32_t lookup(const std::uint32_t hash,
+                               std::span<const std::uint32_t> displacements,
+                               const std::uint32_t size) noexcept {
+  const auto buckets = static_cast<std::uint32_t>(displacements.size());
+  return slot_of(hash, displacements[bucket_of(hash, buckets)], size);
+}
+
+// Builds the table of hashes into displacements, which needs buckets_for(hashes.size()) entries,
+// and writes the slot of every hash into slots. Returns false if no table could be found, which
+// happens if hashes contains duplicates.
+inline bool build(std::span<const std::uint32_t> hashes, std::span<std::uint32_t> displacements,
+                  std::span<std::uint32_t> slots) {
+  const auto size = static_cast<std::uint32_t>(hashes.size());
+  const auto buckets = static_cast<std::uint32_t>(displacements.size());
+  if (size == 0) return true;
+
+  // Keys with equal hashes always share a slot.
+  std::vector<std::uint32_t> sorted(hashes.begin(), hashes.end());
+  std::ranges::sort(sorted);
+  if (std::ranges::adjacent_find(sorted) != sorted.end()) return false;
+
+  // Order the keys by bucket, and the buckets by size, largest first: they are the hardest to place
+  // and are placed while most slots are still free.
+  std::vector<std::uint32_t> first(buckets + 1, 0);
+  for (const auto hash : hashes) {
+    ++first[bucket_of(hash, buckets) + 1];
+  }
+  for (std::uint32_t b = 0; b < buckets; ++b) {
+    first[b + 1] += first[b];
+  }
+  std::vector<std::uint32_t> keys(size);
+  {
+    auto next = first;
+    for (std::uint32_t i = 0; i < size; ++i) {
+      keys[next[bucket_of(hashes[i], buckets)]++] = i;
+    }
+  }
+  std::vector<std::uint32_t> order(buckets);
+  for (std::uint32_t b = 0; b < buckets; ++b) {
+    order[b] = b;
+  }
+  std::ranges::stable_sort(order, std::greater<>{},
+                           [&](const std::uint32_t b) { return first[b + 1] - first[b]; });
+
+  std::vector<bool> taken(size, false);
+  std::vector<std::uint32_t> candidate;
+  for (const auto b : order) {
+    const auto members = std::span{keys}.subspan(first[b], first[b + 1] - first[b]);
+    if (members.empty()) break;
+
+    std::uint32_t displacement = 0;
+    for (;; ++displacement) {
+      if (displacement == max_displacement) return false;
+
+      candidate.clear();
+      const auto fits = std::ranges::all_of(members, [&](const std::uint32_t key) {
+        const auto slot = slot_of(hashes[key], displacement, size);
+        if (taken[slot] || std::ranges::find(candidate, slot) != candidate.end()) return false;
+        candidate.push_back(slot);
+        return true;
+      });
+      if (fits) break;
+    }
+
+    displacements[b] = displacement;
+    for (std::size_t i = 0; i < members.size(); ++i) {
+      taken[candidate[i]] = true;
+      slots[members[i]] = candidate[i];
+    }
+  }
+
+  // Buckets without keys are only hit by hashes that aren't part of the table, any displacement
+  // does for them.
+  for (std::uint32_t b = 0; b < buckets; ++b) {
+    if (first[b + 1] == first[b]) displacements[b] = 0;
+  }
+  return true;
+}
+
+}  // namespace perfect_hash
+
+}  // namespace sourcerer::detail
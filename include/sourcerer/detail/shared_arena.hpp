@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+
+#include "sourcerer/common.hpp"
+
+namespace sourcerer::detail {
+
+/**
+ * @brief A monotonic arena that lives as long as its owner or any allocation made from it.
+ *
+ * Sourcerers build their trees into one. Copies of such a tree share its containers instead of
+ * copying them, and may outlive the sourcerer that owns the arena: it is only freed once the owner
+ * released it and the last allocation was returned.
+ *
+ * Only the owner may allocate from the arena. Deallocating is thread safe, copies are destroyed
+ * wherever they were handed to.
+ */
+class SOURCERER_API shared_arena final : public std::pmr::memory_resource {
+ public:
+  struct releaser {
+    void operator()(shared_arena* arena) const noexcept { arena->release(); }
+  };
+  using owner = std::unique_ptr<shared_arena, releaser>;
+
+  static owner create(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+  shared_arena(const shared_arena&) = delete;
+  shared_arena& operator=(const shared_arena&) = delete;
+
+ private:
+  explicit shared_arena(std::pmr::memory_resource* upstream);
+  ~shared_arena() override = default;
+
+  void release() noexcept;
+
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+  std::pmr::monotonic_buffer_resource arena_;
+  // The live allocations, plus one as long as the owner holds on to the arena.
+  std::atomic<std::size_t> refs_{1};
+};
+
+// Whether nodes allocated from resource may be shared by copies living in other resources, which
+// requires resource to outlive all of them.
+SOURCERER_API bool outlives_its_nodes(const std::pmr::memory_resource* resource) noexcept;
+
+}  // namespace sourcerer::detail
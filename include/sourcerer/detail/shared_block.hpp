@@ -0,0 +1,106 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/detail/packed_numbers.hpp"
+
+namespace sourcerer::detail {
+
+/**
+ * @brief The out-of-line container of a Node, shared between copies of the node.
+ *
+ * Copying a node only adds a reference to its block, and writers clone a shared block before
+ * changing it. That makes copies O(1) and a write O(depth), only the containers on the path to the
+ * change are cloned. Blocks whose memory resource may die before the copies are never shared.
+ *
+ * Once a reference into a block was handed out for writing, the block is marked as leaked and
+ * copies clone it right away. The reference could otherwise be used to change every copy.
+ *
+ * A block caches the hash of its value and the numbers of an array packed into buffers, which
+ * writers invalidate. Leaked blocks can be changed through their references without a writer
+ * knowing, so they don't cache the hash.
+ */
+template <class T>
+class shared_block {
+ public:
+  // Creates a block in resource, T is constructed from args.
+  template <class... Args>
+  static shared_block* create(std::pmr::memory_resource* resource, const bool shareable,
+                              Args&&... args) {
+    auto* memory = resource->allocate(sizeof(shared_block), alignof(shared_block));
+    SOURCERER_TRY {
+      return ::new (memory) shared_block(shareable, std::forward<Args>(args)...);
+    } SOURCERER_CATCH(...) {
+      resource->deallocate(memory, sizeof(shared_block), alignof(shared_block));
+      SOURCERER_RETHROW;
+    }
+  }
+
+  ~shared_block() { packed_numbers::destroy(packed_.load(std::memory_order_relaxed)); }
+
+  shared_block(const shared_block&) = delete;
+  shared_block& operator=(const shared_block&) = delete;
+
+  // Adds a reference to the block, returns false if it can't be shared.
+  bool acquire() noexcept {
+    if (!shareable_ || leaked_) return false;
+
+    refs_.fetch_add(1, std::memory_order_relaxed);
+    return true;
+  }
+
+  // Drops a reference to the block, destroying it with the last one.
+  void release() noexcept {
+    if (refs_.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+    auto* resource = value_.get_allocator().resource();
+    this->~shared_block();
+    resource->deallocate(this, sizeof(shared_block), alignof(shared_block));
+  }
+
+  // Whether the calling node is the only one referencing the block, and may change it.
+  bool unique() const noexcept { return refs_.load(std::memory_order_acquire) == 1; }
+  bool shareable() const noexcept { return shareable_; }
+
+  void leak() noexcept { leaked_ = true; }
+  bool leaked() const noexcept { return leaked_; }
+
+  // The cached hash of the value, 0 if there is none.
+  std::uint64_t hash() const noexcept {
+    return leaked_ ? 0 : hash_.load(std::memory_order_relaxed);
+  }
+  // Readers of copies may cache the same hash at once.
+  void cache(const std::uint64_t hash) const noexcept {
+    if (!leaked_) hash_.store(hash, std::memory_order_relaxed);
+  }
+  // Called before the value changes.
+  void invalidate() noexcept {
+    hash_.store(0, std::memory_order_relaxed);
+    packed_numbers::destroy(packed_.exchange(nullptr, std::memory_order_relaxed));
+  }
+
+  // The list of the packed numbers of the value, readers append to it.
+  std::atomic<packed_numbers*>& packed() const noexcept { return packed_; }
+
+  T& value() noexcept { return value_; }
+  const T& value() const noexcept { return value_; }
+
+ private:
+  template <class... Args>
+  explicit shared_block(const bool shareable, Args&&... args)
+      : shareable_{shareable}, value_(std::forward<Args>(args)...) {}
+
+  std::atomic<std::uint32_t> refs_{1};
+  bool shareable_;
+  bool leaked_ = false;
+  mutable std::atomic<std::uint64_t> hash_{0};
+  mutable std::atomic<packed_numbers*> packed_{nullptr};
+  T value_;
+};
+
+}  // namespace sourcerer::detail
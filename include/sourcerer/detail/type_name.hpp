@@ -59,14 +59,31 @@ template <typename T>
   return impl::type_name_storage<T>.data();
 }
 
-inline std::string type_name(const children_t& children) noexcept {
-  return std::visit(detail::overloaded{[](const null_t&) { return "null"; },
-                                       [](const value_t&) { return "value"; },
-                                       [](const array_t&) { return "array"; },
-                                       [](const object_t&) { return "object"; }},
-                    children);
+constexpr const char* kind_name(const node_kind kind) noexcept {
+  switch (kind) {
+    case node_kind::null:
+      return "null";
+    case node_kind::boolean:
+      return "bool";
+    case node_kind::integer:
+      return "integer";
+    case node_kind::unsigned_integer:
+      return "unsigned integer";
+    case node_kind::floating:
+      return "floating point";
+    case node_kind::string:
+      return "string";
+    case node_kind::array:
+      return "array";
+    case node_kind::object:
+      return "object";
+  }
+
+  return "";  // Make compiler happy.
 }
 
+inline std::string type_name(const node_kind kind) { return kind_name(kind); }
+
 template <child T>
 constexpr std::string type_name() noexcept {
   if constexpr (std::is_same_v<T, null_t>) {
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <vector>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/node.hpp"
+#include "sourcerer/path.hpp"
+
+namespace sourcerer {
+
+// The differences between two trees, as the paths of the values that differ.
+struct Diff {
+  // Values only the tree after has.
+  std::vector<Path> added;
+  // Values only the tree before has.
+  std::vector<Path> removed;
+  // Values both have, that differ. A value that changed as a whole, like an object that became an
+  // array or a number, is reported instead of the values below it.
+  std::vector<Path> changed;
+
+  bool empty() const noexcept { return added.empty() && removed.empty() && changed.empty(); }
+};
+
+/**
+ * @brief Finds the values that were added, removed and changed from before to after.
+ *
+ * Members of objects are matched by their key and elements of arrays by their position, values
+ * are compared like Node::operator== does. Containers with equal hashes are skipped without
+ * looking into them, see Node::hash(), so diffing two versions of a tree costs hashing the one that
+ * isn't hashed yet plus walking the paths to the differences. Scalars with equal hashes are
+ * compared as well. Numbers only hash alike if they are equal, integers too large for a double
+ * included, so a change below a container is only missed if the 64 bit hashes of two different
+ * containers collide by chance.
+ */
+SOURCERER_API Diff diff(const Node& before, const Node& after);
+
+}  // namespace sourcerer
@@ -0,0 +1,127 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "sourcerer/common.hpp"
+
+namespace sourcerer {
+
+// Why an access or conversion of the non-throwing API failed.
+enum class errc : std::uint8_t {
+  // The node isn't the container or value the operation needs.
+  wrong_type = 1,
+  key_not_found,
+  index_out_of_range,
+  // There is no conversion between the two types.
+  not_convertible,
+  // A number isn't representable in the requested type.
+  out_of_range,
+  // A string isn't a number of the requested type.
+  invalid_number,
+};
+
+/**
+ * @brief An error of the non-throwing API, see Node::try_at() and Node::try_as().
+ *
+ * Errors only store their code and the static names of the types involved, so reporting one
+ * allocates nothing. The message is formatted when it's asked for. It doesn't repeat the key or
+ * index that wasn't found, the caller has it.
+ */
+class SOURCERER_API error {
+ public:
+  constexpr error(const errc code, const char* from = "", const char* to = "") noexcept
+      : code_{code}, from_{from}, to_{to} {}
+
+  constexpr errc code() const noexcept { return code_; }
+
+  // The message the throwing API would report.
+  std::string message() const;
+
+  // Throws the exception the throwing API throws for this error: std::out_of_range for missing
+  // keys and indices and numbers out of range, std::invalid_argument for the others.
+  [[noreturn]] void raise() const;
+
+  constexpr bool operator==(const error& other) const noexcept { return code_ == other.code_; }
+  constexpr bool operator==(const errc code) const noexcept { return code_ == code; }
+
+ private:
+  errc code_;
+  // The kind of node or type converted from, and the type converted to.
+  const char* from_;
+  const char* to_;
+};
+
+/**
+ * @brief Either a T or the error that kept it from being produced, like C++23's std::expected.
+ *
+ * T may be an lvalue reference, which is stored as a pointer. Reading the value of a result
+ * holding an error raises the error.
+ */
+template <class T>
+class result {
+  using stored = std::conditional_t<std::is_reference_v<T>, std::remove_reference_t<T>*, T>;
+
+ public:
+  using value_type = T;
+  using error_type = sourcerer::error;
+
+  result(T value)
+    requires std::is_reference_v<T>
+      : storage_{std::in_place_index<0>, &value} {}
+  result(T value)
+    requires(!std::is_reference_v<T>)
+      : storage_{std::in_place_index<0>, std::move(value)} {}
+  result(const sourcerer::error& error) noexcept : storage_{std::in_place_index<1>, error} {}
+
+  bool has_value() const noexcept { return storage_.index() == 0; }
+  explicit operator bool() const noexcept { return has_value(); }
+
+  decltype(auto) value() & { return checked(*this); }
+  decltype(auto) value() const& { return checked(*this); }
+  decltype(auto) value() && {
+    if constexpr (std::is_reference_v<T>) {
+      return checked(*this);
+    } else {
+      return std::move(checked(*this));
+    }
+  }
+
+  decltype(auto) operator*() & noexcept { return unchecked(*this); }
+  decltype(auto) operator*() const& noexcept { return unchecked(*this); }
+  auto* operator->() noexcept { return &unchecked(*this); }
+  const auto* operator->() const noexcept { return &unchecked(*this); }
+
+  // The value, or fallback converted to T if there is none.
+  template <class U>
+  std::remove_cvref_t<T> value_or(U&& fallback) const& {
+    if (has_value()) return unchecked(*this);
+    return static_cast<std::remove_cvref_t<T>>(std::forward<U>(fallback));
+  }
+
+  // The error, only valid if there is no value.
+  const sourcerer::error& error() const noexcept { return *std::get_if<1>(&storage_); }
+
+ private:
+  template <class Self>
+  static decltype(auto) unchecked(Self& self) noexcept {
+    if constexpr (std::is_reference_v<T>) {
+      return static_cast<T>(**std::get_if<0>(&self.storage_));
+    } else {
+      return *std::get_if<0>(&self.storage_);
+    }
+  }
+
+  template <class Self>
+  static decltype(auto) checked(Self& self) {
+    if (!self.has_value()) self.error().raise();
+    return unchecked(self);
+  }
+
+  std::variant<stored, sourcerer::error> storage_;
+};
+
+}  // namespace sourcerer
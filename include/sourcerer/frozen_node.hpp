@@ -0,0 +1,203 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/detail/helpers.hpp"
+#include "sourcerer/detail/magic_cast.hpp"
+#include "sourcerer/detail/type_name.hpp"
+#include "sourcerer/key_pool.hpp"
+#include "sourcerer/node.hpp"
+
+namespace sourcerer {
+
+namespace detail {
+
+// A key of a frozen object and the position of its value among the children.
+struct frozen_slot {
+  Key key;
+  std::uint32_t hash;
+  std::uint32_t index;
+};
+
+// The lookup table of a frozen object. The first keys with distinct hashes are placed by a
+// perfect_hash, the rare keys whose hash collides with one of them follow after those and are
+// scanned.
+struct frozen_table {
+  const std::uint32_t* displacements;
+  const frozen_slot* slots;
+  std::uint32_t buckets;
+  // The number of slots placed by the perfect hash, all slots if no perfect hash could be built.
+  std::uint32_t placed;
+};
+
+}  // namespace detail
+
+/**
+ * @brief A node of a FrozenTree, the read-only form of a Node.
+ *
+ * Offers the reading part of the Node API. Children are laid out next to each other, so iterating
+ * a container walks contiguous memory and the iterators are plain pointers. Looking up a key is one
+ * hash, one probe of the object's perfect hash table and one compare. Looking up a Key interned in
+ * the pool of the source tree skips hashing, and the compare is one of handles.
+ *
+ * FrozenNodes are views into their tree and only valid as long as it is.
+ */
+class SOURCERER_API FrozenNode {
+ public:
+  using value_type = FrozenNode;
+  using const_reference = const FrozenNode&;
+  using reference = const_reference;
+  using difference_type = std::ptrdiff_t;
+  using size_type = std::size_t;
+  using key_type = Key;
+
+  // Containers iterate over their children, values over themselves and null over nothing.
+  using const_iterator = const FrozenNode*;
+  using iterator = const_iterator;
+
+  constexpr bool is_null() const noexcept { return kind_ == detail::node_kind::null; }
+  constexpr bool is_value() const noexcept { return detail::is_scalar(kind_); }
+  constexpr bool is_object() const noexcept { return kind_ == detail::node_kind::object; }
+  constexpr bool is_array() const noexcept { return kind_ == detail::node_kind::array; }
+
+  constexpr bool is_string() const noexcept { return kind_ == detail::node_kind::string; }
+  constexpr bool is_bool() const noexcept { return kind_ == detail::node_kind::boolean; }
+  constexpr bool is_integer() const noexcept {
+    return kind_ == detail::node_kind::integer || kind_ == detail::node_kind::unsigned_integer;
+  }
+  constexpr bool is_floating() const noexcept { return kind_ == detail::node_kind::floating; }
+  constexpr bool is_number() const noexcept { return is_integer() || is_floating(); }
+
+  template <class T>
+  constexpr bool is() const noexcept {
+    if constexpr (std::is_same_v<T, Node::value_t>) {
+      return is_value();
+    } else {
+      return kind_ == detail::kind_of<T>;
+    }
+  }
+
+  const_reference at(const size_type index) const;
+  const_reference at(std::string_view key) const;
+  const_reference at(const key_type& key) const;
+
+  // Unchecked, like the const operator[] of Node: the index or key must exist.
+  const_reference operator[](const size_type index) const noexcept;
+  const_reference operator[](std::string_view key) const noexcept;
+  const_reference operator[](const key_type& key) const noexcept;
+
+  // Returns the value of key, or nullptr if the object doesn't have it.
+  const FrozenNode* find(std::string_view key) const;
+  const FrozenNode* find(const key_type& key) const;
+
+  bool contains(std::string_view key) const { return find(key) != nullptr; }
+
+  size_type size() const noexcept;
+  bool empty() const noexcept { return size() == 0; }
+
+  // Converts the value like Node::as() does.
+  template <typename T>
+  T as() const {
+    switch (kind_) {
+      case detail::node_kind::null:
+        return detail::magic_cast<T>(Node::null_t{});
+      case detail::node_kind::boolean:
+        return detail::magic_cast<T>(payload_.boolean);
+      case detail::node_kind::integer:
+        return detail::magic_cast<T>(payload_.integer);
+      case detail::node_kind::unsigned_integer:
+        return detail::magic_cast<T>(payload_.unsigned_integer);
+      case detail::node_kind::floating:
+        return detail::magic_cast<T>(payload_.floating);
+      case detail::node_kind::string:
+        return detail::magic_cast<T>(std::string_view{payload_.string, size_});
+      default:
+        SOURCERER_THROW(std::invalid_argument("Can't convert a frozen " + detail::type_name(kind_) +
+                                              " to " + detail::type_name<T>()));
+    }
+  }
+
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept { return begin() + size(); }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+ private:
+  friend class FrozenTree;
+
+  template <class K>
+  const FrozenNode* find(const K& key, const std::uint32_t hash) const noexcept;
+
+  union Payload {
+    bool boolean;
+    std::int64_t integer;
+    std::uint64_t unsigned_integer;
+    double floating;
+    const char* string;
+    const FrozenNode* children;
+  };
+
+  Payload payload_{};
+  // The table of an object, nullptr for other nodes.
+  const detail::frozen_table* table_ = nullptr;
+  // The size of a string or the number of children of a container.
+  std::uint32_t size_ = 0;
+  detail::node_kind kind_ = detail::node_kind::null;
+};
+
+/**
+ * @brief An immutable, contiguous copy of a Node tree, built for lookups.
+ *
+ * Trees that are only read after loading them pay for the mutable representation on every lookup.
+ * Freezing one compiles it into a few flat buffers: all nodes in one array, with the children of
+ * each container next to each other, all strings in another, plus a minimal perfect hash table per
+ * object. Objects keep referring to their interned keys, the tree holds on to their KeyPools.
+ *
+ * A FrozenTree can be moved but not copied. Moving it keeps all of its nodes in place.
+ */
+class SOURCERER_API FrozenTree {
+ public:
+  explicit FrozenTree(const Node& node);
+
+  FrozenTree(const FrozenTree&) = delete;
+  FrozenTree& operator=(const FrozenTree&) = delete;
+  FrozenTree(FrozenTree&&) noexcept = default;
+  FrozenTree& operator=(FrozenTree&&) noexcept = default;
+
+  const FrozenNode& root() const noexcept { return nodes_.front(); }
+
+  // The number of bytes the tree uses for its nodes, tables and strings.
+  std::size_t bytes() const noexcept;
+
+ private:
+  struct Sizes;
+  // State that is only needed while freezing.
+  struct Scratch;
+
+  static void count(const Node& node, Sizes& sizes);
+
+  void freeze(FrozenNode& target, const Node& node, Scratch& scratch);
+  void freeze_object(FrozenNode& target, const Node::object_t& object, Scratch& scratch);
+  // Copies text into strings_.
+  const char* store(std::string_view text);
+
+  // All buffers are reserved up front and never reallocate, they point into each other.
+  std::vector<FrozenNode> nodes_;
+  std::vector<detail::frozen_table> tables_;
+  std::vector<detail::frozen_slot> slots_;
+  std::vector<std::uint32_t> displacements_;
+  std::vector<char> strings_;
+  std::vector<std::shared_ptr<KeyPool>> pools_;
+};
+
+// Compiles node into a FrozenTree.
+SOURCERER_API FrozenTree freeze(const Node& node);
+
+}  // namespace sourcerer
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <compare>
+#include <cstdint>
+#include <functional>
+#include <memory_resource>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+
+namespace sourcerer {
+
+class KeyPool;
+
+/**
+ * @brief A handle to a key interned in a KeyPool.
+ *
+ * A Key is the size of a pointer and carries the hash of its text. Keys of the same pool are equal
+ * exactly if they are the same handle, so comparing them is a single integer compare. Keys of
+ * different pools fall back to comparing their text. A Key is valid for as long as its pool is.
+ */
+class Key {
+ public:
+  std::string_view view() const noexcept { return {entry_->data(), entry_->size}; }
+  operator std::string_view() const noexcept { return view(); }
+
+  std::size_t size() const noexcept { return entry_->size; }
+  std::uint32_t hash() const noexcept { return entry_->hash; }
+  // The pool the key was interned in.
+  const KeyPool* pool() const noexcept { return entry_->pool; }
+
+  // The hash every key is stored and looked up with.
+  static std::uint32_t hash(std::string_view key) noexcept {
+    return static_cast<std::uint32_t>(std::hash<std::string_view>{}(key));
+  }
+
+  friend bool operator==(const Key& lhs, const Key& rhs) noexcept {
+    if (lhs.entry_ == rhs.entry_) return true;
+    return lhs.pool() != rhs.pool() && lhs.hash() == rhs.hash() && lhs.view() == rhs.view();
+  }
+  friend bool operator==(const Key& lhs, std::string_view rhs) noexcept {
+    return lhs.view() == rhs;
+  }
+  friend std::strong_ordering operator<=>(const Key& lhs, const Key& rhs) noexcept {
+    return lhs.view() <=> rhs.view();
+  }
+
+ private:
+  friend class KeyPool;
+
+  // The text of a key directly follows its entry.
+  struct Entry {
+    const KeyPool* pool;
+    std::uint32_t hash;
+    std::uint32_t size;
+
+    const char* data() const noexcept { return reinterpret_cast<const char*>(this + 1); }
+  };
+
+  explicit Key(const Entry* entry) noexcept : entry_{entry} {}
+
+  const Entry* entry_;
+};
+
+/**
+ * @brief Interns object keys, so every distinct key is stored only once.
+ *
+ * Configurations repeat the same few hundred keys across thousands of objects. The objects of a
+ * sourced tree share one pool and only store Key handles into it, which also makes copying them
+ * cheaper. Every object holds on to its pool through a std::shared_ptr, copies into other memory
+ * resources included, so the pool lives as long as any of them.
+ *
+ * Keys are never removed from a pool. Interning is thread safe, lookups through a Key don't touch
+ * the pool at all.
+ */
+class SOURCERER_API KeyPool {
+ public:
+  explicit KeyPool(std::pmr::memory_resource* upstream = std::pmr::get_default_resource());
+
+  KeyPool(const KeyPool&) = delete;
+  KeyPool& operator=(const KeyPool&) = delete;
+
+  // Returns the Key of key, adding it to the pool if it isn't part of it yet.
+  Key intern(std::string_view key);
+  // The same, for a key whose hash is already known.
+  Key intern(std::string_view key, const std::uint32_t hash);
+
+  // Returns the Key of key, if it is part of the pool.
+  std::optional<Key> find(std::string_view key) const;
+
+  // The number of distinct keys in the pool.
+  std::size_t size() const;
+  // The number of bytes used for the keys, including their entries but not the lookup table.
+  std::size_t bytes() const;
+
+ private:
+  // Returns the slot of key in table_, which is empty if the key isn't part of the pool.
+  std::size_t slot_of(std::string_view key, const std::uint32_t hash) const noexcept;
+  void grow();
+
+  mutable std::mutex mutex_;
+  std::pmr::monotonic_buffer_resource arena_;
+  // Open addressing table of the entries in arena_, nullptr marks an empty slot.
+  std::pmr::vector<const Key::Entry*> table_;
+  std::size_t size_ = 0;
+  std::size_t bytes_ = 0;
+};
+
+}  // namespace sourcerer
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/conjurers/conjurer.hpp"
+#include "sourcerer/node.hpp"
+#include "sourcerer/thread_pool.hpp"
+
+namespace sourcerer {
+
+/**
+ * @brief The outcome of loading one source: its tree, or the exception that loading it threw.
+ */
+class SOURCERER_API Loaded {
+ public:
+  bool ok() const noexcept { return !error_; }
+  explicit operator bool() const noexcept { return ok(); }
+
+  // The tree. Rethrows the exception of the source if loading it failed.
+  const Node& value() const&;
+  Node&& value() &&;
+
+  // Empty if loading the source succeeded.
+  std::exception_ptr error() const noexcept { return error_; }
+
+ private:
+  friend class Loader;
+
+  Node node_;
+  std::exception_ptr error_;
+};
+
+/**
+ * @brief Loads many sources at once, conjuring and parsing them concurrently.
+ *
+ * A source is a conjurer and the parser that turns what it conjures into a tree, usually by
+ * constructing a sourcerer from it. load() runs one task per source, which conjures and parses it,
+ * on an Executor, and waits for all of them. So loading takes about as long as the slowest source,
+ * or the sum of the sources divided by the number of threads, instead of the sum of the sources.
+ *
+ * Without an executor a ThreadPool with a thread per core, but not more threads than sources, is
+ * started for every load(). An executor that is given must outlive the loader, and load() must not
+ * be called from one of its tasks if it runs them on a bounded number of threads: the tasks of the
+ * loader could wait for the thread that waits for them.
+ *
+ * The results are in the order the sources were added, whatever order they finished in. A source
+ * that fails doesn't affect the others, its Loaded holds the exception. The conjurers must outlive
+ * the loader, and each one is only used by one thread at a time.
+ */
+class SOURCERER_API Loader {
+ public:
+  // Turns a conjurer into a tree.
+  using parser = std::function<Node(Conjurer& conjurer)>;
+
+  // Parses the conjured text as JSON, with JsonSourcerer.
+  static Node parse_json(Conjurer& conjurer);
+
+  Loader() = default;
+  explicit Loader(Executor& executor) : executor_{&executor} {}
+
+  // Adds a source and returns its position in the results.
+  std::size_t add(Conjurer& conjurer, parser parse = parse_json);
+
+  std::size_t size() const noexcept { return sources_.size(); }
+
+  // Loads all sources. Can be called again to reload them.
+  std::vector<Loaded> load() const;
+
+ private:
+  struct Source {
+    Conjurer* conjurer;
+    parser parse;
+  };
+
+  // Runs the tasks on executor and returns once they are done.
+  void run(Executor& executor, std::vector<Loaded>& results) const;
+
+  Executor* executor_ = nullptr;
+  std::vector<Source> sources_;
+};
+
+}  // namespace sourcerer
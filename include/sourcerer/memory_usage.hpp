@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+
+namespace sourcerer {
+
+class Node;
+
+// The bytes a tree occupies, by what they hold. See Node::memory_usage().
+struct MemoryUsage {
+  // The nodes themselves: the root, and the children stored by value in the containers.
+  std::size_t nodes = 0;
+  // The key handles of the objects and the key pools they intern their keys in.
+  std::size_t keys = 0;
+  // Strings too long to be stored in their node.
+  std::size_t values = 0;
+  // The blocks of the containers, their unused capacity, the hashes and lookup indices of objects
+  // and the numbers of arrays cached by Node::numbers().
+  std::size_t containers = 0;
+
+  std::size_t total() const noexcept { return nodes + keys + values + containers; }
+
+  MemoryUsage& operator+=(const MemoryUsage& other) noexcept {
+    nodes += other.nodes;
+    keys += other.keys;
+    values += other.values;
+    containers += other.containers;
+    return *this;
+  }
+
+  bool operator==(const MemoryUsage& other) const = default;
+};
+
+// The memory usage of the subtree at path, see memory_usage_by_path().
+struct SubtreeUsage {
+  std::string path;
+  MemoryUsage usage;
+};
+
+/**
+ * @brief The memory usage of every subtree of root down to depth levels, largest first, to find
+ * the ones that blow up a tree.
+ *
+ * Paths are written like Path parses them, the root's children are at depth 1. Every subtree is
+ * measured on its own, so containers a subtree shares with another one count towards both, and a
+ * subtree's usage includes its own node. The key pools objects share with the rest of the tree
+ * only count towards the root, only their key handles count towards the subtrees.
+ */
+SOURCERER_API std::vector<SubtreeUsage> memory_usage_by_path(const Node& root,
+                                                             const std::size_t depth = 1);
+
+}  // namespace sourcerer
@@ -1,25 +1,55 @@
 #pragma once
 
-#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <iterator>
 #include <memory>
+#include <memory_resource>
+#include <span>
 #include <string>
-#include <variant>
+#include <string_view>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "sourcerer/common.hpp"
 #include "sourcerer/detail/concepts.hpp"
+#include "sourcerer/detail/helpers.hpp"
 #include "sourcerer/detail/magic_cast.hpp"
 #include "sourcerer/detail/node_iterator.hpp"
+#include "sourcerer/detail/object_view.hpp"
+#include "sourcerer/detail/packed_numbers.hpp"
+#include "sourcerer/detail/shared_block.hpp"
 #include "sourcerer/detail/type_name.hpp"
+#include "sourcerer/error.hpp"
+#include "sourcerer/memory_usage.hpp"
 
 namespace sourcerer {
 
+/**
+ * @brief A node of a configuration tree: null, a scalar value, an array or an object.
+ *
+ * Arrays and objects are shared copy-on-write. Copying a node is O(1) if its memory resource
+ * outlives the copy, as the new_delete_resource() and the arenas of the sourcerers do, and writing
+ * to a copy only clones the containers on the path to the change. Reading through a const node
+ * never clones anything, while handing out a mutable reference or iterator into a container makes
+ * later copies of it deep.
+ */
 class SOURCERER_API Node {
  private:
   template <detail::basic_node NodeType>
   friend class detail::iter_impl;
+  friend class Binder;
+  friend class Differ;
+  friend class FrozenTree;
+  friend class LayeredSourcerer;
+  friend class MemoryCounter;
+  friend class Path;
+  friend class ReloadingSourcerer;
+  friend class Snapshot;
 
  public:
   // the type of elements in a Node container
@@ -36,6 +66,7 @@ class SOURCERER_API Node {
   // a type to represent container sizes
   using size_type = std::size_t;
 
+  // a handle to a key interned in the KeyPool of an object
   using key_type = detail::key_t;
 
   using null_t = detail::null_t;
@@ -43,8 +74,11 @@ class SOURCERER_API Node {
   using array_t = detail::array_t;
   using object_t = detail::object_t;
 
-  // the allocator type
-  using allocator_type = std::allocator<Node>;
+  // the order object keys are iterated in, see Node::object_t
+  using key_order = detail::key_order;
+
+  // the allocator type, every child, key and value of a tree is allocated through it
+  using allocator_type = std::pmr::polymorphic_allocator<Node>;
 
   // the type of an element pointer
   using pointer = typename std::allocator_traits<allocator_type>::pointer;
@@ -53,11 +87,17 @@ class SOURCERER_API Node {
 
   // an iterator for a Node container
   using iterator = detail::iter_impl<Node>;
-  static_assert(std::bidirectional_iterator<iterator>);
 
   // a const iterator for a Node container
   using const_iterator = detail::iter_impl<const Node>;
-  static_assert(std::bidirectional_iterator<const_iterator>);
+
+  // a typed view of the elements of an array
+  using array_view = std::span<Node>;
+  using const_array_view = std::span<const Node>;
+
+  // a typed view of the members of an object, iterated as (key, value) pairs
+  using object_view = detail::object_view<Node>;
+  using const_object_view = detail::object_view<const Node>;
 
   // a reverse iterator for a Node container
   // using reverse_iterator = detail::reverse_iterator<typename Node::iterator>;
@@ -65,120 +105,274 @@ class SOURCERER_API Node {
   // using const_reverse_iterator = detail::reverse_iterator<typename Node::const_iterator>;
 
   Node() = default;
-  ~Node() = default;
+  ~Node();
 
-  explicit Node(const null_t& value);
-  explicit Node(const value_t& value);
-  explicit Node(const array_t& value);
-  explicit Node(const object_t& value);
+  explicit Node(const allocator_type& alloc);
+
+  explicit Node(const null_t& value, const allocator_type& alloc = {});
+  explicit Node(const value_t& value, const allocator_type& alloc = {});
+  explicit Node(const array_t& value, const allocator_type& alloc = {});
+  explicit Node(const object_t& value, const allocator_type& alloc = {});
   Node(const Node& other);
+  Node(const Node& other, const allocator_type& alloc);
 
+  // The rvalue constructors adopt the allocator of the moved from container.
   explicit Node(null_t&& value);
   explicit Node(value_t&& value);
   explicit Node(array_t&& value);
   explicit Node(object_t&& value);
-  Node(Node&& other) = default;
+  Node(Node&& other) noexcept;
+
+  // With an allocator, the container or node is moved if it uses the same memory resource and
+  // copied otherwise.
+  Node(value_t&& value, const allocator_type& alloc);
+  Node(array_t&& value, const allocator_type& alloc);
+  Node(object_t&& value, const allocator_type& alloc);
+  Node(Node&& other, const allocator_type& alloc);
 
-  explicit Node(const Node* parent);
-  Node(const Node* parent, const null_t& value);
-  Node(const Node* parent, const value_t& value);
-  Node(const Node* parent, const array_t& value);
-  Node(const Node* parent, const object_t& value);
-  Node(const Node* parent, const Node& other);
+  // Scalars are stored natively: strings as values, bools as bools, signed and unsigned integers
+  // as 64 bit integers of the same signedness and floating point numbers as doubles.
+  template <class T>
+    requires std::convertible_to<const T&, std::string_view> && (!std::same_as<T, value_t>)
+  explicit Node(const T& value, const allocator_type& alloc = {}) : Node(alloc) {
+    set_string(value);
+  }
+
+  template <std::same_as<bool> T>
+  explicit Node(const T value, const allocator_type& alloc = {}) : Node(alloc) {
+    set_scalar(value, detail::node_kind::boolean);
+  }
+
+  template <detail::number T>
+  explicit Node(const T value, const allocator_type& alloc = {}) : Node(alloc) {
+    if constexpr (std::is_floating_point_v<T>) {
+      set_scalar(static_cast<double>(value), detail::node_kind::floating);
+    } else if constexpr (std::is_signed_v<T>) {
+      set_scalar(static_cast<std::int64_t>(value), detail::node_kind::integer);
+    } else {
+      set_scalar(static_cast<std::uint64_t>(value), detail::node_kind::unsigned_integer);
+    }
+  }
+
+  allocator_type get_allocator() const noexcept { return resource_; }
 
   constexpr bool is_null() const noexcept { return is<null_t>(); }
   constexpr bool is_value() const noexcept { return is<value_t>(); }
   constexpr bool is_object() const noexcept { return is<object_t>(); }
   constexpr bool is_array() const noexcept { return is<array_t>(); }
 
+  // The kinds of values, a value is exactly one of these.
+  constexpr bool is_string() const noexcept { return kind_ == detail::node_kind::string; }
+  constexpr bool is_bool() const noexcept { return kind_ == detail::node_kind::boolean; }
+  constexpr bool is_integer() const noexcept {
+    return kind_ == detail::node_kind::integer || kind_ == detail::node_kind::unsigned_integer;
+  }
+  constexpr bool is_floating() const noexcept { return kind_ == detail::node_kind::floating; }
+  constexpr bool is_number() const noexcept { return is_integer() || is_floating(); }
+
+  // is<value_t>() holds for every value, whichever kind of scalar it stores.
   template <class T>
   constexpr bool is() const noexcept {
-    return std::holds_alternative<T>(children_);
+    if constexpr (std::is_same_v<T, value_t>) {
+      return detail::is_scalar(kind_);
+    } else {
+      return kind_ == detail::kind_of<T>;
+    }
   }
 
-  auto parent() const noexcept { return parent_; }
-  bool has_parent() const noexcept { return parent_ != nullptr; }
+  // Nodes don't store a link to their parent, so it's looked up by walking this subtree.
+  // Returns nullptr if descendant isn't a child of this node or any of its children.
+  const Node* find_parent(const Node& descendant) const noexcept;
+
+  // The children of an array or object, nullptr if there is no such child or the node isn't a
+  // container of the right kind. Unlike at(), these never throw.
+  const Node* find(const size_type index) const noexcept;
+  const Node* find(std::string_view key) const noexcept;
+  const Node* find(const key_type& key) const noexcept;
+
+  // Whether the node is an object with a member key.
+  bool contains(std::string_view key) const noexcept { return find(key) != nullptr; }
+  bool contains(const key_type& key) const noexcept { return find(key) != nullptr; }
+
+  // The non-throwing at(), returns the error instead: errc::wrong_type if the node isn't a
+  // container of the right kind, errc::index_out_of_range or errc::key_not_found if there is no
+  // such child.
+  result<const Node&> try_at(const size_type index) const noexcept;
+  result<const Node&> try_at(std::string_view key) const noexcept;
+  result<const Node&> try_at(const key_type& key) const noexcept;
 
   reference at(const size_type index);
   const_reference at(const size_type index) const;
 
+  reference at(std::string_view key);
+  const_reference at(std::string_view key) const;
+
+  // Looking up a key interned in the pool of the object only compares handles.
   reference at(const key_type& key);
   const_reference at(const key_type& key) const;
 
   reference operator[](const size_type index);
   const_reference operator[](const size_type index) const;
 
+  reference operator[](std::string_view key);
+  const_reference operator[](std::string_view key) const;
+
   reference operator[](const key_type& key);
   const_reference operator[](const key_type& key) const;
 
-  void push_back(const Node& node);
+  // The pool the keys of this object are interned in, to look them up by key_type. Objects of a
+  // sourced tree share one. Returns nullptr for an object without keys, throws for other nodes.
+  std::shared_ptr<KeyPool> keys() const;
+
+  // The modifiers take nodes by value category: copies share their containers, moved from nodes
+  // hand over their subtree if they share the memory resource of this node. Any other arguments
+  // construct the new child in place, from them and the allocator of this node. Apart from
+  // cloning shared containers, they only allocate what they insert: room for new children if the
+  // container is full, large strings and new keys. Errors are formatted once they are thrown.
+  void push_back(const Node& node) { append<false>("push_back", node); }
+  void push_back(Node&& node) { append<false>("push_back", std::move(node)); }
 
   template <class T>
-  void push_back(const T& value) {
-    push_back(Node{detail::magic_cast(value)});
+    requires(!std::same_as<std::remove_cvref_t<T>, Node>)
+  void push_back(T&& value) {
+    append<false>("push_back", std::forward<T>(value));
   }
 
-  void emplace_back(const Node& node);
-
-  template <class T>
-  void emplace_back(const T& value) {
-    emplace_back(Node{detail::magic_cast(value)});
+  template <class... Args>
+  reference emplace_back(Args&&... args) {
+    return append<true>("emplace_back", std::forward<Args>(args)...);
   }
 
   void erase(const size_type index);
-  void erase(const key_type& key);
+  void erase(std::string_view key);
 
   size_type size() const noexcept;
   bool empty() const noexcept;
   void clear();
 
-  void insert(const size_type index, const Node& node);
+  // Reserves room for size children in an array or object.
+  void reserve(const size_type size);
+  // The number of children an array or object has room for, zero for other nodes.
+  size_type capacity() const noexcept;
 
-  template <class T>
-  void insert(const size_type index, const T& value) {
-    insert(index, Node{detail::magic_cast(value)});
+  void insert(const size_type index, const Node& node) {
+    insert_at<false>("insert with index", index, node);
+  }
+  void insert(const size_type index, Node&& node) {
+    insert_at<false>("insert with index", index, std::move(node));
   }
-
-  void emplace(const size_type index, const Node& node);
 
   template <class T>
-  void emplace(const size_type index, const T& value) {
-    emplace(index, Node{detail::magic_cast(value)});
+    requires(!std::same_as<std::remove_cvref_t<T>, Node>)
+  void insert(const size_type index, T&& value) {
+    insert_at<false>("insert with index", index, std::forward<T>(value));
   }
 
-  void insert(const key_type& key, const Node& node);
-
-  template <class T>
-  void insert(const key_type& key, const T& value) {
-    insert(key, Node{detail::magic_cast(value)});
+  template <class... Args>
+  reference emplace(const size_type index, Args&&... args) {
+    return insert_at<true>("emplace with index", index, std::forward<Args>(args)...);
   }
 
-  void emplace(const key_type& key, const Node& node);
+  // Inserting with a key that is already present leaves its value untouched.
+  void insert(std::string_view key, const Node& node) {
+    insert_with<false>("insert with key", key, node);
+  }
+  void insert(std::string_view key, Node&& node) {
+    insert_with<false>("insert with key", key, std::move(node));
+  }
 
   template <class T>
-  void emplace(const key_type& key, const T& value) {
-    emplace(key, Node{detail::magic_cast(value)});
+    requires(!std::same_as<std::remove_cvref_t<T>, Node>)
+  void insert(std::string_view key, T&& value) {
+    insert_with<false>("insert with key", key, std::forward<T>(value));
+  }
+
+  template <class... Args>
+  reference emplace(std::string_view key, Args&&... args) {
+    return insert_with<true>("emplace with key", key, std::forward<Args>(args)...);
   }
 
   reference operator=(const Node& other);
-  reference operator=(Node&& other) = default;
+  reference operator=(Node&& other);
 
   template <class T>
-  reference operator=(const T& value) {
-    return operator=(Node{detail::magic_cast(value)});
+    requires(!std::same_as<std::remove_cvref_t<T>, Node>)
+  reference operator=(T&& value) {
+    return operator=(Node{std::forward<T>(value), resource_});
   }
 
+  // Containers compare their hashes first, so unequal trees usually differ in O(1) once hashed,
+  // and only equal ones are compared element by element.
   bool operator==(const Node& other) const;
 
+  // A 64 bit hash of the content of the tree, equal for equal trees: numbers hash by value like
+  // they compare, and objects regardless of the order of their keys. Containers cache their hash,
+  // and writing to one invalidates it, so rehashing a changed tree only hashes the containers on
+  // the path to the changes. Containers that handed out a mutable reference or iterator can be
+  // changed behind their back and are hashed anew every time.
+  std::uint64_t hash() const noexcept;
+
+  // The bytes the tree occupies, by what they hold. Containers shared by several nodes of the tree
+  // and key pools shared by several objects count once. Memory resources may round allocations up
+  // and arenas keep some memory in reserve, which isn't counted.
+  MemoryUsage memory_usage() const;
+
   void swap(Node& other) noexcept;
 
+  // Reading a value as the type it's stored as is a load, other types are converted. Numbers are
+  // converted if they are representable in T and formatted for strings, strings are parsed.
+  // Arrays are read as a std::vector of their elements, each converted the same way.
   template <typename T>
   T as() const {
-    return std::visit([](const auto& arg) { return detail::magic_cast<T>(arg); }, children_);
+    if constexpr (detail::is_vector<T>) {
+      return as_vector<T>();
+    } else {
+      return try_as<T>().value();
+    }
+  }
+
+  // The non-throwing as<T>(), returns the error instead: errc::not_convertible if there is no
+  // conversion between the types, errc::out_of_range if a number isn't representable in T and
+  // errc::invalid_number if a string isn't a number. The first element that fails fails an array.
+  template <typename T>
+  result<T> try_as() const {
+    if constexpr (detail::is_vector<T>) {
+      return try_as_vector<T>();
+    } else {
+      switch (kind_) {
+        case detail::node_kind::boolean:
+          return detail::try_magic_cast<T>(payload<bool>());
+        case detail::node_kind::integer:
+          return detail::try_magic_cast<T>(payload<std::int64_t>());
+        case detail::node_kind::unsigned_integer:
+          return detail::try_magic_cast<T>(payload<std::uint64_t>());
+        case detail::node_kind::floating:
+          return detail::try_magic_cast<T>(payload<double>());
+        case detail::node_kind::string:
+          return detail::try_magic_cast<T>(string());
+        case detail::node_kind::array:
+          return detail::try_magic_cast<T>(block<array_t>()->value());
+        case detail::node_kind::object:
+          return detail::try_magic_cast<T>(block<object_t>()->value());
+        default:
+          return detail::try_magic_cast<T>(null_t{});
+      }
+    }
   }
 
-  iterator begin() noexcept;
-  iterator end() noexcept;
+  // The elements of an array as int64s or doubles, converted like as<T>() converts them, packed
+  // into a buffer the array keeps. So only the first call converts the elements, which parses
+  // numbers stored as text. The span is valid until the array is written to or destroyed. Arrays
+  // that handed out mutable references can be changed behind their back, so every call converts
+  // their elements again, in place.
+  template <detail::packed_number T>
+  std::span<const T> numbers() const {
+    return packed<T>().template values<T>();
+  }
+
+  // Mutable iterators unshare the container first, so they may allocate.
+  iterator begin();
+  iterator end();
 
   const_iterator begin() const noexcept;
   const_iterator end() const noexcept;
@@ -186,44 +380,196 @@ class SOURCERER_API Node {
   const_iterator cbegin() const noexcept;
   const_iterator cend() const noexcept;
 
+  // Typed views of the children of an array or object. The kind of the node is checked once, when
+  // the view is made, instead of on every step like the iterators of Node do. Null nodes give
+  // empty views, other kinds throw std::invalid_argument. The mutable views unshare the container
+  // and hand out mutable references into it, like the mutable iterators.
+  array_view as_array();
+  const_array_view as_array() const;
+  object_view as_object();
+  const_object_view as_object() const;
+
+  // The same as as_object(), for `for (const auto& [key, value] : node.items())`.
+  object_view items() { return as_object(); }
+  const_object_view items() const { return as_object(); }
+
   // std::string to_string() const {
   //   return std::visit([](auto&& arg) { return detail::convert_s(arg); }, children_);
   // }
 
  private:
-  void copy(const null_t&) { children_.emplace<null_t>(); }
-  void copy(const value_t& value) { children_.emplace<value_t>(value); }
-  void copy(const array_t& value) {
-    children_.emplace<array_t>();
-    std::get<array_t>(children_).reserve(value.size());
+  // Strings of up to this size are stored inline, their size lives in the last payload byte.
+  static constexpr std::size_t small_capacity = 14;
+  // Marks a string stored in a buffer allocated from the node's resource.
+  static constexpr unsigned char large_string = 0xff;
+
+  template <class T, std::size_t Offset = 0>
+  T payload() const noexcept {
+    T value;
+    std::memcpy(&value, data_.data() + Offset, sizeof(T));
+    return value;
+  }
 
-    std::ranges::transform(
-        value, std::back_inserter(std::get<array_t>(children_)),
-        [this](const auto& node) { return std::make_unique<Node>(this, *node); });
+  template <class T>
+  void set_payload(const T value) noexcept {
+    std::memcpy(data_.data(), &value, sizeof(T));
   }
-  void copy(const object_t& value) {
-    children_.emplace<object_t>();
 
-    for (const auto& [key, node] : value) {
-      std::get<object_t>(children_).try_emplace(key, std::make_unique<Node>(this, *node));
+  std::string_view string() const noexcept;
+  void set_string(std::string_view value);
+
+  template <class T>
+  void set_scalar(const T value, const detail::node_kind kind) noexcept {
+    reset();
+    set_payload(value);
+    kind_ = kind;
+  }
+
+  template <detail::child T>
+  detail::shared_block<T>* block() const noexcept {
+    return payload<detail::shared_block<T>*>();
+  }
+
+  // Hands out the container for writing, which leaks it: copies made from now on clone it.
+  template <detail::child T>
+  T& get() {
+    return mutate<T>(true);
+  }
+
+  template <detail::child T>
+  const T& get() const {
+    detail::throw_if_not(detail::kind_of<T>, kind_);
+    return block<T>()->value();
+  }
+
+  // Returns the container to change it, after cloning it into resource_ if it is shared or lives
+  // in another resource. Modifiers that don't hand out references into it don't leak it.
+  template <detail::child T>
+  T& mutate(const bool leak) {
+    detail::throw_if_not(detail::kind_of<T>, kind_);
+    if (auto* current = block<T>();
+        !current->unique() || current->value().get_allocator().resource() != resource_) {
+      unshare();
+    }
+
+    auto* current = block<T>();
+    current->invalidate();
+    if (leak) {
+      current->leak();
     }
+    return current->value();
   }
 
+  // Replaces a shared container with a copy in resource_ that only this node references.
+  void unshare();
+  // Sets the payload to a new, empty array or object.
+  void make_empty(const detail::node_kind kind);
+
+  // Turns a null node into an empty T, throws if the node holds anything else than a T.
   template <class T>
-  void prepare_for(const std::string& error_msg) {
+  void prepare_for(const char* operation) {
     if (!(is_null() || is<T>())) {
-      throw std::invalid_argument(error_msg);
+      SOURCERER_THROW(std::invalid_argument(std::string{"Can't "} + operation +
+                                            " on a node of type " + detail::type_name(kind_)));
     }
 
     if (is_null()) {
-      children_.emplace<T>();
+      make_empty(detail::kind_of<T>);
     }
   }
 
-  const Node* parent_ = nullptr;
-  std::variant<null_t, value_t, array_t, object_t> children_;
+  // operation names the public modifier in the error thrown for a node of another kind.
+  template <bool Leak, class... Args>
+  reference append(const char* operation, Args&&... args) {
+    prepare_for<array_t>(operation);
+    return mutate<array_t>(Leak).emplace_back(std::forward<Args>(args)...);
+  }
+
+  template <bool Leak, class... Args>
+  reference insert_at(const char* operation, const size_type index, Args&&... args) {
+    prepare_for<array_t>(operation);
+    auto& array = mutate<array_t>(Leak);
+    return *array.emplace(array.begin() + static_cast<difference_type>(index),
+                          std::forward<Args>(args)...);
+  }
+
+  template <bool Leak, class... Args>
+  reference insert_with(const char* operation, std::string_view key, Args&&... args) {
+    prepare_for<object_t>(operation);
+    return mutate<object_t>(Leak).try_emplace(key, std::forward<Args>(args)...).first->second;
+  }
 
-  static_assert(detail::basic_node<Node>);
+  template <class T>
+  T as_vector() const {
+    using value_type = typename T::value_type;
+    const auto& array = get<array_t>();
+    T result;
+    if constexpr (detail::packed_number<value_type>) {
+      if (const auto* packed = detail::packed_numbers::find<value_type>(
+              block<array_t>()->packed().load(std::memory_order_acquire));
+          packed != nullptr && !block<array_t>()->leaked()) {
+        const auto values = std::as_const(*packed).template values<value_type>();
+        result.assign(values.begin(), values.end());
+        return result;
+      }
+    }
+    result.reserve(array.size());
+    for (const auto& element : array) {
+      result.push_back(element.as<value_type>());
+    }
+    return result;
+  }
+
+  template <class T>
+  result<T> try_as_vector() const {
+    if (!is_array()) return error{errc::wrong_type, detail::kind_name(kind_)};
+
+    const auto& array = block<array_t>()->value();
+    T values;
+    values.reserve(array.size());
+    for (const auto& element : array) {
+      auto value = element.try_as<typename T::value_type>();
+      if (!value) return value.error();
+      values.push_back(*std::move(value));
+    }
+    return values;
+  }
+
+  // Returns the buffer of the numbers of an array, converting them on the first call.
+  template <detail::packed_number T>
+  detail::packed_numbers& packed() const;
+
+  // Compares two numbers of different kinds.
+  static bool equal_numbers(const Node& lhs, const Node& rhs) noexcept;
+  // Whether the hashes of two containers differ, which proves them unequal. Leaked containers
+  // aren't hashed for it, their hash isn't cached.
+  template <detail::child T>
+  bool hashes_differ(const Node& other) const noexcept {
+    if (block<T>()->leaked() || other.block<T>()->leaked()) return false;
+    return hash() != other.hash();
+  }
+
+  // Takes over the payload of other, which is left null. Both nodes must share a resource.
+  void steal(Node& other) noexcept;
+  // Releases the payload, leaving the node null.
+  void reset() noexcept;
+
+  // The payload depends on kind_: a bool, 64 bit integer or double, inline or out-of-line strings,
+  // or a pointer to the shared block of the array or object container. Strings and containers are
+  // allocated from resource_, except for blocks shared with a copy in another resource. Children
+  // are stored by value in the containers.
+  alignas(void*) std::array<char, small_capacity + 1> data_{};
+  detail::node_kind kind_ = detail::node_kind::null;
+  std::pmr::memory_resource* resource_ = std::pmr::get_default_resource();
 };
 
+// Children are stored by value, so these can only be checked once Node is complete.
+static_assert(detail::basic_node<Node>);
+static_assert(std::bidirectional_iterator<Node::array_t::iterator>);
+static_assert(std::bidirectional_iterator<Node::object_t::iterator>);
+static_assert(std::bidirectional_iterator<Node::iterator>);
+static_assert(std::bidirectional_iterator<Node::const_iterator>);
+static_assert(std::bidirectional_iterator<Node::object_view::iterator>);
+static_assert(std::bidirectional_iterator<Node::const_object_view::iterator>);
+
 }  // namespace sourcerer
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/key_pool.hpp"
+#include "sourcerer/node.hpp"
+
+namespace sourcerer {
+
+/**
+ * @brief Builds a Node tree bottom-up from a stream of events, like the ones of a SAX parser.
+ *
+ * Values are collected on a stack and each container is only assembled once all of its children
+ * are known. Arrays are allocated with their exact size, and children are moved into their parent,
+ * so no subtree is ever copied. Keys are interned in one KeyPool for the whole tree. Objects whose
+ * keys arrive in sorted order, as most serializers emit them, are built without looking up a
+ * single key.
+ *
+ * A key that appears more than once in an object keeps its last value.
+ */
+class SOURCERER_API NodeBuilder {
+ public:
+  using size_type = Node::size_type;
+
+  explicit NodeBuilder(const Node::allocator_type& alloc = {},
+                       std::shared_ptr<KeyPool> keys = std::make_shared<KeyPool>(),
+                       const Node::key_order order = Node::key_order::sorted);
+
+  void begin_array();
+  void end_array();
+
+  void begin_object();
+  void end_object();
+
+  // Sets the key of the next value of the current object.
+  void key(std::string_view key);
+  void key(const Key& key);
+
+  // Adds a value constructed from args and the allocator of the tree, a null one without args.
+  template <class... Args>
+  void value(Args&&... args) {
+    expect_value();
+    values_.emplace_back(std::forward<Args>(args)..., alloc_);
+  }
+
+  // Returns the tree and resets the builder. All containers must be closed again.
+  Node finish();
+
+  // The pool the keys of the tree are interned in.
+  const std::shared_ptr<KeyPool>& keys() const noexcept { return pool_; }
+
+ private:
+  struct Frame {
+    bool object;
+    // The positions of the first child in values_ and of its key in keys_.
+    size_type first_value;
+    size_type first_key;
+  };
+
+  // Throws if a value can't be added at this point.
+  void expect_value() const;
+  Frame pop_frame(const bool object);
+
+  Node::allocator_type alloc_;
+  std::shared_ptr<KeyPool> pool_;
+  Node::key_order order_;
+
+  // The values and keys of the containers that are still open, plus the finished root.
+  std::vector<Node> values_;
+  std::vector<Key> keys_;
+  std::vector<Frame> frames_;
+  // Reused to sort the keys of objects that didn't arrive sorted.
+  std::vector<size_type> permutation_;
+};
+
+}  // namespace sourcerer
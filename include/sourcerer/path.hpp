@@ -0,0 +1,159 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/node.hpp"
+
+namespace sourcerer {
+
+namespace detail {
+
+// One step of a compiled Path.
+struct path_step {
+  enum class kind : std::uint8_t { key, index, slice, wildcard };
+
+  kind type = kind::wildcard;
+  // The key and its hash, for key steps.
+  std::string key;
+  std::uint32_t hash = 0;
+  // The index for index steps, the bounds for slices. Negative values count from the end.
+  std::optional<std::int64_t> start;
+  std::optional<std::int64_t> stop;
+
+  bool operator==(const path_step& other) const = default;
+};
+
+// Called for every match, returns false to stop the traversal.
+using path_visitor = bool (*)(void* context, std::size_t path, const Node& node);
+
+// Append a step to the text of a path, like `.name`, `["na.me"]` or `[3]`. Keys that can't be
+// written bare are quoted.
+SOURCERER_API void append_key(std::string& path, std::string_view key);
+SOURCERER_API void append_index(std::string& path, std::size_t index);
+
+}  // namespace detail
+
+/**
+ * @brief A path into a Node tree, parsed once and evaluated against any number of trees.
+ *
+ * Paths are written like `servers[3].tls.cert`:
+ *  - `name` or `.name` selects the value of a key, `["na.me"]` one with any characters in it,
+ *    where `\"` and `\\` escape quotes and backslashes,
+ *  - `[3]` selects an element of an array, `[-1]` counts from the end,
+ *  - `[1:3]` selects a slice of an array, either bound may be left out or negative,
+ *  - `*` or `[*]` selects every child of an array or object.
+ * The empty path selects the root.
+ *
+ * The keys of a compiled path are hashed up front, evaluating it doesn't allocate. Steps that
+ * don't match the tree, like a key on an array or an index out of range, select nothing.
+ */
+class SOURCERER_API Path {
+ public:
+  // Throws std::invalid_argument if path isn't a valid path.
+  explicit Path(std::string_view path);
+
+  const std::string& str() const noexcept { return text_; }
+
+  // Whether the path selects at most one node, which is the case without wildcards and slices.
+  bool is_single() const noexcept { return single_; }
+
+  // Returns the first node the path selects in root, or nullptr if there is none.
+  const Node* find(const Node& root) const noexcept;
+  // The same, but throws std::out_of_range if there is none.
+  const Node& at(const Node& root) const;
+
+  // Calls fn with every node the path selects in root, in the order of the tree.
+  template <class Fn>
+  void for_each(const Node& root, Fn&& fn) const {
+    visit(root, steps_, 0, detail::path_visitor{&call<std::remove_reference_t<Fn>>},
+          const_cast<void*>(static_cast<const void*>(std::addressof(fn))));
+  }
+
+  bool operator==(const Path& other) const noexcept { return steps_ == other.steps_; }
+
+ private:
+  friend class PathSet;
+
+  template <class Fn>
+  static bool call(void* context, std::size_t /*path*/, const Node& node) {
+    (*static_cast<Fn*>(context))(node);
+    return true;
+  }
+
+  // Returns the node a key or index step selects in node, or nullptr if there is none.
+  static const Node* select(const detail::path_step& step, const Node& node) noexcept;
+  // Calls visitor with the nodes that step selects in node, stops once it returns false.
+  static bool apply(const detail::path_step& step, const Node& node, std::size_t path,
+                    detail::path_visitor visitor, void* context);
+  // Calls visitor with the nodes that steps select in node, stops once it returns false.
+  static bool visit(const Node& node, std::span<const detail::path_step> steps, std::size_t path,
+                    detail::path_visitor visitor, void* context);
+
+  std::string text_;
+  std::vector<detail::path_step> steps_;
+  bool single_ = true;
+};
+
+/**
+ * @brief A set of paths that are resolved together, in a single traversal of the tree.
+ *
+ * The paths are merged into a trie, so the steps they have in common are only taken once: resolving
+ * `servers[3].tls.cert` and `servers[3].tls.key` looks up `servers` and `[3]` and `tls` once.
+ */
+class SOURCERER_API PathSet {
+ public:
+  using size_type = std::size_t;
+
+  PathSet();
+  explicit PathSet(std::span<const std::string_view> paths);
+
+  // Adds path to the set and returns its position, which the results are reported by.
+  size_type add(const Path& path);
+  size_type add(std::string_view path) { return add(Path{path}); }
+
+  size_type size() const noexcept { return paths_.size(); }
+  const Path& operator[](const size_type index) const noexcept { return paths_[index]; }
+
+  // Sets results[i] to the first node path i selects in root, or nullptr if there is none.
+  // Throws std::invalid_argument if results doesn't have one entry per path.
+  void resolve(const Node& root, std::span<const Node*> results) const;
+
+  // Calls fn with the position of the path and the node for every node a path selects in root.
+  template <class Fn>
+  void for_each(const Node& root, Fn&& fn) const {
+    visit(root, 0, detail::path_visitor{&call<std::remove_reference_t<Fn>>},
+          const_cast<void*>(static_cast<const void*>(std::addressof(fn))));
+  }
+
+ private:
+  struct Trie {
+    detail::path_step step;
+    std::vector<size_type> children;
+    // The paths that end here.
+    std::vector<size_type> paths;
+  };
+
+  template <class Fn>
+  static bool call(void* context, const std::size_t path, const Node& node) {
+    (*static_cast<Fn*>(context))(path, node);
+    return true;
+  }
+
+  void visit(const Node& node, const size_type trie, detail::path_visitor visitor,
+             void* context) const;
+
+  std::vector<Path> paths_;
+  // The root of the trie is its first element, its step is unused.
+  std::vector<Trie> trie_;
+};
+
+}  // namespace sourcerer
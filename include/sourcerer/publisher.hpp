@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/node.hpp"
+
+namespace sourcerer {
+
+/**
+ * @brief Publishes versions of a tree to threads that read it while others replace it.
+ *
+ * A published tree is never changed again. Writers build the next version, usually by copying the
+ * current one, which is O(1), and changing the copy, or by taking source() of a sourcerer, and
+ * publish it with a single atomic store. Readers pin the current version for as long as they hold
+ * a Guard, which takes a fixed number of steps whatever the writers do, and don't lock anything or
+ * write to memory other readers touch.
+ *
+ * Replaced versions are reclaimed with epochs: every publication advances the epoch, and every
+ * Reader has a slot of its own where it announces the epoch it started reading in. A replaced
+ * version is destroyed once no slot holds an epoch from before it was replaced, by the next writer
+ * or reclaim(). So a reader that holds a Guard for long only delays freeing memory, never a writer,
+ * and readers never destroy a tree.
+ *
+ * Every thread that reads gets a Reader of its own from reader() and keeps it, it must not be used
+ * by two threads at once. Readers and guards must not outlive the publisher. Writers may publish
+ * from any thread, they are serialized.
+ */
+class SOURCERER_API Publisher {
+ public:
+  class Reader;
+
+  // A pinned version of the tree, valid as long as the guard lives.
+  class SOURCERER_API Guard {
+   public:
+    Guard(Guard&& other) noexcept;
+    Guard& operator=(Guard&&) = delete;
+    ~Guard();
+
+    const Node& operator*() const noexcept { return *root_; }
+    const Node* operator->() const noexcept { return root_; }
+
+    // How many versions were published before this one.
+    std::uint64_t version() const noexcept { return version_; }
+
+   private:
+    friend class Reader;
+
+    Guard(Reader& reader, const Node& root, std::uint64_t version) noexcept
+        : reader_{&reader}, root_{&root}, version_{version} {}
+
+    Reader* reader_;
+    const Node* root_;
+    std::uint64_t version_;
+  };
+
+  // The handle a thread reads through, with the slot it announces its epoch in.
+  class SOURCERER_API Reader {
+   public:
+    Reader(Reader&& other) noexcept;
+    Reader& operator=(Reader&&) = delete;
+    ~Reader();
+
+    // Pins the current version. Guards can be nested, the inner ones may see newer versions.
+    Guard read() noexcept;
+
+   private:
+    friend class Guard;
+    friend class Publisher;
+
+    struct Slot;
+
+    Reader(Publisher& publisher, Slot& slot) noexcept : publisher_{&publisher}, slot_{&slot} {}
+
+    void unpin() noexcept;
+
+    Publisher* publisher_;
+    Slot* slot_;
+    // The guards of this reader that are alive, only the outermost one pins.
+    std::size_t depth_ = 0;
+  };
+
+  explicit Publisher(Node root = {});
+  ~Publisher();
+
+  Publisher(const Publisher&) = delete;
+  Publisher& operator=(const Publisher&) = delete;
+
+  // Registers a reader, reusing the slot of a destroyed one if there is any.
+  Reader reader();
+
+  // Replaces the current version with root.
+  void publish(Node root);
+  // Publishes a copy of the current version that update changed. Updates don't lose each other's
+  // changes. Nothing is published if update throws.
+  void update(const std::function<void(Node&)>& update);
+
+  // A copy of the current version, for threads that don't read often enough to have a Reader.
+  Node current() const;
+  // How many versions were published after the first one.
+  std::uint64_t version() const noexcept { return version_.load(std::memory_order_acquire); }
+
+  // Destroys the replaced versions no reader can see anymore, publishing does so as well.
+  void reclaim();
+  // The replaced versions that weren't destroyed yet.
+  std::size_t retired() const;
+
+ private:
+  struct Version {
+    Node root;
+    std::uint64_t number;
+  };
+
+  struct Retired {
+    std::unique_ptr<Version> version;
+    // The epoch that started when the version was replaced.
+    std::uint64_t epoch;
+  };
+
+  // Swaps next in and retires the current version, with mutex_ held.
+  void replace(std::unique_ptr<Version> next);
+  // Moves the retired versions no slot can see anymore to drained, with mutex_ held.
+  void collect(std::vector<std::unique_ptr<Version>>& drained);
+
+  std::atomic<Version*> current_;
+  // Starts at 1, a slot holding 0 isn't reading.
+  std::atomic<std::uint64_t> epoch_{1};
+  std::atomic<std::uint64_t> version_{0};
+  // A list that only grows, slots are reused but freed with the publisher.
+  std::atomic<Reader::Slot*> slots_{nullptr};
+
+  mutable std::mutex mutex_;
+  std::vector<Retired> retired_;
+};
+
+}  // namespace sourcerer
@@ -0,0 +1,329 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/conjurers/conjurer.hpp"
+#include "sourcerer/detail/content_hash.hpp"
+#include "sourcerer/detail/magic_cast.hpp"
+#include "sourcerer/detail/type_name.hpp"
+#include "sourcerer/node.hpp"
+
+namespace sourcerer {
+
+class NodeBuilder;
+
+namespace detail {
+
+// The start of every snapshot. Offsets in a snapshot are counted from here.
+struct snapshot_header {
+  std::array<char, 8> magic;
+  std::uint32_t version;
+  // The offset of the root entry.
+  std::uint32_t root;
+  // The size of the whole snapshot, header included.
+  std::uint64_t size;
+  // The content_hash of the text the tree was sourced from, 0 if unknown.
+  std::uint64_t source_hash;
+  // The content_hash of everything after the header.
+  std::uint64_t checksum;
+};
+
+// A node of a snapshot. The children of a container are stored as one array of entries.
+struct snapshot_entry {
+  // Booleans, integers and doubles store their bits, strings and containers the offset of their
+  // characters or children.
+  std::uint64_t payload;
+  // The size of a string or the number of children of a container.
+  std::uint32_t size;
+  node_kind kind;
+  // Objects whose members are stored sorted by key, which need no order table.
+  std::uint8_t sorted;
+  std::array<std::uint8_t, 2> padding;
+};
+
+// The key of an object member. The members of an object follow its children, and objects that
+// aren't sorted follow them with the positions of their members ordered by key.
+struct snapshot_member {
+  std::uint32_t key;
+  std::uint32_t size;
+};
+
+static_assert(sizeof(snapshot_header) == 40);
+static_assert(sizeof(snapshot_entry) == 16);
+static_assert(sizeof(snapshot_member) == 8);
+
+}  // namespace detail
+
+/**
+ * @brief A node of a Snapshot, read in place from its bytes.
+ *
+ * Offers the reading part of the Node API. Nothing is decoded up front: values are loaded from
+ * their entry when read, and looking up a key is a binary search over the sorted keys of the
+ * object.
+ *
+ * SnapshotNodes are views into their snapshot and only valid as long as a copy of it is.
+ */
+class SOURCERER_API SnapshotNode {
+ public:
+  using size_type = std::size_t;
+
+  // Iterates over the children of containers, the members of objects carry their key().
+  class const_iterator {
+   public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = SnapshotNode;
+    using reference = SnapshotNode;
+    using difference_type = std::ptrdiff_t;
+
+    const_iterator() = default;
+
+    SnapshotNode operator*() const noexcept { return SnapshotNode{base_, entry_, member_}; }
+
+    const_iterator& operator++() noexcept {
+      ++entry_;
+      if (member_ != nullptr) ++member_;
+      return *this;
+    }
+    const_iterator operator++(int) noexcept {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const const_iterator& other) const noexcept { return entry_ == other.entry_; }
+
+   private:
+    friend class SnapshotNode;
+
+    const_iterator(const std::byte* base, const detail::snapshot_entry* entry,
+                   const detail::snapshot_member* member) noexcept
+        : base_{base}, entry_{entry}, member_{member} {}
+
+    const std::byte* base_ = nullptr;
+    const detail::snapshot_entry* entry_ = nullptr;
+    const detail::snapshot_member* member_ = nullptr;
+  };
+  using iterator = const_iterator;
+
+  bool is_null() const noexcept { return kind() == detail::node_kind::null; }
+  bool is_value() const noexcept { return detail::is_scalar(kind()); }
+  bool is_object() const noexcept { return kind() == detail::node_kind::object; }
+  bool is_array() const noexcept { return kind() == detail::node_kind::array; }
+
+  bool is_string() const noexcept { return kind() == detail::node_kind::string; }
+  bool is_bool() const noexcept { return kind() == detail::node_kind::boolean; }
+  bool is_integer() const noexcept {
+    return kind() == detail::node_kind::integer || kind() == detail::node_kind::unsigned_integer;
+  }
+  bool is_floating() const noexcept { return kind() == detail::node_kind::floating; }
+  bool is_number() const noexcept { return is_integer() || is_floating(); }
+
+  // Throw std::out_of_range if the index or key doesn't exist, and std::invalid_argument if this
+  // isn't an array or object respectively.
+  SnapshotNode at(size_type index) const;
+  SnapshotNode at(std::string_view key) const;
+
+  // Unchecked, like the const operator[] of Node: the index or key must exist.
+  SnapshotNode operator[](size_type index) const noexcept;
+  SnapshotNode operator[](std::string_view key) const noexcept { return *find(key); }
+
+  // Returns the value of key, or nothing if the object doesn't have it.
+  std::optional<SnapshotNode> find(std::string_view key) const;
+  bool contains(std::string_view key) const { return find(key).has_value(); }
+
+  // The key of a member reached through its object. Throws std::logic_error for other values.
+  std::string_view key() const;
+
+  // Containers have one entry per child, values one and null none, like a Node.
+  size_type size() const noexcept;
+  bool empty() const noexcept { return size() == 0; }
+
+  // Converts the value like Node::as() does.
+  template <typename T>
+  T as() const {
+    switch (kind()) {
+      case detail::node_kind::null:
+        return detail::magic_cast<T>(Node::null_t{});
+      case detail::node_kind::boolean:
+        return detail::magic_cast<T>(entry_->payload != 0);
+      case detail::node_kind::integer:
+        return detail::magic_cast<T>(std::bit_cast<std::int64_t>(entry_->payload));
+      case detail::node_kind::unsigned_integer:
+        return detail::magic_cast<T>(entry_->payload);
+      case detail::node_kind::floating:
+        return detail::magic_cast<T>(std::bit_cast<double>(entry_->payload));
+      case detail::node_kind::string:
+        return detail::magic_cast<T>(string());
+      default:
+        SOURCERER_THROW(std::invalid_argument("Can't convert a snapshot " +
+                                              detail::type_name(kind()) + " to " +
+                                              detail::type_name<T>()));
+    }
+  }
+
+  // Decodes the subtree into a Node. Its objects are ordered like this one, or sorted if this
+  // isn't an object.
+  Node node() const;
+
+  const_iterator begin() const noexcept;
+  const_iterator end() const noexcept;
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+ private:
+  friend class Snapshot;
+
+  SnapshotNode(const std::byte* base, const detail::snapshot_entry* entry,
+               const detail::snapshot_member* member = nullptr) noexcept
+      : base_{base}, entry_{entry}, member_{member} {}
+
+  detail::node_kind kind() const noexcept { return entry_->kind; }
+  // Adds the subtree to builder.
+  void build(NodeBuilder& builder) const;
+
+  template <class T>
+  const T* at_offset(const std::uint64_t offset) const noexcept {
+    return reinterpret_cast<const T*>(base_ + offset);
+  }
+  std::string_view string() const noexcept {
+    return {at_offset<char>(entry_->payload), entry_->size};
+  }
+  const detail::snapshot_entry* children() const noexcept {
+    return at_offset<detail::snapshot_entry>(entry_->payload);
+  }
+  const detail::snapshot_member* members() const noexcept {
+    return reinterpret_cast<const detail::snapshot_member*>(children() + entry_->size);
+  }
+
+  const std::byte* base_;
+  const detail::snapshot_entry* entry_;
+  // The key of a member reached through its object, nullptr otherwise.
+  const detail::snapshot_member* member_;
+};
+
+/**
+ * @brief A Node tree encoded as one position independent block of bytes, read without parsing.
+ *
+ * Every node is a 16 byte entry, the children of each container are stored next to each other
+ * and refer to strings and grandchildren by their offset from the start of the snapshot, never by
+ * pointer. Objects carry a table of their keys in order, so lookups are binary searches. Strings
+ * and keys are stored once, however often they occur. A versioned header with a checksum of the
+ * rest guards against reading a corrupt, truncated or foreign file.
+ *
+ * open() maps a snapshot file into memory, so the tree can be read as soon as it is validated:
+ * the checksum is verified and every offset is checked to stay within the snapshot, so crafted
+ * files are rejected as well. There is nothing to parse, and reading the tree allocates nothing.
+ * encode() and write() produce snapshots. The encoding uses the byte order of the machine, only
+ * little-endian machines are supported.
+ *
+ * Copies of a Snapshot share its bytes, which live until the last copy is gone.
+ */
+class SOURCERER_API Snapshot {
+  friend class SnapshotCache;
+
+ public:
+  static constexpr std::uint32_t version = 1;
+
+  // Copies a snapshot from bytes. Throws std::invalid_argument if it isn't valid.
+  explicit Snapshot(std::string_view bytes);
+
+  // Maps the snapshot file at path into memory. Throws std::runtime_error if it can't be read and
+  // std::invalid_argument if it isn't a valid snapshot.
+  static Snapshot open(const std::filesystem::path& path);
+
+  // Encodes node, source_hash is the content_hash of the text it was sourced from. Throws
+  // std::length_error for trees of 4 GiB or more.
+  static std::string encode(const Node& node, std::uint64_t source_hash = 0);
+  // Encodes node into a file at path, which is replaced atomically.
+  static void write(const Node& node, const std::filesystem::path& path,
+                    std::uint64_t source_hash = 0);
+
+  SnapshotNode root() const noexcept;
+
+  std::uint64_t source_hash() const noexcept { return header().source_hash; }
+  std::size_t bytes() const noexcept { return size_; }
+
+ private:
+  struct Writer;
+
+  // Doesn't validate the snapshot.
+  Snapshot(const std::byte* data, std::size_t size, std::shared_ptr<const void> storage);
+
+  // Copies bytes into a snapshot, without validating it.
+  static Snapshot copy(std::string_view bytes);
+  // Maps or reads the file at path like open(), without validating it.
+  static Snapshot map(const std::filesystem::path& path);
+
+  // Why the header doesn't describe a snapshot of size_ bytes, the checksum doesn't match or an
+  // entry refers to bytes outside the snapshot, empty if the snapshot is valid. The cache checks
+  // files with it, which works without exceptions.
+  std::string problem() const;
+  // Throws std::invalid_argument if there is a problem().
+  void validate() const;
+
+  const detail::snapshot_header& header() const noexcept {
+    return *reinterpret_cast<const detail::snapshot_header*>(data_);
+  }
+
+  const std::byte* data_;
+  std::size_t size_;
+  // Owns the mapping or buffer data_ points into.
+  std::shared_ptr<const void> storage_;
+};
+
+/**
+ * @brief Keeps the snapshots of sourced texts, keyed by the content_hash of the text.
+ *
+ * load() conjures the text and hashes it. A text that was loaded before is served from memory, and
+ * one that was loaded by an earlier process from its snapshot file in the cache directory. Only
+ * new texts are parsed, and their snapshot is written to the directory for the next process. So
+ * an unchanged configuration costs reading and hashing the text, plus mapping its snapshot at the
+ * first load of a process. Snapshots that are corrupt or of another version are replaced.
+ *
+ * The directory is shared safely by processes, snapshot files are replaced atomically. Loading is
+ * thread safe.
+ */
+class SOURCERER_API SnapshotCache {
+ public:
+  // Turns a conjured text into a tree.
+  using parser = std::function<Node(std::string text)>;
+
+  // Parses the text as JSON, with JsonSourcerer.
+  static Node parse_json(std::string text);
+
+  // Creates directory if it doesn't exist yet.
+  explicit SnapshotCache(std::filesystem::path directory, parser parse = parse_json);
+
+  Snapshot load(Conjurer& conjurer);
+
+  // The number of snapshots held in memory.
+  std::size_t size() const;
+  // Drops the snapshots held in memory, their files stay.
+  void clear();
+
+ private:
+  std::filesystem::path path_of(std::uint64_t hash) const;
+
+  std::filesystem::path directory_;
+  parser parse_;
+
+  mutable std::mutex mutex_;
+  std::unordered_map<std::uint64_t, Snapshot> snapshots_;
+};
+
+}  // namespace sourcerer
@@ -1,44 +1,179 @@
 #pragma once
 
+#include <cstdint>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
 #include <nlohmann/json.hpp>
 
+#include "sourcerer/common.hpp"
 #include "sourcerer/conjurers/conjurer.hpp"
+#include "sourcerer/detail/json_index.hpp"
+#include "sourcerer/detail/shared_arena.hpp"
 #include "sourcerer/node.hpp"
+#include "sourcerer/node_builder.hpp"
 #include "sourcerer/sourcerers/sourcerer.hpp"
 
 namespace sourcerer {
 
+/**
+ * @brief A sourcerer that parses the conjured data as JSON.
+ *
+ * By default the tree is built straight from the events of nlohmann::json::sax_parse, without the
+ * nlohmann::json document in between, which would double the peak memory and allocations of a
+ * load. parse_mode::dom parses the document first and builds the tree from it instead.
+ * parse_mode::simd skips nlohmann::json altogether: the text is indexed by a json_index, whose
+ * scanner finds the structure of the text with SIMD instructions, and the tree is built from the
+ * index. It is the fastest mode, but reports invalid JSON with a std::invalid_argument instead of a
+ * nlohmann::json::parse_error.
+ *
+ * The tree is built into a monotonic arena owned by the sourcerer, so loading and tearing it down
+ * costs a handful of large allocations instead of one per node, key and value. A different
+ * @p resource can be supplied to build the tree into it instead. The tree is assembled by a
+ * NodeBuilder, so all objects intern their keys in one KeyPool and a key repeated across objects
+ * is only stored once.
+ *
+ * source() returns a copy-on-write snapshot that shares the containers of the tree in O(1), and
+ * writing to it only clones the containers on the path to the change. The arena lives until the
+ * last snapshot is gone, even if the sourcerer is destroyed first. A supplied @p resource can't be
+ * relied on to outlive the snapshots, so trees built into one are copied by source().
+ */
 class JsonSourcerer : public Sourcerer {
  public:
-  explicit JsonSourcerer(Conjurer& conjurer) {
-    convert_to_node(root_, nlohmann::json::parse(conjurer.conjure()));
+  enum class parse_mode { sax, dom, simd };
+
+  explicit JsonSourcerer(Conjurer& conjurer, std::pmr::memory_resource* resource = nullptr,
+                         const parse_mode mode = parse_mode::sax)
+      : arena_{resource != nullptr ? nullptr : detail::shared_arena::create()},
+        root_{resource != nullptr ? resource : arena_.get()} {
+    NodeBuilder builder{root_.get_allocator()};
+    switch (mode) {
+      case parse_mode::sax: {
+        Events events{builder};
+        nlohmann::json::sax_parse(conjurer.conjure(), &events);
+        break;
+      }
+      case parse_mode::dom:
+        build(builder, nlohmann::json::parse(conjurer.conjure()));
+        break;
+      case parse_mode::simd: {
+        const auto text = conjurer.conjure();
+        detail::json_index{text}.build(builder);
+        break;
+      }
+    }
+    root_ = builder.finish();
   }
 
   inline Node source() override { return root_; };
 
  private:
-  void convert_to_node(Node& parent, const nlohmann::json& json) const {
+  // Forwards the events of nlohmann::json::sax_parse to a NodeBuilder.
+  class Events {
+   public:
+    explicit Events(NodeBuilder& builder) : builder_{builder} {}
+
+    bool null() {
+      builder_.value();
+      return true;
+    }
+    bool boolean(const bool value) {
+      builder_.value(value);
+      return true;
+    }
+    bool number_integer(const nlohmann::json::number_integer_t value) {
+      builder_.value(static_cast<std::int64_t>(value));
+      return true;
+    }
+    bool number_unsigned(const nlohmann::json::number_unsigned_t value) {
+      builder_.value(static_cast<std::uint64_t>(value));
+      return true;
+    }
+    bool number_float(const nlohmann::json::number_float_t value, const std::string& /*text*/) {
+      builder_.value(static_cast<double>(value));
+      return true;
+    }
+    bool string(const std::string& value) {
+      builder_.value(value);
+      return true;
+    }
+    bool binary(const nlohmann::json::binary_t& /*value*/) {
+      SOURCERER_THROW(std::invalid_argument("Binary values are not supported"));
+    }
+
+    bool start_object(const std::size_t /*size*/) {
+      builder_.begin_object();
+      return true;
+    }
+    bool key(const std::string& key) {
+      builder_.key(key);
+      return true;
+    }
+    bool end_object() {
+      builder_.end_object();
+      return true;
+    }
+
+    bool start_array(const std::size_t /*size*/) {
+      builder_.begin_array();
+      return true;
+    }
+    bool end_array() {
+      builder_.end_array();
+      return true;
+    }
+
+    // Throws the error like nlohmann::json::parse() does.
+    template <class Exception>
+    bool parse_error(const std::size_t /*position*/, const std::string& /*token*/,
+                     const Exception& error) {
+      SOURCERER_THROW(error);
+    }
+
+   private:
+    NodeBuilder& builder_;
+  };
+
+  static void build(NodeBuilder& builder, const nlohmann::json& json) {
     switch (json.type()) {
       case nlohmann::json::value_t::array:
+        builder.begin_array();
         for (const auto& element : json) {
-          Node child;
-          convert_to_node(child, element);
-          parent.push_back(child);
+          build(builder, element);
         }
+        builder.end_array();
         break;
       case nlohmann::json::value_t::object:
+        // nlohmann::json iterates keys in sorted order, so the builder only appends.
+        builder.begin_object();
         for (const auto& [key, value] : json.items()) {
-          Node child;
-          convert_to_node(child, value);
-          parent[key] = child;
+          builder.key(key);
+          build(builder, value);
         }
+        builder.end_object();
+        break;
+      case nlohmann::json::value_t::string:
+        builder.value(json.get_ref<const std::string&>());
+        break;
+      case nlohmann::json::value_t::boolean:
+        builder.value(json.get<bool>());
+        break;
+      case nlohmann::json::value_t::number_integer:
+        builder.value(json.get<std::int64_t>());
+        break;
+      case nlohmann::json::value_t::number_unsigned:
+        builder.value(json.get<std::uint64_t>());
+        break;
+      case nlohmann::json::value_t::number_float:
+        builder.value(json.get<double>());
         break;
       default:
-        parent = json.dump();
+        builder.value();
         break;
     }
   }
 
+  detail::shared_arena::owner arena_;
   Node root_;
 };
 
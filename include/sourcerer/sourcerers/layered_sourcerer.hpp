@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/node.hpp"
+#include "sourcerer/sourcerers/sourcerer.hpp"
+
+namespace sourcerer {
+
+class LayeredSourcerer;
+
+/**
+ * @brief A value of the merged tree of a LayeredSourcerer.
+ *
+ * Offers the reading part of the Node API. A LayeredNode refers to the value of the topmost layer
+ * that has it, and objects that more than one layer has are read as the merge of all of them.
+ * node() turns the merged subtree into a Node when one is needed.
+ *
+ * LayeredNodes are handles into their sourcerer, valid until it is destroyed or reloaded.
+ */
+class SOURCERER_API LayeredNode {
+ public:
+  using size_type = std::size_t;
+
+  // Iterates over the children of containers, the members of objects carry their key().
+  class const_iterator {
+   public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = LayeredNode;
+    using reference = LayeredNode;
+    using difference_type = std::ptrdiff_t;
+
+    const_iterator() = default;
+
+    LayeredNode operator*() const;
+
+    const_iterator& operator++() noexcept {
+      ++index_;
+      return *this;
+    }
+    const_iterator operator++(int) noexcept {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const const_iterator& other) const noexcept { return index_ == other.index_; }
+
+   private:
+    friend class LayeredNode;
+
+    const_iterator(const LayeredSourcerer* document, const Node* node, const std::uint32_t group,
+                   const size_type index) noexcept
+        : document_{document}, node_{node}, group_{group}, index_{index} {}
+
+    // The container iterated over.
+    const LayeredSourcerer* document_ = nullptr;
+    const Node* node_ = nullptr;
+    std::uint32_t group_ = 0;
+    size_type index_ = 0;
+  };
+  using iterator = const_iterator;
+
+  bool is_null() const noexcept { return node_->is_null(); }
+  bool is_value() const noexcept { return node_->is_value(); }
+  bool is_object() const noexcept { return node_->is_object(); }
+  bool is_array() const noexcept { return node_->is_array(); }
+
+  bool is_string() const noexcept { return node_->is_string(); }
+  bool is_bool() const noexcept { return node_->is_bool(); }
+  bool is_integer() const noexcept { return node_->is_integer(); }
+  bool is_floating() const noexcept { return node_->is_floating(); }
+  bool is_number() const noexcept { return node_->is_number(); }
+
+  // Throw std::out_of_range if the index or key doesn't exist, and std::invalid_argument if this
+  // isn't an array or object respectively.
+  LayeredNode at(size_type index) const;
+  LayeredNode at(std::string_view key) const;
+  // The same as at(), a handle can't refer to a missing value.
+  LayeredNode operator[](const size_type index) const { return at(index); }
+  LayeredNode operator[](std::string_view key) const { return at(key); }
+
+  // Returns the value of key in the topmost layer that has it, or nothing if none does.
+  std::optional<LayeredNode> find(std::string_view key) const;
+  bool contains(std::string_view key) const { return find(key).has_value(); }
+
+  // The key of a member reached through its object. Throws std::logic_error for other values.
+  std::string_view key() const;
+
+  // Merged objects have one entry per distinct key of their layers.
+  size_type size() const;
+  bool empty() const { return size() == 0; }
+
+  // Converts the value like Node::as() does.
+  template <typename T>
+  T as() const {
+    return node_->as<T>();
+  }
+
+  // The merged subtree as a Node. Values and subtrees that only one layer has are shared with
+  // that layer copy-on-write, so only merged objects are allocated.
+  Node node() const;
+
+  const_iterator begin() const { return const_iterator{document_, node_, group_, 0}; }
+  const_iterator end() const { return const_iterator{document_, node_, group_, size()}; }
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+ private:
+  friend class LayeredSourcerer;
+
+  static constexpr std::uint32_t no_group = std::numeric_limits<std::uint32_t>::max();
+
+  LayeredNode(const LayeredSourcerer* document, const Node* node,
+              const std::uint32_t group = no_group, const std::string_view key = {},
+              const bool member = false) noexcept
+      : document_{document}, node_{node}, group_{group}, key_{key}, member_{member} {}
+
+  // The child at index, or this value itself.
+  LayeredNode child(size_type index) const;
+
+  const LayeredSourcerer* document_;
+  // The value of the topmost layer that has it.
+  const Node* node_;
+  // The merge group of an object that more than one layer has.
+  std::uint32_t group_;
+  std::string_view key_;
+  bool member_;
+};
+
+/**
+ * @brief A sourcerer that stacks other sourcerers and reads them as one merged tree.
+ *
+ * Layers are given from the bottom up, like defaults, a site file, a host file and overrides:
+ * every layer overrides the ones below it. Objects that several layers have are merged key by key,
+ * any other value of a higher layer replaces the one below, arrays included.
+ *
+ * Nothing is merged up front. The sourced trees of the layers are kept as they are and root()
+ * reads through them. A lookup in an object several layers have falls through their objects from
+ * the top down, one hash probe per layer, and the sourcerer remembers which of its children are
+ * merged objects themselves. A lookup in an object only one layer has is a lookup in that layer.
+ * The merged index of the keys of an object, which iterating it or taking its size needs, is built
+ * the first time it is needed and kept. So memory grows with the objects that are overridden and
+ * read, not with the number or size of the layers. source() materializes the merged tree, sharing
+ * everything that isn't overridden with the layers.
+ *
+ * Reading updates what the sourcerer remembers, so a LayeredSourcerer must not be read from several
+ * threads at once. It can't be copied or moved, since its LayeredNodes refer to it.
+ */
+class SOURCERER_API LayeredSourcerer : public Sourcerer {
+ public:
+  // Sources every layer. The layers must outlive the sourcerer to be reloaded.
+  explicit LayeredSourcerer(std::vector<std::reference_wrapper<Sourcerer>> layers);
+
+  LayeredSourcerer(const LayeredSourcerer&) = delete;
+  LayeredSourcerer& operator=(const LayeredSourcerer&) = delete;
+
+  LayeredNode root() const;
+
+  Node source() override { return root().node(); }
+
+  // Sources all layers, or only the given one, again. Invalidates all LayeredNodes.
+  void reload();
+  void reload(std::size_t layer);
+
+  std::size_t layers() const noexcept { return layers_.size(); }
+
+  // The number of objects merged from several layers that have been reached so far.
+  std::size_t merged() const noexcept { return groups_.size(); }
+
+ private:
+  friend class LayeredNode;
+
+  struct Member {
+    std::string_view key;
+    // The value of the topmost layer that has the key, and the position of that layer in the
+    // objects of the group.
+    const Node* value;
+    std::uint32_t layer;
+  };
+
+  // An object that several layers have.
+  struct Group {
+    // The objects of the layers, topmost first.
+    std::vector<const Node*> objects;
+    // The groups of the members found so far that are merged objects themselves.
+    std::unordered_map<std::string_view, std::uint32_t> children;
+    // The distinct keys, ordered like the objects of the layers, once indexed.
+    bool indexed = false;
+    std::vector<Member> members;
+  };
+
+  // Drops all groups and finds the one of the roots.
+  void reset();
+  // Returns the group of the objects the layers have at key, starting from objects[layer], or
+  // no_group if only that one layer has an object there.
+  std::uint32_t group_of(const std::vector<const Node*>& objects, std::uint32_t layer,
+                         std::string_view key) const;
+  // Returns the group with its members indexed.
+  const Group& indexed(std::uint32_t group) const;
+  // Returns the member of group whose topmost value is objects[layer] at key.
+  LayeredNode member(std::uint32_t group, std::string_view key, const Node* value,
+                     std::uint32_t layer) const;
+
+  static const Node::object_t& object(const Node& node);
+  // Overrides the members of target with the ones of overlay, merging objects both have.
+  static void merge(Node& target, const Node& overlay);
+
+  std::vector<std::reference_wrapper<Sourcerer>> sourcerers_;
+  std::vector<Node> layers_;
+  std::uint32_t root_ = LayeredNode::no_group;
+
+  // Groups are referred to by their position, which never changes.
+  mutable std::deque<Group> groups_;
+};
+
+}  // namespace sourcerer
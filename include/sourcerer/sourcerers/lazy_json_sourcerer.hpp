@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <list>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/conjurers/conjurer.hpp"
+#include "sourcerer/detail/json_index.hpp"
+#include "sourcerer/detail/magic_cast.hpp"
+#include "sourcerer/detail/shared_arena.hpp"
+#include "sourcerer/detail/type_name.hpp"
+#include "sourcerer/key_pool.hpp"
+#include "sourcerer/node.hpp"
+#include "sourcerer/node_builder.hpp"
+#include "sourcerer/sourcerers/sourcerer.hpp"
+
+namespace sourcerer {
+
+class LazyJsonSourcerer;
+
+/**
+ * @brief A value of the document of a LazyJsonSourcerer, read straight from its structural index.
+ *
+ * Offers the reading part of the Node API. Navigating and reading values doesn't materialize
+ * anything, node() turns the subtree into a Node when one is needed. The first lookup in a
+ * container builds a directory of its children, which the sourcerer caches, so looking up keys and
+ * indices afterwards is a hash probe or an array access.
+ *
+ * Objects are read as the text writes them. A key that occurs more than once is one member per
+ * occurrence to size() and iteration, while lookups and node() only see its last value, like
+ * JsonSourcerer does.
+ *
+ * LazyNodes are handles into their sourcerer and only valid as long as it is.
+ */
+class SOURCERER_API LazyNode {
+ public:
+  using size_type = std::size_t;
+
+  // Iterates over the children of containers, the members of objects carry their key().
+  class const_iterator {
+   public:
+    using iterator_concept = std::forward_iterator_tag;
+    using iterator_category = std::input_iterator_tag;
+    using value_type = LazyNode;
+    using reference = LazyNode;
+    using difference_type = std::ptrdiff_t;
+
+    const_iterator() = default;
+
+    LazyNode operator*() const;
+
+    const_iterator& operator++() noexcept;
+    const_iterator operator++(int) noexcept {
+      auto copy = *this;
+      ++*this;
+      return copy;
+    }
+
+    bool operator==(const const_iterator& other) const noexcept { return pos_ == other.pos_; }
+
+   private:
+    friend class LazyNode;
+
+    const_iterator(const LazyJsonSourcerer* document, const std::uint32_t pos, const bool members)
+        : document_{document}, pos_{pos}, members_{members} {}
+
+    const LazyJsonSourcerer* document_ = nullptr;
+    // The value, or for members the key.
+    std::uint32_t pos_ = 0;
+    bool members_ = false;
+  };
+  using iterator = const_iterator;
+
+  bool is_null() const { return kind() == detail::node_kind::null; }
+  bool is_value() const { return detail::is_scalar(kind()); }
+  bool is_object() const { return kind() == detail::node_kind::object; }
+  bool is_array() const { return kind() == detail::node_kind::array; }
+
+  bool is_string() const { return kind() == detail::node_kind::string; }
+  bool is_bool() const { return kind() == detail::node_kind::boolean; }
+  bool is_integer() const {
+    const auto k = kind();
+    return k == detail::node_kind::integer || k == detail::node_kind::unsigned_integer;
+  }
+  bool is_floating() const { return kind() == detail::node_kind::floating; }
+  bool is_number() const { return is_integer() || is_floating(); }
+
+  // Throw std::out_of_range if the index or key doesn't exist, and std::invalid_argument if this
+  // isn't an array or object respectively.
+  LazyNode at(size_type index) const;
+  LazyNode at(std::string_view key) const;
+  // The same as at(), a handle can't refer to a missing value.
+  LazyNode operator[](const size_type index) const { return at(index); }
+  LazyNode operator[](std::string_view key) const { return at(key); }
+
+  // Returns the value of key, or nothing if the object doesn't have it. A key that appears more
+  // than once refers to its last value, like in a Node.
+  std::optional<LazyNode> find(std::string_view key) const;
+  bool contains(std::string_view key) const { return find(key).has_value(); }
+
+  // The key of a member reached through its object. Throws std::logic_error for other values.
+  std::string key() const;
+
+  // Containers have one entry per child, values one and null none, like a Node.
+  size_type size() const;
+  bool empty() const { return size() == 0; }
+
+  // Converts the value like Node::as() does.
+  template <typename T>
+  T as() const {
+    if (index().is_number(pos_)) {
+      return std::visit([](const auto number) { return detail::magic_cast<T>(number); },
+                        index().number(pos_));
+    }
+
+    switch (kind()) {
+      case detail::node_kind::null:
+        return detail::magic_cast<T>(Node::null_t{});
+      case detail::node_kind::boolean:
+        return detail::magic_cast<T>(index().boolean(pos_));
+      case detail::node_kind::string:
+        return detail::magic_cast<T>(std::string_view{index().string(pos_)});
+      default:
+        return node().as<T>();
+    }
+  }
+
+  // The subtree as a Node. It is materialized the first time and cached by the sourcerer, later
+  // calls return copy-on-write snapshots of it in O(1).
+  Node node() const;
+
+  const_iterator begin() const;
+  const_iterator end() const;
+  const_iterator cbegin() const { return begin(); }
+  const_iterator cend() const { return end(); }
+
+ private:
+  friend class LazyJsonSourcerer;
+
+  static constexpr std::uint32_t no_key = std::numeric_limits<std::uint32_t>::max();
+
+  LazyNode(const LazyJsonSourcerer* document, const std::uint32_t pos,
+           const std::uint32_t key = no_key) noexcept
+      : document_{document}, pos_{pos}, key_{key} {}
+
+  const detail::json_index& index() const noexcept;
+  detail::node_kind kind() const { return index().kind(pos_); }
+
+  const LazyJsonSourcerer* document_;
+  // The value on the tape of the index, and its key if it was reached through its object.
+  std::uint32_t pos_;
+  std::uint32_t key_;
+};
+
+/**
+ * @brief A sourcerer that parses the conjured JSON lazily, on demand.
+ *
+ * Loading only builds a json_index of the text, in one pass: a tape of eight bytes per token, no
+ * nodes, keys or strings. root() reads the document through that index, and only the containers
+ * and subtrees that are accessed pay for a directory or a Node. Startup time and memory follow
+ * what is read, not the size of the document. source() materializes the whole tree, which is
+ * what JsonSourcerer does up front.
+ *
+ * The directories and Nodes are cached per container. With a @p cache_capacity, the least recently
+ * used ones are evicted once there are more than that, though the last one used always stays.
+ * evict() drops all of them. Every materialized subtree lives in its own arena, which is freed once
+ * it is evicted and the last snapshot of it is gone. Evicted containers are simply rebuilt from the
+ * index when accessed again.
+ *
+ * Reading the document updates the cache, so a LazyJsonSourcerer must not be read from several
+ * threads at once. It can't be copied or moved, since its LazyNodes refer to it.
+ */
+class SOURCERER_API LazyJsonSourcerer : public Sourcerer {
+ public:
+  static constexpr std::size_t unlimited = std::numeric_limits<std::size_t>::max();
+
+  // Throws std::invalid_argument if the conjured text isn't valid JSON.
+  explicit LazyJsonSourcerer(Conjurer& conjurer, std::size_t cache_capacity = unlimited);
+
+  LazyJsonSourcerer(const LazyJsonSourcerer&) = delete;
+  LazyJsonSourcerer& operator=(const LazyJsonSourcerer&) = delete;
+
+  LazyNode root() const noexcept { return LazyNode{this, 0}; }
+
+  Node source() override { return root().node(); }
+
+  // Drops all cached directories and Nodes. Snapshots handed out before stay valid.
+  void evict() noexcept;
+
+  // The number of containers with a cached directory or Node.
+  std::size_t cached() const noexcept { return cache_.size(); }
+
+  // The bytes taken by the conjured text and its index, which stay for the lifetime of the
+  // sourcerer.
+  std::size_t index_bytes() const noexcept { return text_.capacity() + index_.bytes(); }
+
+ private:
+  friend class LazyNode;
+
+  struct Entry {
+    // Objects: the positions of their keys, ordered by the hash of the key. Arrays: the positions
+    // of their elements.
+    std::vector<std::uint32_t> children;
+    std::vector<std::uint32_t> hashes;
+    bool indexed = false;
+
+    // Destroyed before its arena.
+    detail::shared_arena::owner arena;
+    std::optional<Node> node;
+
+    std::list<std::uint32_t>::iterator use;
+  };
+
+  // Returns the cache entry of the container at pos, marking it as most recently used.
+  Entry& entry(std::uint32_t pos) const;
+  // Returns the entry of the container at pos with its directory built.
+  const Entry& directory(std::uint32_t pos) const;
+  // Evicts the least recently used entries until there are at most capacity_.
+  void shrink() const;
+
+  // Hashes and compares the key at pos, without decoding keys that have no escapes.
+  std::uint32_t key_hash(std::uint32_t pos) const;
+  bool key_equals(std::uint32_t pos, std::string_view key) const;
+
+  std::string text_;
+  detail::json_index index_;
+  std::size_t capacity_;
+
+  // All subtrees intern their keys here, keys shared between them are only stored once.
+  std::shared_ptr<KeyPool> keys_ = std::make_shared<KeyPool>();
+  mutable std::unordered_map<std::uint32_t, Entry> cache_;
+  // The cached containers, most recently used first.
+  mutable std::list<std::uint32_t> uses_;
+};
+
+}  // namespace sourcerer
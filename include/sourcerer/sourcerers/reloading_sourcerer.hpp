@@ -0,0 +1,130 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+#include "sourcerer/conjurers/conjurer.hpp"
+#include "sourcerer/node.hpp"
+#include "sourcerer/path.hpp"
+#include "sourcerer/sourcerers/sourcerer.hpp"
+
+namespace sourcerer {
+
+// What reloading changed in the tree of a ReloadingSourcerer.
+struct ReloadReport {
+  // The paths of the values that were replaced, added or removed. A value that was replaced as a
+  // whole is reported instead of the values below it.
+  std::vector<Path> changed;
+  // The files that couldn't be reloaded and the exception that reloading them threw. Their part
+  // of the tree stays as it was.
+  std::vector<std::pair<std::filesystem::path, std::exception_ptr>> failed;
+
+  bool empty() const noexcept { return changed.empty() && failed.empty(); }
+};
+
+/**
+ * @brief A sourcerer that watches its files and patches its tree when they change.
+ *
+ * The tree is either the one of a single file, or an object with the tree of every file at a key
+ * of its own. poll() and wait() pick up the files that were written since, where the directories
+ * of the files are watched with inotify on Linux, and their modification times are compared
+ * elsewhere. Only the files that changed are parsed again. The new tree of a file is compared with
+ * the live one by their hashes, see Node::hash(), and the differences are patched into it in
+ * place. So a change costs parsing and hashing its file plus copying what changed, not rebuilding
+ * the tree. Values are compared like Node::operator== does, 1 and 1.0 are the same.
+ *
+ * Nodes that didn't change keep their address, so references into root() stay valid and see later
+ * changes, with two exceptions like the ones of a std::vector: a container that gains or loses
+ * children may move its children, though not what is below them, and while a copy returned by
+ * source() is alive, the containers it shares on the path to a change are cloned before they are
+ * patched, leaving the references into them with the copy.
+ *
+ * Reloading writes to the tree, so it must not run while other threads read it.
+ */
+class SOURCERER_API ReloadingSourcerer : public Sourcerer {
+ public:
+  // Turns the conjurer of a file into its tree.
+  using parser = std::function<Node(Conjurer& conjurer)>;
+
+  // Parses the file as JSON, with JsonSourcerer.
+  static Node parse_json(Conjurer& conjurer);
+
+  // Loads the files, throws what loading them throws.
+  explicit ReloadingSourcerer(std::filesystem::path file, parser parse = parse_json);
+  // Mounts every file at its key of the root object.
+  explicit ReloadingSourcerer(std::vector<std::pair<std::string, std::filesystem::path>> files,
+                              parser parse = parse_json);
+  ~ReloadingSourcerer() override;
+
+  ReloadingSourcerer(const ReloadingSourcerer&) = delete;
+  ReloadingSourcerer& operator=(const ReloadingSourcerer&) = delete;
+
+  // The live tree.
+  const Node& root() const noexcept { return root_; }
+
+  // A copy-on-write snapshot of the live tree, which later changes don't affect.
+  Node source() override { return root_; }
+
+  // Reloads the files that changed since the last call, without waiting for any.
+  ReloadReport poll();
+  // Waits up to timeout for a file to change, then reloads the ones that did.
+  ReloadReport wait(std::chrono::milliseconds timeout);
+
+  // Reloads all files, or the one at the given position, whether they changed or not. Throws
+  // std::out_of_range for a position past the files.
+  ReloadReport reload();
+  ReloadReport reload(std::size_t file);
+
+  std::size_t files() const noexcept { return files_.size(); }
+
+  // The inotify descriptor that becomes readable when a file changes, to wait for it in an event
+  // loop and call poll() then. -1 where inotify isn't available.
+  int handle() const noexcept { return watcher_.descriptor; }
+
+ private:
+  struct File {
+    // Empty for a single file, which is the root.
+    std::string key;
+    std::filesystem::path path;
+    // The watch of its directory, or its modification time when it was last loaded.
+    int watch = -1;
+    std::filesystem::file_time_type modified{};
+    bool dirty = false;
+  };
+
+  // Owns the inotify descriptor, so that a constructor that throws after watch() closes it.
+  struct Watcher {
+    int descriptor = -1;
+
+    Watcher() = default;
+    Watcher(const Watcher&) = delete;
+    Watcher& operator=(const Watcher&) = delete;
+    ~Watcher();
+  };
+
+  void watch();
+  // Marks the files that changed as dirty.
+  void collect();
+  ReloadReport reload_dirty();
+  void load(File& file, ReloadReport& report);
+
+  // Patches live to equal fresh, adding the paths it changed below path to changed.
+  static void patch(Node& live, const Node& fresh, std::string& path, std::vector<Path>& changed);
+  // Copies the containers of node into its resource that it shares with other trees, like the
+  // arena of the parser, so that patching never clones them and moves what they hold.
+  static void own(Node& node);
+
+  std::vector<File> files_;
+  parser parse_;
+  Node root_;
+  Watcher watcher_;
+};
+
+}  // namespace sourcerer
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "sourcerer/common.hpp"
+
+namespace sourcerer {
+
+/**
+ * @brief Runs tasks, like a Loader's, somewhere.
+ *
+ * Implement it to run them on the thread pool of an application. execute() may run the task before
+ * it returns. Tasks don't throw.
+ */
+class Executor {
+ public:
+  virtual ~Executor() = default;
+
+  virtual void execute(std::function<void()> task) = 0;
+};
+
+/**
+ * @brief An Executor that runs tasks on a fixed number of threads.
+ *
+ * Every thread has its own queue. Tasks submitted from outside the pool are dealt to the queues in
+ * turn, and tasks a task submits go to the queue of its own thread. A thread takes the newest task
+ * of its queue, which is the likeliest to have its data in the cache, and when its queue runs dry
+ * steals the oldest task of another queue. So the threads stay busy when tasks take uneven time,
+ * and they only contend for a queue when one of them is stealing from it.
+ *
+ * The destructor runs the tasks still queued before it joins the threads.
+ */
+class SOURCERER_API ThreadPool : public Executor {
+ public:
+  // One thread per core by default. Throws std::invalid_argument for zero threads.
+  explicit ThreadPool(std::size_t threads = default_size());
+  ~ThreadPool() override;
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  void execute(std::function<void()> task) override;
+
+  std::size_t size() const noexcept { return threads_.size(); }
+
+  // The number of cores, at least one.
+  static std::size_t default_size() noexcept;
+
+ private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void run(std::size_t index);
+  // Takes the newest task of the queue at index, or steals the oldest one of another queue.
+  bool take(std::size_t index, std::function<void()>& task);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::atomic<std::size_t> next_{0};
+
+  // Tasks queued and not taken yet, raised before a task is queued and with mutex_ held so
+  // sleeping threads don't miss a task. It is never below the number of queued tasks.
+  std::atomic<std::size_t> pending_{0};
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  bool stopping_ = false;
+
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace sourcerer
@@ -0,0 +1,49 @@
+#include "sourcerer/bind.hpp"
+
+#include <utility>
+
+#include "sourcerer/path.hpp"
+
+namespace sourcerer {
+
+namespace {
+
+std::string message_of(const std::vector<BindError>& errors) {
+  std::string message = "Failed to bind " + std::to_string(errors.size()) + " value(s):";
+  for (const auto& error : errors) {
+    message += "\n  " + (error.path.empty() ? std::string{"<root>"} : error.path) + ": " +
+               error.message;
+  }
+  return message;
+}
+
+}  // namespace
+
+BindErrors::BindErrors(std::vector<BindError> errors)
+    : std::invalid_argument{message_of(errors)}, errors_{std::move(errors)} {}
+
+bool Binder::expect(const Node& node, const detail::node_kind kind, const Step* step) {
+  if (node.kind_ == kind) return true;
+
+  fail(step, "Expected " + detail::type_name(kind) + ", got " + detail::type_name(node.kind_));
+  return false;
+}
+
+void Binder::fail(const Step* step, std::string message) {
+  std::vector<const Step*> steps;
+  for (; step != nullptr; step = step->parent) {
+    steps.push_back(step);
+  }
+
+  std::string path;
+  for (auto it = steps.rbegin(); it != steps.rend(); ++it) {
+    if ((*it)->index == Step::key) {
+      detail::append_key(path, (*it)->name);
+    } else {
+      detail::append_index(path, (*it)->index);
+    }
+  }
+  errors_.push_back({std::move(path), std::move(message)});
+}
+
+}  // namespace sourcerer
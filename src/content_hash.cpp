@@ -0,0 +1,83 @@
+#include "sourcerer/detail/content_hash.hpp"
+
+#include <bit>
+#include <cstring>
+
+namespace sourcerer {
+
+namespace detail {
+
+namespace {
+
+constexpr std::uint64_t prime1 = 0x9e3779b185ebca87ULL;
+constexpr std::uint64_t prime2 = 0xc2b2ae3d27d4eb4fULL;
+constexpr std::uint64_t prime3 = 0x165667b19e3779f9ULL;
+constexpr std::uint64_t prime4 = 0x85ebca77c2b2ae63ULL;
+constexpr std::uint64_t prime5 = 0x27d4eb2f165667c5ULL;
+
+template <class T>
+T load(const char* data) noexcept {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+std::uint64_t round(std::uint64_t acc, const std::uint64_t input) noexcept {
+  acc += input * prime2;
+  return std::rotl(acc, 31) * prime1;
+}
+
+std::uint64_t merge(const std::uint64_t acc, const std::uint64_t lane) noexcept {
+  return (acc ^ round(0, lane)) * prime1 + prime4;
+}
+
+}  // namespace
+
+std::uint64_t content_hash(std::string_view text) noexcept {
+  const auto* data = text.data();
+  const auto* const end = data + text.size();
+
+  std::uint64_t hash;
+  if (text.size() >= 32) {
+    // Four independent lanes keep the multipliers busy.
+    std::uint64_t lanes[] = {prime1 + prime2, prime2, 0, 0 - prime1};
+    for (; end - data >= 32; data += 32) {
+      for (int i = 0; i < 4; ++i) {
+        lanes[i] = round(lanes[i], load<std::uint64_t>(data + 8 * i));
+      }
+    }
+    hash = std::rotl(lanes[0], 1) + std::rotl(lanes[1], 7) + std::rotl(lanes[2], 12) +
+           std::rotl(lanes[3], 18);
+    for (const auto lane : lanes) {
+      hash = merge(hash, lane);
+    }
+  } else {
+    hash = prime5;
+  }
+  hash += text.size();
+
+  for (; end - data >= 8; data += 8) {
+    hash ^= round(0, load<std::uint64_t>(data));
+    hash = std::rotl(hash, 27) * prime1 + prime4;
+  }
+  if (end - data >= 4) {
+    hash ^= load<std::uint32_t>(data) * prime1;
+    hash = std::rotl(hash, 23) * prime2 + prime3;
+    data += 4;
+  }
+  for (; data != end; ++data) {
+    hash ^= static_cast<std::uint8_t>(*data) * prime5;
+    hash = std::rotl(hash, 11) * prime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= prime2;
+  hash ^= hash >> 29;
+  hash *= prime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+}  // namespace detail
+
+}  // namespace sourcerer
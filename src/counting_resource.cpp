@@ -0,0 +1,43 @@
+#include "sourcerer/counting_resource.hpp"
+
+namespace sourcerer {
+
+AllocationStats CountingResource::stats() const noexcept {
+  return {allocations_.load(std::memory_order_relaxed),
+          deallocations_.load(std::memory_order_relaxed), bytes_.load(std::memory_order_relaxed),
+          peak_bytes_.load(std::memory_order_relaxed),
+          total_bytes_.load(std::memory_order_relaxed)};
+}
+
+void CountingResource::reset() noexcept {
+  allocations_.store(0, std::memory_order_relaxed);
+  deallocations_.store(0, std::memory_order_relaxed);
+  peak_bytes_.store(bytes_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  total_bytes_.store(0, std::memory_order_relaxed);
+}
+
+void* CountingResource::do_allocate(const std::size_t bytes, const std::size_t alignment) {
+  auto* p = upstream_->allocate(bytes, alignment);
+
+  allocations_.fetch_add(1, std::memory_order_relaxed);
+  total_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+  const auto current = bytes_.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+  auto peak = peak_bytes_.load(std::memory_order_relaxed);
+  while (peak < current &&
+         !peak_bytes_.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+  }
+  return p;
+}
+
+void CountingResource::do_deallocate(void* p, const std::size_t bytes,
+                                     const std::size_t alignment) {
+  upstream_->deallocate(p, bytes, alignment);
+  deallocations_.fetch_add(1, std::memory_order_relaxed);
+  bytes_.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+bool CountingResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+}  // namespace sourcerer
@@ -0,0 +1,83 @@
+#include "sourcerer/diff.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace sourcerer {
+
+// Walks two trees side by side, down the subtrees whose hashes differ.
+class Differ {
+ public:
+  explicit Differ(Diff& result) : result_{result} {}
+
+  void compare(const Node& before, const Node& after) {
+    if (same(before, after)) return;
+
+    if (before.is_object() && after.is_object()) {
+      compare(before.get<Node::object_t>(), after.get<Node::object_t>());
+    } else if (before.is_array() && after.is_array()) {
+      compare(before.get<Node::array_t>(), after.get<Node::array_t>());
+    } else {
+      result_.changed.emplace_back(path_);
+    }
+  }
+
+ private:
+  // Containers with equal hashes are taken to be equal, scalars are compared as well. Looking into
+  // containers would cost walking all of both trees.
+  static bool same(const Node& before, const Node& after) {
+    if (before.hash() != after.hash()) return false;
+    return before.is_object() || before.is_array() || before == after;
+  }
+
+  void compare(const Node::object_t& before, const Node::object_t& after) {
+    const auto length = path_.size();
+    for (const auto& [key, value] : before) {
+      const auto it = after.find(key.view());
+      if (it != after.end() && same(value, it->second)) continue;
+
+      detail::append_key(path_, key.view());
+      if (it == after.end()) {
+        result_.removed.emplace_back(path_);
+      } else {
+        compare(value, it->second);
+      }
+      path_.resize(length);
+    }
+    for (const auto& [key, value] : after) {
+      if (before.contains(key.view())) continue;
+      detail::append_key(path_, key.view());
+      result_.added.emplace_back(path_);
+      path_.resize(length);
+    }
+  }
+
+  void compare(const Node::array_t& before, const Node::array_t& after) {
+    const auto length = path_.size();
+    for (std::size_t i = 0; i < std::max(before.size(), after.size()); ++i) {
+      // The path is only built for the elements that differ.
+      if (i < before.size() && i < after.size() && same(before[i], after[i])) continue;
+
+      detail::append_index(path_, i);
+      if (i >= after.size()) {
+        result_.removed.emplace_back(path_);
+      } else if (i >= before.size()) {
+        result_.added.emplace_back(path_);
+      } else {
+        compare(before[i], after[i]);
+      }
+      path_.resize(length);
+    }
+  }
+
+  Diff& result_;
+  std::string path_;
+};
+
+Diff diff(const Node& before, const Node& after) {
+  Diff result;
+  Differ{result}.compare(before, after);
+  return result;
+}
+
+}  // namespace sourcerer
@@ -0,0 +1,38 @@
+#include "sourcerer/error.hpp"
+
+#include <stdexcept>
+
+namespace sourcerer {
+
+std::string error::message() const {
+  switch (code_) {
+    case errc::wrong_type:
+      return std::string{"Node is not of the requested type: "} + from_;
+    case errc::key_not_found:
+      return "Key not found";
+    case errc::index_out_of_range:
+      return "Index out of range";
+    case errc::not_convertible:
+      return std::string{"Can't convert "} + from_ + " to " + to_;
+    case errc::out_of_range:
+      return std::string{"Value can't be represented by type \""} + to_ + "\"";
+    case errc::invalid_number:
+      return std::string{"Failed to convert value to type \""} + to_ +
+             "\": not a number in range";
+  }
+
+  return "";  // Make compiler happy.
+}
+
+void error::raise() const {
+  switch (code_) {
+    case errc::key_not_found:
+    case errc::index_out_of_range:
+    case errc::out_of_range:
+      SOURCERER_THROW(std::out_of_range(message()));
+    default:
+      SOURCERER_THROW(std::invalid_argument(message()));
+  }
+}
+
+}  // namespace sourcerer
@@ -0,0 +1,325 @@
+#include "sourcerer/frozen_node.hpp"
+
+#include <limits>
+#include <span>
+#include <numeric>
+#include <unordered_set>
+
+#include "sourcerer/detail/perfect_hash.hpp"
+
+namespace sourcerer {
+
+namespace {
+
+std::uint32_t checked_size(const std::size_t size) {
+  if (size > std::numeric_limits<std::uint32_t>::max()) {
+    SOURCERER_THROW(std::length_error("Node is too large to be frozen"));
+  }
+  return static_cast<std::uint32_t>(size);
+}
+
+// Objects of up to this size are scanned when looking up a key by its text.
+constexpr std::uint32_t scan_threshold = 4;
+
+}  // namespace
+
+template <class K>
+const FrozenNode* FrozenNode::find(const K& key, const std::uint32_t hash) const noexcept {
+  const auto& table = *table_;
+  const auto matches = [&](const detail::frozen_slot& slot) {
+    return slot.hash == hash && slot.key == key;
+  };
+
+  std::uint32_t scanned_from = 0;
+  if (table.buckets != 0) {
+    const auto& slot = table.slots[detail::perfect_hash::lookup(
+        hash, {table.displacements, table.buckets}, table.placed)];
+    if (matches(slot)) return payload_.children + slot.index;
+
+    scanned_from = table.placed;
+  }
+
+  for (const auto& slot : std::span{table.slots + scanned_from, size_ - scanned_from}) {
+    if (matches(slot)) return payload_.children + slot.index;
+  }
+  return nullptr;
+}
+
+FrozenNode::const_reference FrozenNode::at(const size_type index) const {
+  detail::throw_if_not(detail::node_kind::array, kind_);
+  if (index >= size_) {
+    SOURCERER_THROW(std::out_of_range("Index out of range"));
+  }
+  return payload_.children[index];
+}
+
+FrozenNode::const_reference FrozenNode::at(std::string_view key) const {
+  if (const auto* value = find(key); value != nullptr) {
+    return *value;
+  }
+  SOURCERER_THROW(std::out_of_range("Key not found: " + std::string{key}));
+}
+
+FrozenNode::const_reference FrozenNode::at(const key_type& key) const {
+  if (const auto* value = find(key); value != nullptr) {
+    return *value;
+  }
+  SOURCERER_THROW(std::out_of_range("Key not found: " + std::string{key.view()}));
+}
+
+FrozenNode::const_reference FrozenNode::operator[](const size_type index) const noexcept {
+  return payload_.children[index];
+}
+
+FrozenNode::const_reference FrozenNode::operator[](std::string_view key) const noexcept {
+  return *find(key, Key::hash(key));
+}
+
+FrozenNode::const_reference FrozenNode::operator[](const key_type& key) const noexcept {
+  return *find(key, key.hash());
+}
+
+const FrozenNode* FrozenNode::find(std::string_view key) const {
+  detail::throw_if_not(detail::node_kind::object, kind_);
+  if (size_ <= scan_threshold) {
+    // Comparing a few keys is cheaper than hashing the one looked up.
+    for (const auto& slot : std::span{table_->slots, size_}) {
+      if (slot.key == key) return payload_.children + slot.index;
+    }
+    return nullptr;
+  }
+  return find(key, Key::hash(key));
+}
+
+const FrozenNode* FrozenNode::find(const key_type& key) const {
+  detail::throw_if_not(detail::node_kind::object, kind_);
+  return find(key, key.hash());
+}
+
+FrozenNode::size_type FrozenNode::size() const noexcept {
+  switch (kind_) {
+    case detail::node_kind::null:
+      return 0;
+    case detail::node_kind::array:
+    case detail::node_kind::object:
+      return size_;
+    default:
+      return 1;
+  }
+}
+
+FrozenNode::const_iterator FrozenNode::begin() const noexcept {
+  if (kind_ == detail::node_kind::array || kind_ == detail::node_kind::object) {
+    return payload_.children;
+  }
+  // Values iterate over themselves.
+  return this;
+}
+
+struct FrozenTree::Sizes {
+  std::size_t nodes = 1;
+  std::size_t objects = 0;
+  std::size_t keys = 0;
+  std::size_t buckets = 0;
+  std::size_t chars = 0;
+};
+
+struct FrozenTree::Scratch {
+  std::unordered_set<const KeyPool*> pools;
+  std::vector<Key> keys;
+  std::vector<std::uint32_t> hashes;
+  // The positions of the keys, ordered by hash.
+  std::vector<std::uint32_t> order;
+  // The first key of every distinct hash, its hash and its slot.
+  std::vector<std::uint32_t> firsts;
+  std::vector<std::uint32_t> distinct;
+  std::vector<std::uint32_t> slots;
+  // The key placed in every slot.
+  std::vector<std::uint32_t> owners;
+};
+
+FrozenTree::FrozenTree(const Node& node) {
+  Sizes sizes;
+  count(node, sizes);
+
+  nodes_.reserve(sizes.nodes);
+  tables_.reserve(sizes.objects);
+  slots_.reserve(sizes.keys);
+  displacements_.reserve(sizes.buckets);
+  strings_.reserve(sizes.chars);
+
+  Scratch scratch;
+  freeze(nodes_.emplace_back(), node, scratch);
+}
+
+std::size_t FrozenTree::bytes() const noexcept {
+  return nodes_.size() * sizeof(FrozenNode) + tables_.size() * sizeof(detail::frozen_table) +
+         slots_.size() * sizeof(detail::frozen_slot) +
+         displacements_.size() * sizeof(std::uint32_t) + strings_.size();
+}
+
+void FrozenTree::count(const Node& node, Sizes& sizes) {
+  switch (node.kind_) {
+    case detail::node_kind::string:
+      sizes.chars += node.string().size();
+      break;
+    case detail::node_kind::array:
+      sizes.nodes += node.size();
+      break;
+    case detail::node_kind::object: {
+      const auto& object = node.get<Node::object_t>();
+      sizes.nodes += object.size();
+      sizes.objects += 1;
+      sizes.keys += object.size();
+      sizes.buckets += detail::perfect_hash::buckets_for(object.size());
+      break;
+    }
+    default:
+      break;
+  }
+
+  for (const auto& child : node) {
+    if (&child != &node) {
+      count(child, sizes);
+    }
+  }
+}
+
+void FrozenTree::freeze(FrozenNode& target, const Node& node, Scratch& scratch) {
+  target.kind_ = node.kind_;
+  switch (node.kind_) {
+    case detail::node_kind::boolean:
+      target.payload_.boolean = node.payload<bool>();
+      break;
+    case detail::node_kind::integer:
+      target.payload_.integer = node.payload<std::int64_t>();
+      break;
+    case detail::node_kind::unsigned_integer:
+      target.payload_.unsigned_integer = node.payload<std::uint64_t>();
+      break;
+    case detail::node_kind::floating:
+      target.payload_.floating = node.payload<double>();
+      break;
+    case detail::node_kind::string: {
+      const auto value = node.string();
+      target.payload_.string = store(value);
+      target.size_ = checked_size(value.size());
+      break;
+    }
+    case detail::node_kind::array: {
+      const auto& array = node.get<Node::array_t>();
+      const auto first = nodes_.size();
+      // Within the reserved capacity, so target stays valid.
+      nodes_.resize(first + array.size());
+      target.payload_.children = nodes_.data() + first;
+      target.size_ = checked_size(array.size());
+      for (std::size_t i = 0; i < array.size(); ++i) {
+        freeze(nodes_[first + i], array[i], scratch);
+      }
+      break;
+    }
+    case detail::node_kind::object:
+      freeze_object(target, node.get<Node::object_t>(), scratch);
+      break;
+    default:
+      break;
+  }
+}
+
+void FrozenTree::freeze_object(FrozenNode& target, const Node::object_t& object,
+                               Scratch& scratch) {
+  const auto size = checked_size(object.size());
+  const auto first = nodes_.size();
+  nodes_.resize(first + size);
+  target.payload_.children = nodes_.data() + first;
+  target.size_ = size;
+
+  // The slots refer to the interned keys, which have to outlive the tree.
+  const auto& pool = object.keys();
+  if (pool != nullptr && scratch.pools.insert(pool.get()).second) {
+    pools_.push_back(pool);
+  }
+
+  auto& keys = scratch.keys;
+  auto& hashes = scratch.hashes;
+  keys.clear();
+  hashes.clear();
+  for (const auto& [key, value] : object) {
+    keys.push_back(key);
+    hashes.push_back(key.hash());
+  }
+  const auto slot_of = [&](const std::uint32_t i) {
+    return detail::frozen_slot{keys[i], hashes[i], i};
+  };
+
+  // Only distinct hashes can be placed by a perfect hash, keys with the hash of an earlier key are
+  // stored after the placed ones.
+  auto& order = scratch.order;
+  order.resize(size);
+  std::iota(order.begin(), order.end(), std::uint32_t{0});
+  std::ranges::stable_sort(order, std::less<>{}, [&](const std::uint32_t i) { return hashes[i]; });
+
+  auto& firsts = scratch.firsts;
+  auto& distinct = scratch.distinct;
+  firsts.clear();
+  distinct.clear();
+  for (const auto i : order) {
+    if (distinct.empty() || distinct.back() != hashes[i]) {
+      firsts.push_back(i);
+      distinct.push_back(hashes[i]);
+    }
+  }
+  const auto placed = static_cast<std::uint32_t>(distinct.size());
+
+  const auto first_bucket = displacements_.size();
+  const auto buckets = detail::perfect_hash::buckets_for(placed);
+  displacements_.resize(first_bucket + buckets);
+  const auto displacements = std::span{displacements_}.subspan(first_bucket, buckets);
+
+  auto& slots = scratch.slots;
+  slots.resize(placed);
+  const auto perfect = detail::perfect_hash::build(distinct, displacements, slots);
+
+  const auto first_slot = slots_.size();
+  if (perfect) {
+    auto& owners = scratch.owners;
+    owners.resize(placed);
+    for (std::uint32_t j = 0; j < placed; ++j) {
+      owners[slots[j]] = firsts[j];
+    }
+    for (const auto i : owners) {
+      slots_.push_back(slot_of(i));
+    }
+
+    for (std::size_t k = 1; k < order.size(); ++k) {
+      if (hashes[order[k]] == hashes[order[k - 1]]) {
+        slots_.push_back(slot_of(order[k]));
+      }
+    }
+  } else {
+    // Only happens if no displacement fits, all keys are scanned then.
+    for (std::uint32_t i = 0; i < size; ++i) {
+      slots_.push_back(slot_of(i));
+    }
+  }
+
+  target.table_ = &tables_.emplace_back(detail::frozen_table{
+      displacements.data(), slots_.data() + first_slot,
+      perfect ? static_cast<std::uint32_t>(buckets) : 0, placed});
+
+  std::uint32_t index = 0;
+  for (const auto& [key, value] : object) {
+    freeze(nodes_[first + index], value, scratch);
+    ++index;
+  }
+}
+
+const char* FrozenTree::store(std::string_view text) {
+  const auto offset = strings_.size();
+  strings_.insert(strings_.end(), text.begin(), text.end());
+  return strings_.data() + offset;
+}
+
+FrozenTree freeze(const Node& node) { return FrozenTree{node}; }
+
+}  // namespace sourcerer
@@ -0,0 +1,478 @@
+#include "sourcerer/detail/json_index.hpp"
+
+#include <charconv>
+#include <cstdlib>
+#include <stdexcept>
+#include <variant>
+
+#include "sourcerer/node_builder.hpp"
+
+namespace sourcerer::detail {
+
+namespace {
+
+bool is_digit(const char c) noexcept { return c >= '0' && c <= '9'; }
+
+int hex_value(const char c) noexcept {
+  if (is_digit(c)) return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// Reads the four hex digits at the start of text, which have been validated.
+std::uint32_t code_unit(std::string_view text) noexcept {
+  std::uint32_t value = 0;
+  for (const auto c : text.substr(0, 4)) {
+    value = value * 16 + static_cast<std::uint32_t>(hex_value(c));
+  }
+  return value;
+}
+
+bool is_high_surrogate(const std::uint32_t unit) noexcept {
+  return unit >= 0xd800 && unit <= 0xdbff;
+}
+bool is_low_surrogate(const std::uint32_t unit) noexcept {
+  return unit >= 0xdc00 && unit <= 0xdfff;
+}
+
+bool is_delimiter(const char c) noexcept {
+  switch (c) {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+    case ',':
+    case ':':
+    case '}':
+    case ']':
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Builds the tape from the structural characters a json_scanner finds, and only looks at the
+// characters of the numbers, literals and escapes in between.
+class Indexer {
+ public:
+  Indexer(std::string_view text, const simd_level level, std::vector<json_token>& tape)
+      : text_{text}, scanner_{text, level}, tape_{tape} {}
+
+  void index() {
+    // The open containers, as positions on the tape.
+    std::vector<std::uint32_t> open;
+
+    advance();
+    for (;;) {
+      if (value(open)) {
+        // An empty container or a scalar, either way a complete value.
+        if (close(open)) return;
+      }
+    }
+  }
+
+ private:
+  bool done() const noexcept { return position_ == text_.size(); }
+  char peek() const noexcept { return done() ? '\0' : text_[position_]; }
+
+  // Moves to the next structural character, or to the end of the text if there is none.
+  void advance() {
+    while (next_ == positions_.size()) {
+      positions_.clear();
+      next_ = 0;
+      if (!scanner_.next(positions_)) {
+        position_ = text_.size();
+        return;
+      }
+    }
+    position_ = positions_[next_++];
+  }
+
+  [[noreturn]] void fail(const std::string& reason) const { fail_at(position_, reason); }
+  [[noreturn]] void fail_at(const std::size_t position, const std::string& reason) const {
+    SOURCERER_THROW(std::invalid_argument("Invalid JSON at position " + std::to_string(position) +
+                                          ": " + reason));
+  }
+
+  void expect(const char c) {
+    if (peek() != c) fail(std::string{"expected '"} + c + "'");
+    advance();
+  }
+
+  std::uint32_t push(const std::uint32_t extent) {
+    tape_.push_back({static_cast<std::uint32_t>(position_), extent});
+    return static_cast<std::uint32_t>(tape_.size() - 1);
+  }
+
+  // Indexes the start of a value. Returns true if the value is complete, false if it opened a
+  // container with children to come.
+  bool value(std::vector<std::uint32_t>& open) {
+    switch (peek()) {
+      case '{':
+      case '[': {
+        const auto object = peek() == '{';
+        open.push_back(push(0));
+        advance();
+        if (peek() == (object ? '}' : ']')) {
+          tape_[open.back()].extent = static_cast<std::uint32_t>(tape_.size());
+          open.pop_back();
+          advance();
+          return true;
+        }
+        if (object) member();
+        return false;
+      }
+      case '"':
+        string();
+        return true;
+      case 't':
+        scalar(literal("true"));
+        return true;
+      case 'f':
+        scalar(literal("false"));
+        return true;
+      case 'n':
+        scalar(literal("null"));
+        return true;
+      default:
+        if (peek() == '-' || is_digit(peek())) {
+          scalar(number());
+          return true;
+        }
+        fail("expected a value");
+    }
+  }
+
+  // Indexes the key of an object member and its colon.
+  void member() {
+    if (peek() != '"') fail("expected a key");
+    string();
+    expect(':');
+  }
+
+  // Moves past the separators after a complete value, closing the containers it completes. Returns
+  // true once the root is complete.
+  bool close(std::vector<std::uint32_t>& open) {
+    for (;;) {
+      if (open.empty()) {
+        if (!done()) fail("expected the end of the text");
+        return true;
+      }
+
+      const auto object = text_[tape_[open.back()].offset] == '{';
+      if (peek() == ',') {
+        advance();
+        if (object) member();
+        return false;
+      }
+      if (peek() != (object ? '}' : ']')) {
+        fail(object ? "expected ',' or '}'" : "expected ',' or ']'");
+      }
+
+      tape_[open.back()].extent = static_cast<std::uint32_t>(tape_.size());
+      open.pop_back();
+      advance();
+    }
+  }
+
+  void string() {
+    const auto pos = push(0);
+    const auto first = position_ + 1;
+    // Nothing inside a string is structural, the next quote closes it.
+    advance();
+    if (done()) fail_at(first - 1, "unterminated string");
+
+    const auto raw = text_.substr(first, position_ - first);
+    std::uint32_t flags = 0;
+    if (raw.find('\\') != std::string_view::npos) {
+      flags = json_index::escaped;
+      escapes(raw, first);
+    }
+    tape_[pos].extent = static_cast<std::uint32_t>(raw.size()) | flags;
+    advance();
+  }
+
+  // Validates the escapes of the contents of a string starting at first, so that strings can be
+  // unescaped without checking them again.
+  void escapes(std::string_view raw, const std::size_t first) const {
+    for (std::size_t i = raw.find('\\'); i != std::string_view::npos; i = raw.find('\\', i)) {
+      const auto escape = i + 1 < raw.size() ? raw[i + 1] : '\0';
+      switch (escape) {
+        case '"':
+        case '\\':
+        case '/':
+        case 'b':
+        case 'f':
+        case 'n':
+        case 'r':
+        case 't':
+          i += 2;
+          break;
+        case 'u': {
+          const auto unit = hex_digits(raw, i + 2, first);
+          if (is_low_surrogate(unit)) fail_at(first + i, "lone low surrogate");
+          if (is_high_surrogate(unit)) {
+            // A high surrogate, which has to be followed by a low one.
+            if (raw.substr(i + 6, 2) != "\\u" || !is_low_surrogate(hex_digits(raw, i + 8, first))) {
+              fail_at(first + i, "lone high surrogate");
+            }
+            i += 6;
+          }
+          i += 6;
+          break;
+        }
+        default:
+          fail_at(first + i + 1, "invalid escape");
+      }
+    }
+  }
+
+  // Validates the four hex digits of an escaped code unit at position at of raw, returns its value.
+  std::uint32_t hex_digits(std::string_view raw, const std::size_t at,
+                           const std::size_t first) const {
+    for (std::size_t j = at; j < at + 4; ++j) {
+      if (j >= raw.size() || hex_value(raw[j]) < 0) {
+        fail_at(first + j, "expected four hex digits after '\\u'");
+      }
+    }
+    return code_unit(raw.substr(at));
+  }
+
+  // Returns the end of the number at the current position.
+  std::size_t number() {
+    auto end = position_;
+    const auto at = [&] { return end < text_.size() ? text_[end] : '\0'; };
+    const auto digits = [&] {
+      while (is_digit(at())) ++end;
+    };
+    const auto expect_digit = [&] {
+      if (!is_digit(at())) fail_at(end, "expected a digit");
+    };
+
+    if (at() == '-') ++end;
+    if (at() == '0') {
+      ++end;
+    } else {
+      expect_digit();
+      digits();
+    }
+    if (at() == '.') {
+      ++end;
+      expect_digit();
+      digits();
+    }
+    if (at() == 'e' || at() == 'E') {
+      ++end;
+      if (at() == '+' || at() == '-') ++end;
+      expect_digit();
+      digits();
+    }
+    return end;
+  }
+
+  // Returns the end of the literal expected at the current position.
+  std::size_t literal(std::string_view expected) const {
+    if (text_.substr(position_, expected.size()) != expected) {
+      fail("expected '" + std::string{expected} + "'");
+    }
+    return position_ + expected.size();
+  }
+
+  // Indexes the number or literal from the current position to end.
+  void scalar(const std::size_t end) {
+    if (end != text_.size() && !is_delimiter(text_[end])) {
+      fail_at(end, "expected a delimiter after the value");
+    }
+    push(static_cast<std::uint32_t>(end - position_));
+    advance();
+  }
+
+  std::string_view text_;
+  json_scanner scanner_;
+  std::vector<json_token>& tape_;
+
+  // The structural characters of the current chunk, and the next one of them.
+  std::vector<std::uint32_t> positions_;
+  std::size_t next_ = 0;
+  std::size_t position_ = 0;
+};
+
+void append_utf8(const std::uint32_t code_point, std::string& out) {
+  if (code_point < 0x80) {
+    out.push_back(static_cast<char>(code_point));
+  } else if (code_point < 0x800) {
+    out.push_back(static_cast<char>(0xc0 | (code_point >> 6)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+  } else if (code_point < 0x10000) {
+    out.push_back(static_cast<char>(0xe0 | (code_point >> 12)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+  } else {
+    out.push_back(static_cast<char>(0xf0 | (code_point >> 18)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 12) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | ((code_point >> 6) & 0x3f)));
+    out.push_back(static_cast<char>(0x80 | (code_point & 0x3f)));
+  }
+}
+
+}  // namespace
+
+json_index::json_index(std::string_view text, const simd_level level) : text_{text} {
+  if (text.size() >= escaped) {
+    SOURCERER_THROW(std::length_error("JSON text is too large to be indexed"));
+  }
+
+  // Most documents have a token every ten bytes or so. Shrinking the tape afterwards would need a
+  // copy of it, and double the peak memory of indexing.
+  tape_.reserve(text.size() / 8 + 1);
+  Indexer{text, level, tape_}.index();
+}
+
+node_kind json_index::kind(const std::uint32_t pos) const {
+  switch (first_char(pos)) {
+    case '{':
+      return node_kind::object;
+    case '[':
+      return node_kind::array;
+    case '"':
+      return node_kind::string;
+    case 't':
+    case 'f':
+      return node_kind::boolean;
+    case 'n':
+      return node_kind::null;
+    default:
+      switch (number(pos).index()) {
+        case 0:
+          return node_kind::integer;
+        case 1:
+          return node_kind::unsigned_integer;
+        default:
+          return node_kind::floating;
+      }
+  }
+}
+
+std::string json_index::string(const std::uint32_t pos) const {
+  const auto raw = raw_string(pos);
+  if (!is_escaped(pos)) return std::string{raw};
+
+  std::string text;
+  text.reserve(raw.size());
+  unescape(raw, text);
+  return text;
+}
+
+json_index::number_t json_index::number(const std::uint32_t pos) const {
+  const auto token = text_.substr(tape_[pos].offset, tape_[pos].extent);
+  const auto* first = token.data();
+  const auto* last = first + token.size();
+
+  // Like nlohmann::json, integers are signed only if they are negative, and those that don't fit
+  // into 64 bits become floating point numbers.
+  if (token.find_first_of(".eE") == std::string_view::npos) {
+    if (token.front() == '-') {
+      std::int64_t value = 0;
+      if (std::from_chars(first, last, value).ec == std::errc{}) return value;
+    } else {
+      std::uint64_t value = 0;
+      if (std::from_chars(first, last, value).ec == std::errc{}) return value;
+    }
+  }
+
+  double value = 0;
+  if (std::from_chars(first, last, value).ec == std::errc{}) return value;
+  // Out of range, strtod rounds to zero or infinity like nlohmann::json does.
+  return std::strtod(std::string{token}.c_str(), nullptr);
+}
+
+void json_index::build(NodeBuilder& builder, const std::uint32_t pos) const {
+  switch (first_char(pos)) {
+    case '{': {
+      builder.begin_object();
+      const auto end = skip(pos);
+      for (auto key = pos + 1; key < end; key = skip(key + 1)) {
+        if (is_escaped(key)) {
+          builder.key(string(key));
+        } else {
+          builder.key(raw_string(key));
+        }
+        build(builder, key + 1);
+      }
+      builder.end_object();
+      break;
+    }
+    case '[': {
+      builder.begin_array();
+      const auto end = skip(pos);
+      for (auto child = pos + 1; child < end; child = skip(child)) {
+        build(builder, child);
+      }
+      builder.end_array();
+      break;
+    }
+    case '"':
+      if (is_escaped(pos)) {
+        builder.value(string(pos));
+      } else {
+        builder.value(raw_string(pos));
+      }
+      break;
+    case 't':
+    case 'f':
+      builder.value(boolean(pos));
+      break;
+    case 'n':
+      builder.value();
+      break;
+    default:
+      std::visit([&](const auto number) { builder.value(number); }, number(pos));
+      break;
+  }
+}
+
+void json_index::unescape(std::string_view raw, std::string& out) {
+  for (std::size_t i = 0; i < raw.size(); ++i) {
+    if (raw[i] != '\\') {
+      out.push_back(raw[i]);
+      continue;
+    }
+
+    switch (raw[++i]) {
+      case 'b':
+        out.push_back('\b');
+        break;
+      case 'f':
+        out.push_back('\f');
+        break;
+      case 'n':
+        out.push_back('\n');
+        break;
+      case 'r':
+        out.push_back('\r');
+        break;
+      case 't':
+        out.push_back('\t');
+        break;
+      case 'u': {
+        auto code_point = code_unit(raw.substr(i + 1));
+        i += 4;
+        if (is_high_surrogate(code_point)) {
+          // The index checked that a low surrogate follows.
+          const auto low = code_unit(raw.substr(i + 3));
+          code_point = 0x10000 + ((code_point - 0xd800) << 10) + (low - 0xdc00);
+          i += 6;
+        }
+        append_utf8(code_point, out);
+        break;
+      }
+      default:
+        // '"', '\\' and '/' stand for themselves.
+        out.push_back(raw[i]);
+        break;
+    }
+  }
+}
+
+}  // namespace sourcerer::detail
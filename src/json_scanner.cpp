@@ -0,0 +1,395 @@
+#include "sourcerer/detail/json_scanner.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SOURCERER_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace sourcerer::detail {
+
+namespace {
+
+constexpr std::size_t block_size = 64;
+// The blocks scanned by one call of next(), 64 KiB.
+constexpr std::size_t chunk_blocks = 1024;
+
+// The characters of a block that belong to each class, one bit per byte.
+struct block_masks {
+  std::uint64_t quote;
+  std::uint64_t backslash;
+  // Brackets, colons and commas.
+  std::uint64_t structural;
+  std::uint64_t whitespace;
+  // Bytes below 0x20.
+  std::uint64_t control;
+  std::uint64_t non_ascii;
+};
+
+// Sets every bit from a set bit up to the next one, exclusive.
+constexpr std::uint64_t prefix_xor(std::uint64_t x) noexcept {
+  x ^= x << 1;
+  x ^= x << 2;
+  x ^= x << 4;
+  x ^= x << 8;
+  x ^= x << 16;
+  x ^= x << 32;
+  return x;
+}
+
+// Returns the characters escaped by a backslash, which are the ones following an odd run of them.
+// Backslashes are rare, so they are simply walked.
+inline std::uint64_t find_escaped(std::uint64_t backslash, std::uint64_t& carry) noexcept {
+  std::uint64_t escaped = carry;
+  backslash &= ~carry;
+  carry = 0;
+  while (backslash != 0) {
+    const auto bit = backslash & (~backslash + 1);
+    escaped |= bit << 1;
+    carry = bit >> 63;
+    // The escaped character doesn't escape anything, even if it is a backslash.
+    backslash &= ~(bit | (bit << 1));
+  }
+  return escaped;
+}
+
+// Validates the UTF-8 of a block. Returns the offset of the first invalid byte, or block_size.
+inline std::size_t validate_utf8(const char* block, const std::uint64_t non_ascii,
+                                 json_scan_state& state) noexcept {
+  auto i = state.utf8_pending != 0 ? 0 : static_cast<std::size_t>(std::countr_zero(non_ascii));
+  while (i < block_size) {
+    const auto c = static_cast<std::uint8_t>(block[i]);
+    if (state.utf8_pending != 0) {
+      if (c < state.utf8_low || c > state.utf8_high) return i;
+      --state.utf8_pending;
+      state.utf8_low = 0x80;
+      state.utf8_high = 0xbf;
+      ++i;
+      continue;
+    }
+
+    if (c < 0x80) {
+      // Skip ahead to the next byte that starts a sequence.
+      const auto rest = non_ascii & (~std::uint64_t{0} << i);
+      if (rest == 0) break;
+      i = static_cast<std::size_t>(std::countr_zero(rest));
+      continue;
+    }
+
+    // The ranges exclude overlong encodings, surrogates and code points above U+10FFFF.
+    if (c >= 0xc2 && c <= 0xdf) {
+      state.utf8_pending = 1;
+    } else if (c == 0xe0) {
+      state.utf8_pending = 2;
+      state.utf8_low = 0xa0;
+    } else if ((c >= 0xe1 && c <= 0xec) || c == 0xee || c == 0xef) {
+      state.utf8_pending = 2;
+    } else if (c == 0xed) {
+      state.utf8_pending = 2;
+      state.utf8_high = 0x9f;
+    } else if (c == 0xf0) {
+      state.utf8_pending = 3;
+      state.utf8_low = 0x90;
+    } else if (c >= 0xf1 && c <= 0xf3) {
+      state.utf8_pending = 3;
+    } else if (c == 0xf4) {
+      state.utf8_pending = 3;
+      state.utf8_high = 0x8f;
+    } else {
+      return i;
+    }
+    ++i;
+  }
+  return block_size;
+}
+
+inline void fail(json_scan_state& state, const char* error, const std::size_t position) noexcept {
+  state.error = error;
+  state.error_position = position;
+}
+
+// Turns the classified characters of a block into its structural ones and writes their positions
+// to out, which needs room for a whole block. Returns the end of the positions written, or nullptr
+// on an error, which is recorded in state.
+inline std::uint32_t* finish_block(const block_masks& masks, const char* block,
+                                   const std::uint32_t offset, json_scan_state& state,
+                                   std::uint32_t* out) noexcept {
+  std::uint64_t escaped = 0;
+  if (masks.backslash != 0 || state.escaped != 0) {
+    escaped = find_escaped(masks.backslash, state.escaped);
+  }
+
+  // Opening quotes are inside their string, closing ones aren't.
+  const auto quotes = masks.quote & ~escaped;
+  const auto in_string = prefix_xor(quotes) ^ state.in_string;
+  state.in_string = static_cast<std::uint64_t>(static_cast<std::int64_t>(in_string) >> 63);
+
+  if (const auto control = masks.control & in_string; control != 0) {
+    fail(state, "control character in string", offset + std::countr_zero(control));
+    return nullptr;
+  }
+  if (masks.non_ascii != 0 || state.utf8_pending != 0) {
+    const auto invalid = validate_utf8(block, masks.non_ascii, state);
+    if (invalid != block_size) {
+      fail(state, "invalid UTF-8", offset + invalid);
+      return nullptr;
+    }
+  }
+
+  // Numbers and literals are reported by their first character.
+  const auto scalar = ~(masks.structural | masks.whitespace | masks.quote | in_string);
+  const auto scalar_starts = scalar & ~((scalar << 1) | (state.in_scalar & 1));
+  state.in_scalar = static_cast<std::uint64_t>(static_cast<std::int64_t>(scalar) >> 63);
+
+  auto structural = (masks.structural & ~in_string) | quotes | scalar_starts;
+  const auto count = std::popcount(structural);
+  // Positions are written four at a time, which keeps the loop free of hard to predict branches.
+  // Writing past the last one is fine, out has room for a whole block.
+  for (int i = 0; i < count; i += 4) {
+    for (int j = 0; j < 4; ++j) {
+      out[i + j] = offset + static_cast<std::uint32_t>(std::countr_zero(structural));
+      structural &= structural - 1;
+    }
+  }
+  return out + count;
+}
+
+enum char_class : std::uint8_t {
+  quote_class = 1,
+  backslash_class = 2,
+  structural_class = 4,
+  whitespace_class = 8,
+  control_class = 16,
+  non_ascii_class = 32,
+};
+
+constexpr auto char_classes = [] {
+  std::array<std::uint8_t, 256> classes{};
+  for (std::size_t c = 0; c < 0x20; ++c) classes[c] = control_class;
+  for (std::size_t c = 0x80; c < 0x100; ++c) classes[c] = non_ascii_class;
+  classes['"'] = quote_class;
+  classes['\\'] = backslash_class;
+  for (const auto c : {'{', '}', '[', ']', ':', ','}) {
+    classes[static_cast<std::uint8_t>(c)] = structural_class;
+  }
+  for (const auto c : {' ', '\t', '\n', '\r'}) {
+    classes[static_cast<std::uint8_t>(c)] |= whitespace_class;
+  }
+  return classes;
+}();
+
+block_masks classify_portable(const char* block) noexcept {
+  block_masks masks{};
+  for (std::size_t i = 0; i < block_size; ++i) {
+    const std::uint64_t c = char_classes[static_cast<std::uint8_t>(block[i])];
+    masks.quote |= (c & 1) << i;
+    masks.backslash |= ((c >> 1) & 1) << i;
+    masks.structural |= ((c >> 2) & 1) << i;
+    masks.whitespace |= ((c >> 3) & 1) << i;
+    masks.control |= ((c >> 4) & 1) << i;
+    masks.non_ascii |= ((c >> 5) & 1) << i;
+  }
+  return masks;
+}
+
+std::uint32_t* scan_portable(const char* blocks, const std::size_t count,
+                             const std::uint32_t offset, json_scan_state& state,
+                             std::uint32_t* out) noexcept {
+  for (std::size_t b = 0; b < count && out != nullptr; ++b) {
+    const auto* block = blocks + b * block_size;
+    const auto at = offset + static_cast<std::uint32_t>(b * block_size);
+    out = finish_block(classify_portable(block), block, at, state, out);
+  }
+  return out;
+}
+
+#ifdef SOURCERER_X86_KERNELS
+
+// The kernels are compiled for their instruction set with target attributes, the library itself
+// keeps running on any x86-64 CPU.
+
+[[gnu::target("sse4.2"), gnu::always_inline]] inline std::uint64_t bits_sse42(
+    const __m128i (&v)[4]) noexcept {
+  std::uint64_t bits = 0;
+  for (int i = 0; i < 4; ++i) {
+    bits |= std::uint64_t{static_cast<std::uint16_t>(_mm_movemask_epi8(v[i]))} << (16 * i);
+  }
+  return bits;
+}
+
+[[gnu::target("sse4.2"), gnu::always_inline]] inline std::uint64_t equal_sse42(
+    const __m128i (&v)[4], const char c) noexcept {
+  const auto needle = _mm_set1_epi8(c);
+  const __m128i eq[4] = {_mm_cmpeq_epi8(v[0], needle), _mm_cmpeq_epi8(v[1], needle),
+                         _mm_cmpeq_epi8(v[2], needle), _mm_cmpeq_epi8(v[3], needle)};
+  return bits_sse42(eq);
+}
+
+[[gnu::target("sse4.2")]] block_masks classify_sse42(const char* block) noexcept {
+  __m128i v[4];
+  __m128i lower[4];
+  __m128i control[4];
+  const auto case_bit = _mm_set1_epi8(0x20);
+  const auto last_control = _mm_set1_epi8(0x1f);
+  for (int i = 0; i < 4; ++i) {
+    v[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i));
+    // '[' and ']' only differ from '{' and '}' in the case bit.
+    lower[i] = _mm_or_si128(v[i], case_bit);
+    control[i] = _mm_cmpeq_epi8(_mm_max_epu8(v[i], last_control), last_control);
+  }
+
+  block_masks masks;
+  masks.quote = equal_sse42(v, '"');
+  masks.backslash = equal_sse42(v, '\\');
+  masks.structural = equal_sse42(lower, '{') | equal_sse42(lower, '}') | equal_sse42(v, ':') |
+                     equal_sse42(v, ',');
+  masks.whitespace = equal_sse42(v, ' ') | equal_sse42(v, '\t') | equal_sse42(v, '\n') |
+                     equal_sse42(v, '\r');
+  masks.control = bits_sse42(control);
+  masks.non_ascii = bits_sse42(v);
+  return masks;
+}
+
+[[gnu::target("sse4.2")]] std::uint32_t* scan_sse42(const char* blocks, const std::size_t count,
+                                                    const std::uint32_t offset,
+                                                    json_scan_state& state,
+                                                    std::uint32_t* out) noexcept {
+  for (std::size_t b = 0; b < count && out != nullptr; ++b) {
+    const auto* block = blocks + b * block_size;
+    const auto at = offset + static_cast<std::uint32_t>(b * block_size);
+    out = finish_block(classify_sse42(block), block, at, state, out);
+  }
+  return out;
+}
+
+[[gnu::target("avx2"), gnu::always_inline]] inline std::uint64_t bits_avx2(
+    const __m256i low, const __m256i high) noexcept {
+  return std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(low))} |
+         std::uint64_t{static_cast<std::uint32_t>(_mm256_movemask_epi8(high))} << 32;
+}
+
+[[gnu::target("avx2"), gnu::always_inline]] inline std::uint64_t equal_avx2(
+    const __m256i low, const __m256i high, const char c) noexcept {
+  const auto needle = _mm256_set1_epi8(c);
+  return bits_avx2(_mm256_cmpeq_epi8(low, needle), _mm256_cmpeq_epi8(high, needle));
+}
+
+[[gnu::target("avx2")]] block_masks classify_avx2(const char* block) noexcept {
+  const auto low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+  const auto high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block + 32));
+  // '[' and ']' only differ from '{' and '}' in the case bit.
+  const auto case_bit = _mm256_set1_epi8(0x20);
+  const auto lower_low = _mm256_or_si256(low, case_bit);
+  const auto lower_high = _mm256_or_si256(high, case_bit);
+  const auto last_control = _mm256_set1_epi8(0x1f);
+
+  block_masks masks;
+  masks.quote = equal_avx2(low, high, '"');
+  masks.backslash = equal_avx2(low, high, '\\');
+  masks.structural = equal_avx2(lower_low, lower_high, '{') |
+                     equal_avx2(lower_low, lower_high, '}') | equal_avx2(low, high, ':') |
+                     equal_avx2(low, high, ',');
+  masks.whitespace = equal_avx2(low, high, ' ') | equal_avx2(low, high, '\t') |
+                     equal_avx2(low, high, '\n') | equal_avx2(low, high, '\r');
+  masks.control = bits_avx2(
+      _mm256_cmpeq_epi8(_mm256_max_epu8(low, last_control), last_control),
+      _mm256_cmpeq_epi8(_mm256_max_epu8(high, last_control), last_control));
+  masks.non_ascii = bits_avx2(low, high);
+  return masks;
+}
+
+[[gnu::target("avx2")]] std::uint32_t* scan_avx2(const char* blocks, const std::size_t count,
+                                                 const std::uint32_t offset,
+                                                 json_scan_state& state,
+                                                 std::uint32_t* out) noexcept {
+  for (std::size_t b = 0; b < count && out != nullptr; ++b) {
+    const auto* block = blocks + b * block_size;
+    const auto at = offset + static_cast<std::uint32_t>(b * block_size);
+    out = finish_block(classify_avx2(block), block, at, state, out);
+  }
+  return out;
+}
+
+#endif
+
+}  // namespace
+
+simd_level detect_simd_level() noexcept {
+#ifdef SOURCERER_X86_KERNELS
+  static const auto level = [] {
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return simd_level::avx2;
+    if (__builtin_cpu_supports("sse4.2")) return simd_level::sse42;
+    return simd_level::portable;
+  }();
+  return level;
+#else
+  return simd_level::portable;
+#endif
+}
+
+json_scanner::json_scanner(std::string_view text, const simd_level level)
+    : text_{text}, level_{std::min(level, detect_simd_level())} {
+  if (text.size() > std::numeric_limits<std::uint32_t>::max()) {
+    SOURCERER_THROW(std::length_error("JSON text is too large to be scanned"));
+  }
+
+  switch (level_) {
+#ifdef SOURCERER_X86_KERNELS
+    case simd_level::avx2:
+      kernel_ = &scan_avx2;
+      break;
+    case simd_level::sse42:
+      kernel_ = &scan_sse42;
+      break;
+#endif
+    default:
+      kernel_ = &scan_portable;
+      break;
+  }
+}
+
+bool json_scanner::next(std::vector<std::uint32_t>& positions) {
+  if (done_) return false;
+
+  const auto offset = static_cast<std::uint32_t>(scanned_);
+  const auto blocks = std::min((text_.size() - scanned_) / block_size, chunk_blocks);
+  if (blocks != 0) {
+    run(text_.data() + scanned_, blocks, offset, positions);
+    scanned_ += blocks * block_size;
+  } else {
+    // The rest of the text is padded with whitespace to a whole block. There always is a last
+    // block, even if it is all padding, which ends a UTF-8 sequence that is cut off.
+    std::array<char, block_size> last;
+    last.fill(' ');
+    std::memcpy(last.data(), text_.data() + scanned_, text_.size() - scanned_);
+    run(last.data(), 1, offset, positions);
+    scanned_ = text_.size();
+    done_ = true;
+  }
+
+  return true;
+}
+
+void json_scanner::run(const char* blocks, const std::size_t count, const std::uint32_t offset,
+                       std::vector<std::uint32_t>& positions) {
+  const auto size = positions.size();
+  positions.resize(size + count * block_size);
+  const auto* end = kernel_(blocks, count, offset, state_, positions.data() + size);
+
+  if (end == nullptr) {
+    SOURCERER_THROW(std::invalid_argument(
+        "Invalid JSON at position " +
+        std::to_string(std::min(state_.error_position, text_.size())) + ": " + state_.error));
+  }
+  positions.resize(static_cast<std::size_t>(end - positions.data()));
+}
+
+}  // namespace sourcerer::detail
@@ -0,0 +1,95 @@
+#include "sourcerer/key_pool.hpp"
+
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+
+namespace sourcerer {
+
+namespace {
+
+constexpr std::size_t initial_table_size = 64;
+
+}  // namespace
+
+KeyPool::KeyPool(std::pmr::memory_resource* upstream)
+    : arena_{upstream}, table_{initial_table_size, nullptr, upstream} {}
+
+Key KeyPool::intern(std::string_view key) { return intern(key, Key::hash(key)); }
+
+Key KeyPool::intern(std::string_view key, const std::uint32_t hash) {
+  if (key.size() > std::numeric_limits<std::uint32_t>::max()) {
+    SOURCERER_THROW(std::length_error("Key is too long"));
+  }
+
+  std::scoped_lock lock{mutex_};
+
+  auto slot = slot_of(key, hash);
+  if (table_[slot] != nullptr) {
+    return Key{table_[slot]};
+  }
+
+  // Keep the load factor at or below one half.
+  if (2 * (size_ + 1) > table_.size()) {
+    grow();
+    slot = slot_of(key, hash);
+  }
+
+  const auto bytes = sizeof(Key::Entry) + key.size();
+  auto* memory = arena_.allocate(bytes, alignof(Key::Entry));
+  auto* entry = ::new (memory) Key::Entry{this, hash, static_cast<std::uint32_t>(key.size())};
+  std::memcpy(const_cast<char*>(entry->data()), key.data(), key.size());
+
+  table_[slot] = entry;
+  ++size_;
+  bytes_ += bytes;
+  return Key{entry};
+}
+
+std::optional<Key> KeyPool::find(std::string_view key) const {
+  std::scoped_lock lock{mutex_};
+
+  const auto slot = slot_of(key, Key::hash(key));
+  if (table_[slot] == nullptr) {
+    return std::nullopt;
+  }
+  return Key{table_[slot]};
+}
+
+std::size_t KeyPool::size() const {
+  std::scoped_lock lock{mutex_};
+  return size_;
+}
+
+std::size_t KeyPool::bytes() const {
+  std::scoped_lock lock{mutex_};
+  return bytes_;
+}
+
+std::size_t KeyPool::slot_of(std::string_view key, const std::uint32_t hash) const noexcept {
+  const auto mask = table_.size() - 1;
+  auto slot = hash & mask;
+  while (table_[slot] != nullptr &&
+         (table_[slot]->hash != hash || Key{table_[slot]}.view() != key)) {
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+void KeyPool::grow() {
+  std::pmr::vector<const Key::Entry*> table{2 * table_.size(), nullptr, table_.get_allocator()};
+  const auto mask = table.size() - 1;
+  for (const auto* entry : table_) {
+    if (entry == nullptr) continue;
+
+    auto slot = entry->hash & mask;
+    while (table[slot] != nullptr) {
+      slot = (slot + 1) & mask;
+    }
+    table[slot] = entry;
+  }
+  table_ = std::move(table);
+}
+
+}  // namespace sourcerer
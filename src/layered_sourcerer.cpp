@@ -0,0 +1,227 @@
+#include "sourcerer/sourcerers/layered_sourcerer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace sourcerer {
+
+LayeredNode LayeredNode::const_iterator::operator*() const {
+  return LayeredNode{document_, node_, group_}.child(index_);
+}
+
+LayeredNode LayeredNode::child(const size_type index) const {
+  if (group_ != no_group) {
+    const auto& member = document_->indexed(group_).members[index];
+    return document_->member(group_, member.key, member.value, member.layer);
+  }
+  if (node_->is_object()) {
+    const auto& [key, value] =
+        *(LayeredSourcerer::object(*node_).begin() + static_cast<std::ptrdiff_t>(index));
+    return LayeredNode{document_, &value, no_group, key.view(), true};
+  }
+  if (node_->is_array()) {
+    return LayeredNode{document_, &(*node_)[index]};
+  }
+  // Values iterate over themselves.
+  return *this;
+}
+
+LayeredNode LayeredNode::at(const size_type index) const {
+  // Arrays aren't merged, the one of the topmost layer is the whole array.
+  return LayeredNode{document_, &node_->at(index)};
+}
+
+LayeredNode LayeredNode::at(std::string_view key) const {
+  if (const auto value = find(key)) {
+    return *value;
+  }
+  SOURCERER_THROW(std::out_of_range("Key not found: " + std::string{key}));
+}
+
+std::optional<LayeredNode> LayeredNode::find(std::string_view key) const {
+  if (group_ == no_group) {
+    // Only one layer has this object, so it has all of its members.
+    const auto& object = LayeredSourcerer::object(*node_);
+    const auto it = object.find(key);
+    if (it == object.end()) return std::nullopt;
+    return LayeredNode{document_, &it->second, no_group, it->first.view(), true};
+  }
+
+  // The topmost layer that has the key wins.
+  const auto& objects = document_->groups_[group_].objects;
+  const auto hash = Key::hash(key);
+  for (std::uint32_t layer = 0; layer < objects.size(); ++layer) {
+    const auto& object = LayeredSourcerer::object(*objects[layer]);
+    if (const auto it = object.find(key, hash); it != object.end()) {
+      return document_->member(group_, it->first.view(), &it->second, layer);
+    }
+  }
+  return std::nullopt;
+}
+
+std::string_view LayeredNode::key() const {
+  if (!member_) {
+    SOURCERER_THROW(std::logic_error("Only members of an object have a key"));
+  }
+  return key_;
+}
+
+LayeredNode::size_type LayeredNode::size() const {
+  if (group_ != no_group) {
+    return document_->indexed(group_).members.size();
+  }
+  return node_->size();
+}
+
+Node LayeredNode::node() const {
+  if (group_ == no_group) {
+    return *node_;
+  }
+
+  // Starts from the bottommost object and lays the ones above over it.
+  const auto& objects = document_->groups_[group_].objects;
+  auto merged = *objects.back();
+  for (auto it = std::next(objects.rbegin()); it != objects.rend(); ++it) {
+    LayeredSourcerer::merge(merged, **it);
+  }
+  return merged;
+}
+
+LayeredSourcerer::LayeredSourcerer(std::vector<std::reference_wrapper<Sourcerer>> layers)
+    : sourcerers_{std::move(layers)} {
+  if (sourcerers_.empty()) {
+    SOURCERER_THROW(std::invalid_argument("A LayeredSourcerer needs at least one layer"));
+  }
+  reload();
+}
+
+LayeredNode LayeredSourcerer::root() const {
+  if (root_ != LayeredNode::no_group) {
+    return LayeredNode{this, groups_[root_].objects.front(), root_};
+  }
+  return LayeredNode{this, &layers_.back()};
+}
+
+void LayeredSourcerer::reload() {
+  layers_.clear();
+  for (auto& sourcerer : sourcerers_) {
+    layers_.push_back(sourcerer.get().source());
+  }
+  reset();
+}
+
+void LayeredSourcerer::reload(const std::size_t layer) {
+  if (layer >= layers_.size()) {
+    SOURCERER_THROW(std::out_of_range("Layer out of range"));
+  }
+  // Swapped in, assigning would copy the new tree into the resource of the old one.
+  auto fresh = sourcerers_[layer].get().source();
+  layers_[layer].swap(fresh);
+  reset();
+}
+
+void LayeredSourcerer::reset() {
+  groups_.clear();
+
+  // The roots are merged like any other object, down to the first root that isn't one.
+  std::vector<const Node*> roots;
+  for (auto it = layers_.rbegin(); it != layers_.rend() && it->is_object(); ++it) {
+    roots.push_back(&*it);
+  }
+
+  root_ = LayeredNode::no_group;
+  if (roots.size() > 1) {
+    root_ = 0;
+    groups_.emplace_back().objects = std::move(roots);
+  }
+}
+
+std::uint32_t LayeredSourcerer::group_of(const std::vector<const Node*>& objects,
+                                         const std::uint32_t layer, std::string_view key) const {
+  // A value that isn't an object hides the layers below it.
+  std::vector<const Node*> found;
+  for (auto i = layer; i < objects.size(); ++i) {
+    const auto& object = this->object(*objects[i]);
+    const auto it = object.find(key);
+    if (it == object.end()) continue;
+    if (!it->second.is_object()) break;
+    found.push_back(&it->second);
+  }
+
+  if (found.size() < 2) return LayeredNode::no_group;
+  groups_.emplace_back().objects = std::move(found);
+  return static_cast<std::uint32_t>(groups_.size() - 1);
+}
+
+const LayeredSourcerer::Group& LayeredSourcerer::indexed(const std::uint32_t group) const {
+  auto& entry = groups_[group];
+  if (entry.indexed) return entry;
+
+  // From the bottom up, so higher layers override the values of the keys lower ones introduced.
+  std::unordered_map<std::string_view, std::uint32_t> positions;
+  auto sorted = true;
+  for (auto i = static_cast<std::uint32_t>(entry.objects.size()); i-- > 0;) {
+    const auto& object = this->object(*entry.objects[i]);
+    sorted = sorted && object.order() == Node::key_order::sorted;
+    positions.reserve(positions.size() + object.size());
+    for (const auto& [key, value] : object) {
+      const auto [it, inserted] =
+          positions.try_emplace(key.view(), static_cast<std::uint32_t>(entry.members.size()));
+      if (inserted) {
+        entry.members.push_back(Member{key.view(), &value, i});
+      } else {
+        entry.members[it->second].value = &value;
+        entry.members[it->second].layer = i;
+      }
+    }
+  }
+
+  // Otherwise keys are in the order the layers introduced them, the lowest first.
+  if (sorted) {
+    std::ranges::sort(entry.members, std::less<>{}, &Member::key);
+  }
+
+  entry.indexed = true;
+  return entry;
+}
+
+LayeredNode LayeredSourcerer::member(const std::uint32_t group, std::string_view key,
+                                     const Node* value, const std::uint32_t layer) const {
+  if (!value->is_object()) {
+    return LayeredNode{this, value, LayeredNode::no_group, key, true};
+  }
+
+  // Adding a group leaves the others in place.
+  auto& entry = groups_[group];
+  if (const auto it = entry.children.find(key); it != entry.children.end()) {
+    return LayeredNode{this, value, it->second, key, true};
+  }
+  const auto child = group_of(entry.objects, layer, key);
+  if (child != LayeredNode::no_group) {
+    entry.children.emplace(key, child);
+  }
+  return LayeredNode{this, value, child, key, true};
+}
+
+const Node::object_t& LayeredSourcerer::object(const Node& node) {
+  return node.get<Node::object_t>();
+}
+
+void LayeredSourcerer::merge(Node& target, const Node& overlay) {
+  // Writing through the non-const accessors would leak the merged objects, and every copy of the
+  // merged tree would clone them.
+  auto& members = target.mutate<Node::object_t>(false);
+  for (const auto& [key, value] : object(overlay)) {
+    const auto it = members.find(key.view());
+    if (it == members.end()) {
+      members.try_emplace(key.view(), value);
+    } else if (value.is_object() && it->second.is_object()) {
+      merge(it->second, value);
+    } else {
+      it->second = value;
+    }
+  }
+}
+
+}  // namespace sourcerer
@@ -0,0 +1,173 @@
+#include "sourcerer/sourcerers/lazy_json_sourcerer.hpp"
+
+#include <algorithm>
+#include <numeric>
+
+namespace sourcerer {
+
+LazyNode LazyNode::const_iterator::operator*() const {
+  return members_ ? LazyNode{document_, pos_ + 1, pos_} : LazyNode{document_, pos_};
+}
+
+LazyNode::const_iterator& LazyNode::const_iterator::operator++() noexcept {
+  pos_ = document_->index_.skip(members_ ? pos_ + 1 : pos_);
+  return *this;
+}
+
+const detail::json_index& LazyNode::index() const noexcept { return document_->index_; }
+
+LazyNode LazyNode::at(const size_type index) const {
+  detail::throw_if_not(detail::node_kind::array, kind());
+  const auto& children = document_->directory(pos_).children;
+  if (index >= children.size()) {
+    SOURCERER_THROW(std::out_of_range("Index out of range"));
+  }
+  return LazyNode{document_, children[index]};
+}
+
+LazyNode LazyNode::at(std::string_view key) const {
+  if (const auto value = find(key)) {
+    return *value;
+  }
+  SOURCERER_THROW(std::out_of_range("Key not found: " + std::string{key}));
+}
+
+std::optional<LazyNode> LazyNode::find(std::string_view key) const {
+  detail::throw_if_not(detail::node_kind::object, kind());
+  const auto& entry = document_->directory(pos_);
+  const auto hash = Key::hash(key);
+
+  // Keys with the same hash are in document order, the last one that matches wins.
+  const auto [first, last] = std::ranges::equal_range(entry.hashes, hash);
+  for (auto i = last - entry.hashes.begin(); i != first - entry.hashes.begin(); --i) {
+    const auto key_pos = entry.children[static_cast<std::size_t>(i - 1)];
+    if (document_->key_equals(key_pos, key)) {
+      return LazyNode{document_, key_pos + 1, key_pos};
+    }
+  }
+  return std::nullopt;
+}
+
+std::string LazyNode::key() const {
+  if (key_ == no_key) {
+    SOURCERER_THROW(std::logic_error("Only members of an object have a key"));
+  }
+  return index().string(key_);
+}
+
+LazyNode::size_type LazyNode::size() const {
+  switch (kind()) {
+    case detail::node_kind::null:
+      return 0;
+    case detail::node_kind::array:
+    case detail::node_kind::object:
+      return document_->directory(pos_).children.size();
+    default:
+      return 1;
+  }
+}
+
+Node LazyNode::node() const {
+  if (!index().is_object(pos_) && !index().is_array(pos_)) {
+    NodeBuilder builder{{}, document_->keys_};
+    document_->index_.build(builder, pos_);
+    return builder.finish();
+  }
+
+  auto& entry = document_->entry(pos_);
+  if (!entry.node) {
+    auto arena = detail::shared_arena::create();
+    NodeBuilder builder{Node::allocator_type{arena.get()}, document_->keys_};
+    document_->index_.build(builder, pos_);
+    entry.node = builder.finish();
+    entry.arena = std::move(arena);
+  }
+  return *entry.node;
+}
+
+LazyNode::const_iterator LazyNode::begin() const {
+  if (is_null()) return end();
+  // Values iterate over themselves.
+  const auto first = index().is_object(pos_) || index().is_array(pos_) ? pos_ + 1 : pos_;
+  return const_iterator{document_, first, index().is_object(pos_)};
+}
+
+LazyNode::const_iterator LazyNode::end() const {
+  return const_iterator{document_, index().skip(pos_), index().is_object(pos_)};
+}
+
+LazyJsonSourcerer::LazyJsonSourcerer(Conjurer& conjurer, const std::size_t cache_capacity)
+    : text_{conjurer.conjure()},
+      index_{text_},
+      capacity_{std::max<std::size_t>(cache_capacity, 1)} {}
+
+void LazyJsonSourcerer::evict() noexcept {
+  cache_.clear();
+  uses_.clear();
+}
+
+LazyJsonSourcerer::Entry& LazyJsonSourcerer::entry(const std::uint32_t pos) const {
+  const auto [it, inserted] = cache_.try_emplace(pos);
+  auto& entry = it->second;
+  if (inserted) {
+    uses_.push_front(pos);
+    entry.use = uses_.begin();
+    // The new entry is the most recently used one and stays.
+    shrink();
+  } else {
+    uses_.splice(uses_.begin(), uses_, entry.use);
+  }
+  return entry;
+}
+
+const LazyJsonSourcerer::Entry& LazyJsonSourcerer::directory(const std::uint32_t pos) const {
+  auto& entry = this->entry(pos);
+  if (entry.indexed) return entry;
+
+  const auto end = index_.skip(pos);
+  for (auto child = pos + 1; child < end;) {
+    entry.children.push_back(child);
+    child = index_.skip(index_.is_object(pos) ? child + 1 : child);
+  }
+
+  if (index_.is_object(pos)) {
+    entry.hashes.reserve(entry.children.size());
+    for (const auto key : entry.children) {
+      entry.hashes.push_back(key_hash(key));
+    }
+
+    std::vector<std::uint32_t> order(entry.children.size());
+    std::iota(order.begin(), order.end(), std::uint32_t{0});
+    std::ranges::stable_sort(order, std::less<>{},
+                             [&](const std::uint32_t i) { return entry.hashes[i]; });
+
+    std::vector<std::uint32_t> children;
+    children.reserve(order.size());
+    for (const auto i : order) {
+      children.push_back(entry.children[i]);
+    }
+    entry.children = std::move(children);
+    std::ranges::sort(entry.hashes);
+  }
+
+  entry.indexed = true;
+  return entry;
+}
+
+void LazyJsonSourcerer::shrink() const {
+  while (cache_.size() > capacity_) {
+    cache_.erase(uses_.back());
+    uses_.pop_back();
+  }
+}
+
+std::uint32_t LazyJsonSourcerer::key_hash(const std::uint32_t pos) const {
+  if (index_.is_escaped(pos)) return Key::hash(index_.string(pos));
+  return Key::hash(index_.raw_string(pos));
+}
+
+bool LazyJsonSourcerer::key_equals(const std::uint32_t pos, std::string_view key) const {
+  return index_.is_escaped(pos) ? index_.string(pos) == key : index_.raw_string(pos) == key;
+}
+
+}  // namespace sourcerer
@@ -0,0 +1,67 @@
+#include "sourcerer/loader.hpp"
+
+#include <algorithm>
+#include <latch>
+#include <utility>
+
+#include "sourcerer/sourcerers/json_sourcerer.hpp"
+
+namespace sourcerer {
+
+const Node& Loaded::value() const& {
+  if (error_) std::rethrow_exception(error_);
+  return node_;
+}
+
+Node&& Loaded::value() && {
+  if (error_) std::rethrow_exception(error_);
+  return std::move(node_);
+}
+
+Node Loader::parse_json(Conjurer& conjurer) { return JsonSourcerer{conjurer}.source(); }
+
+std::size_t Loader::add(Conjurer& conjurer, parser parse) {
+  sources_.push_back(Source{&conjurer, std::move(parse)});
+  return sources_.size() - 1;
+}
+
+std::vector<Loaded> Loader::load() const {
+  std::vector<Loaded> results(sources_.size());
+  if (sources_.empty()) return results;
+
+  if (executor_ != nullptr) {
+    run(*executor_, results);
+  } else {
+    ThreadPool pool{std::min(ThreadPool::default_size(), sources_.size())};
+    run(pool, results);
+  }
+  return results;
+}
+
+void Loader::run(Executor& executor, std::vector<Loaded>& results) const {
+  std::latch done{static_cast<std::ptrdiff_t>(sources_.size())};
+  for (std::size_t i = 0; i < sources_.size(); ++i) {
+    // Every task writes only its own result.
+    auto task = [&source = sources_[i], &result = results[i], &done] {
+      SOURCERER_TRY {
+        // Swapped in, assigning would copy the tree into the resource of the empty node.
+        auto tree = source.parse(*source.conjurer);
+        result.node_.swap(tree);
+      } SOURCERER_CATCH(...) {
+        result.error_ = std::current_exception();
+      }
+      done.count_down();
+    };
+
+    SOURCERER_TRY {
+      executor.execute(std::move(task));
+    } SOURCERER_CATCH(...) {
+      // The executor didn't take the task, so it can't run.
+      results[i].error_ = std::current_exception();
+      done.count_down();
+    }
+  }
+  done.wait();
+}
+
+}  // namespace sourcerer
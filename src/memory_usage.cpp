@@ -0,0 +1,114 @@
+#include "sourcerer/memory_usage.hpp"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "sourcerer/key_pool.hpp"
+#include "sourcerer/node.hpp"
+#include "sourcerer/path.hpp"
+
+namespace sourcerer {
+
+// Walks a tree, counting every container block and key pool once.
+class MemoryCounter {
+ public:
+  MemoryUsage count(const Node& root) {
+    MemoryUsage usage;
+    usage.nodes += sizeof(Node);
+    add(root, usage);
+    return usage;
+  }
+
+  // Adds the usage of the subtrees below node down to depth levels, node being at path. The key
+  // pools the counter has seen already don't count towards them.
+  void add_subtrees(const Node& node, std::string& path, const std::size_t depth,
+                    std::vector<SubtreeUsage>& result) const {
+    if (depth == 0) return;
+
+    const auto length = path.size();
+    const auto add = [&](const Node& child) {
+      MemoryCounter counter;
+      counter.pools_ = pools_;
+      result.push_back({path, counter.count(child)});
+      add_subtrees(child, path, depth - 1, result);
+      path.resize(length);
+    };
+    if (node.is_object()) {
+      for (const auto& [key, child] : node.get<Node::object_t>()) {
+        detail::append_key(path, key.view());
+        add(child);
+      }
+    } else if (node.is_array()) {
+      const auto& array = node.get<Node::array_t>();
+      for (std::size_t i = 0; i < array.size(); ++i) {
+        detail::append_index(path, i);
+        add(array[i]);
+      }
+    }
+  }
+
+ private:
+  // Adds what node owns besides itself.
+  void add(const Node& node, MemoryUsage& usage) {
+    switch (node.kind_) {
+      case detail::node_kind::string:
+        if (static_cast<unsigned char>(node.data_.back()) == Node::large_string) {
+          usage.values += node.string().size();
+        }
+        break;
+      case detail::node_kind::array: {
+        const auto* block = node.block<Node::array_t>();
+        if (!blocks_.insert(block).second) break;
+
+        const auto& array = block->value();
+        usage.nodes += array.size() * sizeof(Node);
+        usage.containers += sizeof(*block) + (array.capacity() - array.size()) * sizeof(Node) +
+                            detail::packed_numbers::bytes(
+                                block->packed().load(std::memory_order_acquire));
+        for (const auto& child : array) {
+          add(child, usage);
+        }
+        break;
+      }
+      case detail::node_kind::object: {
+        using entry = Node::object_t::value_type;
+        const auto* block = node.block<Node::object_t>();
+        if (!blocks_.insert(block).second) break;
+
+        const auto& object = block->value();
+        usage.nodes += object.size() * sizeof(Node);
+        usage.keys += object.size() * (sizeof(entry) - sizeof(Node));
+        if (const auto& pool = object.keys(); pool != nullptr && pools_.insert(pool.get()).second) {
+          usage.keys += sizeof(KeyPool) + pool->bytes();
+        }
+        usage.containers += sizeof(*block) + (object.capacity() - object.size()) * sizeof(entry) +
+                            object.lookup_bytes();
+        for (const auto& [key, child] : object) {
+          add(child, usage);
+        }
+        break;
+      }
+      default:
+        // The remaining scalars are stored in the node.
+        break;
+    }
+  }
+
+  std::unordered_set<const void*> blocks_;
+  std::unordered_set<const KeyPool*> pools_;
+};
+
+MemoryUsage Node::memory_usage() const { return MemoryCounter{}.count(*this); }
+
+std::vector<SubtreeUsage> memory_usage_by_path(const Node& root, const std::size_t depth) {
+  std::vector<SubtreeUsage> result;
+  std::string path;
+  MemoryCounter counter;
+  counter.count(root);
+  counter.add_subtrees(root, path, depth, result);
+  std::ranges::stable_sort(result, std::ranges::greater{},
+                           [](const SubtreeUsage& subtree) { return subtree.usage.total(); });
+  return result;
+}
+
+}  // namespace sourcerer
@@ -1,184 +1,583 @@
 #include "sourcerer/node.hpp"
 
+#include <bit>
 #include <cassert>
+#include <limits>
 #include <memory>
+#include <utility>
 
+#include "sourcerer/detail/content_hash.hpp"
 #include "sourcerer/detail/helpers.hpp"
+#include "sourcerer/detail/shared_arena.hpp"
 
 namespace sourcerer {
 
-Node::Node(const null_t&) : Node() {}
+namespace {
 
-Node::Node(const value_t& value) : Node(nullptr, value) {}
+template <class Object, class K>
+auto& find_or_throw(Object& object, const K& key) {
+  auto it = object.find(key);
+  if (it == object.end()) {
+    SOURCERER_THROW(std::out_of_range("Key not found: " + std::string{std::string_view{key}}));
+  }
+  return it->second;
+}
+
+template <class K>
+const Node& find_existing(const Node::object_t& object, const K& key) {
+  auto it = object.find(key);
+  assert(it != object.end());
+  return it->second;
+}
 
-Node::Node(const array_t& value) : Node(nullptr, value) {}
+// Creates the block of a container in resource, from args and an allocator for resource.
+template <class T, class... Args>
+detail::shared_block<T>* make_block(std::pmr::memory_resource* resource, Args&&... args) {
+  const auto shareable = detail::outlives_its_nodes(resource);
+  return detail::shared_block<T>::create(resource, shareable, std::forward<Args>(args)...,
+                                         Node::allocator_type{resource});
+}
+
+// A finalizer after splitmix64, mixes all bits of hash into all others.
+std::uint64_t mix(std::uint64_t hash) noexcept {
+  hash ^= hash >> 30;
+  hash *= 0xbf58476d1ce4e5b9ULL;
+  hash ^= hash >> 27;
+  hash *= 0x94d049bb133111ebULL;
+  hash ^= hash >> 31;
+  return hash;
+}
 
-Node::Node(const object_t& value) : Node(nullptr, value) {}
+// Sets the hashes of different kinds apart.
+std::uint64_t kind_seed(const detail::node_kind kind) noexcept {
+  return 0x9e3779b97f4a7c15ULL * (static_cast<std::uint64_t>(kind) + 1);
+}
+
+// Whether value is exactly integer. Fractions, NaN and doubles outside the range of Integer aren't,
+// and neither is the double an integer above 2^53 was rounded to.
+template <class Integer>
+bool is_exactly(const double value, const Integer integer) noexcept {
+  // The bounds of Integer, as exact doubles. Casting doubles outside them is undefined.
+  constexpr auto lowest = std::is_signed_v<Integer> ? -0x1p63 : 0.0;
+  constexpr auto limit = std::is_signed_v<Integer> ? 0x1p63 : 0x1p64;
+  return value >= lowest && value < limit && static_cast<Integer>(value) == integer &&
+         static_cast<double>(integer) == value;
+}
+
+// Caches the hash of a container, 0 stands for no hash.
+template <class T>
+std::uint64_t cache(const detail::shared_block<T>& block, std::uint64_t hash) noexcept {
+  if (hash == 0) hash = 1;
+  block.cache(hash);
+  return hash;
+}
+
+// Shares the block of other if possible, copies it into resource otherwise.
+template <class T>
+detail::shared_block<T>* share_or_copy(detail::shared_block<T>* other,
+                                       std::pmr::memory_resource* resource) {
+  if (other->acquire()) {
+    return other;
+  }
+  return make_block<T>(resource, std::as_const(other->value()));
+}
 
-Node::Node(const Node& other) : Node(nullptr, other) {}
+}  // namespace
+
+Node::Node(const allocator_type& alloc) : resource_{alloc.resource()} {}
+
+Node::Node(const null_t&, const allocator_type& alloc) : Node(alloc) {}
+
+Node::Node(const value_t& value, const allocator_type& alloc) : Node(alloc) { set_string(value); }
+
+Node::Node(const array_t& value, const allocator_type& alloc) : Node(alloc) {
+  set_payload(make_block<array_t>(resource_, value));
+  kind_ = detail::node_kind::array;
+}
+
+Node::Node(const object_t& value, const allocator_type& alloc) : Node(alloc) {
+  set_payload(make_block<object_t>(resource_, value));
+  kind_ = detail::node_kind::object;
+}
+
+Node::Node(const Node& other) : Node(other, allocator_type{}) {}
+
+Node::Node(const Node& other, const allocator_type& alloc) : Node(alloc) {
+  switch (other.kind_) {
+    case detail::node_kind::null:
+      break;
+    case detail::node_kind::string:
+      set_string(other.string());
+      break;
+    case detail::node_kind::array:
+      set_payload(share_or_copy(other.block<array_t>(), resource_));
+      kind_ = detail::node_kind::array;
+      break;
+    case detail::node_kind::object:
+      set_payload(share_or_copy(other.block<object_t>(), resource_));
+      kind_ = detail::node_kind::object;
+      break;
+    default:
+      // The remaining scalars don't own any memory.
+      data_ = other.data_;
+      kind_ = other.kind_;
+      break;
+  }
+}
 
 Node::Node(null_t&&) : Node() {}
 
-Node::Node(value_t&& value) : children_{std::move(value)} {}
+Node::Node(value_t&& value) : Node(value, value.get_allocator()) {}
+
+Node::Node(array_t&& value) : Node(value.get_allocator()) {
+  set_payload(make_block<array_t>(resource_, std::move(value)));
+  kind_ = detail::node_kind::array;
+}
+
+Node::Node(object_t&& value) : Node(value.get_allocator()) {
+  set_payload(make_block<object_t>(resource_, std::move(value)));
+  kind_ = detail::node_kind::object;
+}
+
+Node::Node(Node&& other) noexcept : resource_{other.resource_} { steal(other); }
 
-Node::Node(array_t&& value) : children_{std::move(value)} {}
+Node::Node(value_t&& value, const allocator_type& alloc) : Node(value, alloc) {}
 
-Node::Node(object_t&& value) : children_{std::move(value)} {}
+Node::Node(array_t&& value, const allocator_type& alloc) : Node(alloc) {
+  set_payload(make_block<array_t>(resource_, std::move(value)));
+  kind_ = detail::node_kind::array;
+}
 
-Node::Node(const Node* parent) : parent_{parent} {}
+Node::Node(object_t&& value, const allocator_type& alloc) : Node(alloc) {
+  set_payload(make_block<object_t>(resource_, std::move(value)));
+  kind_ = detail::node_kind::object;
+}
 
-Node::Node(const Node* parent, const null_t& value) : parent_{parent}, children_{value} {}
+Node::Node(Node&& other, const allocator_type& alloc) : Node(alloc) {
+  if (resource_ == other.resource_) {
+    steal(other);
+  } else {
+    *this = std::as_const(other);
+  }
+}
 
-Node::Node(const Node* parent, const value_t& value) : parent_{parent}, children_{value} {}
+Node::~Node() { reset(); }
+
+const Node* Node::find_parent(const Node& descendant) const noexcept {
+  for (const auto& child : *this) {
+    if (&child == this) {
+      // Values iterate over themselves.
+      return nullptr;
+    }
+    if (&child == &descendant) {
+      return this;
+    }
+    if (const auto* parent = child.find_parent(descendant); parent != nullptr) {
+      return parent;
+    }
+  }
 
-Node::Node(const Node* parent, const array_t& value) : parent_{parent} { copy(value); }
+  return nullptr;
+}
 
-Node::Node(const Node* parent, const object_t& value) : parent_{parent} { copy(value); }
+const Node* Node::find(const size_type index) const noexcept {
+  if (!is_array()) return nullptr;
+  const auto& array = block<array_t>()->value();
+  return index < array.size() ? &array[index] : nullptr;
+}
 
-Node::Node(const Node* parent, const Node& other) : parent_{parent} {
-  std::visit([this](const auto& v) { this->copy(v); }, other.children_);
+const Node* Node::find(std::string_view key) const noexcept {
+  if (!is_object()) return nullptr;
+  const auto& object = block<object_t>()->value();
+  const auto it = object.find(key);
+  return it != object.end() ? &it->second : nullptr;
 }
 
-Node::reference Node::at(const size_type index) {
-  return *(detail::try_get<array_t>(children_).at(index));
+const Node* Node::find(const key_type& key) const noexcept {
+  if (!is_object()) return nullptr;
+  const auto& object = block<object_t>()->value();
+  const auto it = object.find(key);
+  return it != object.end() ? &it->second : nullptr;
 }
 
-Node::const_reference Node::at(const size_type index) const {
-  return *(detail::try_get<array_t>(children_).at(index));
+result<const Node&> Node::try_at(const size_type index) const noexcept {
+  if (!is_array()) return error{errc::wrong_type, detail::kind_name(kind_)};
+  if (const auto* child = find(index)) return *child;
+  return error{errc::index_out_of_range};
 }
 
-Node::reference Node::at(const key_type& key) {
-  return *(detail::try_get<object_t>(children_).at(key));
+result<const Node&> Node::try_at(std::string_view key) const noexcept {
+  if (!is_object()) return error{errc::wrong_type, detail::kind_name(kind_)};
+  if (const auto* child = find(key)) return *child;
+  return error{errc::key_not_found};
 }
 
-Node::const_reference Node::at(const key_type& key) const {
-  return *(detail::try_get<object_t>(children_).at(key));
+result<const Node&> Node::try_at(const key_type& key) const noexcept {
+  if (!is_object()) return error{errc::wrong_type, detail::kind_name(kind_)};
+  if (const auto* child = find(key)) return *child;
+  return error{errc::key_not_found};
 }
 
-Node::reference Node::operator[](const size_type index) {
-  return *(detail::try_get<array_t>(children_)[index]);
+Node::reference Node::at(const size_type index) { return get<array_t>().at(index); }
+
+Node::const_reference Node::at(const size_type index) const { return get<array_t>().at(index); }
+
+Node::reference Node::at(std::string_view key) { return find_or_throw(get<object_t>(), key); }
+
+Node::const_reference Node::at(std::string_view key) const {
+  return find_or_throw(get<object_t>(), key);
 }
 
+Node::reference Node::at(const key_type& key) { return find_or_throw(get<object_t>(), key); }
+
+Node::const_reference Node::at(const key_type& key) const {
+  return find_or_throw(get<object_t>(), key);
+}
+
+Node::reference Node::operator[](const size_type index) { return get<array_t>()[index]; }
+
 Node::const_reference Node::operator[](const size_type index) const {
-  return *(detail::try_get<array_t>(children_)[index]);
+  return get<array_t>()[index];
 }
 
-Node::reference Node::operator[](const key_type& key) {
-  prepare_for<object_t>("Can't use operator[] on a node of type " + detail::type_name(children_));
+Node::reference Node::operator[](std::string_view key) {
+  prepare_for<object_t>("use operator[]");
 
-  auto [it, success] =
-      detail::try_get<object_t>(children_).try_emplace(key, std::make_unique<Node>(this, Node{}));
-  return *(it->second);
+  return get<object_t>().try_emplace(key).first->second;
 }
 
-Node::const_reference Node::operator[](const key_type& key) const {
+Node::const_reference Node::operator[](std::string_view key) const {
   if (!is_object()) {
-    throw std::invalid_argument("Can't use operator[] on a node of type " +
-                                detail::type_name(children_));
+    SOURCERER_THROW(std::invalid_argument("Can't use operator[] on a node of type " +
+                                          detail::type_name(kind_)));
   }
 
-  auto it = std::get<object_t>(children_).find(key);
-  assert(it != std::get<object_t>(children_).end());
-  return *(it->second);
+  return find_existing(get<object_t>(), key);
 }
 
-void Node::push_back(const Node& node) {
-  prepare_for<array_t>("Can't push_back on a node of type " + detail::type_name(children_));
+Node::reference Node::operator[](const key_type& key) {
+  prepare_for<object_t>("use operator[]");
 
-  std::get<array_t>(children_).push_back(std::make_unique<Node>(this, node));
+  return get<object_t>().try_emplace(key).first->second;
 }
 
-void Node::emplace_back(const Node& node) {
-  prepare_for<array_t>("Can't emplace_back on a node of type " + detail::type_name(children_));
+Node::const_reference Node::operator[](const key_type& key) const {
+  if (!is_object()) {
+    SOURCERER_THROW(std::invalid_argument("Can't use operator[] on a node of type " +
+                                          detail::type_name(kind_)));
+  }
 
-  std::get<array_t>(children_).emplace_back(std::make_unique<Node>(this, node));
+  return find_existing(get<object_t>(), key);
 }
 
+std::shared_ptr<KeyPool> Node::keys() const { return get<object_t>().keys(); }
+
 void Node::erase(const size_type index) {
   if (!is_array()) {
-    throw std::invalid_argument("Can't erase with index on a node of type " +
-                                detail::type_name(children_));
+    SOURCERER_THROW(std::invalid_argument("Can't erase with index on a node of type " +
+                                          detail::type_name(kind_)));
   }
 
-  if (index >= std::get<array_t>(children_).size()) {
-    throw std::out_of_range("Index out of range");
+  auto& array = mutate<array_t>(false);
+  if (index >= array.size()) {
+    SOURCERER_THROW(std::out_of_range("Index out of range"));
   }
 
-  std::get<array_t>(children_).erase(std::get<array_t>(children_).begin() + index);
+  array.erase(array.begin() + index);
 }
 
-void Node::erase(const key_type& key) {
+void Node::erase(std::string_view key) {
   if (!is_object()) {
-    throw std::invalid_argument("Can't erase with key on a node of type " +
-                                detail::type_name(children_));
+    SOURCERER_THROW(std::invalid_argument("Can't erase with key on a node of type " +
+                                          detail::type_name(kind_)));
+  }
+
+  // Erasing a missing key leaves a shared object shared.
+  if (!std::as_const(*this).get<object_t>().contains(key)) {
+    return;
   }
 
-  std::get<object_t>(children_).erase(key);
+  auto& object = mutate<object_t>(false);
+  object.erase(object.find(key));
 }
 
 void Node::clear() {
-  std::visit(
-      detail::overloaded{[](null_t&) { /* null is always empty */ }, [](auto& v) { v.clear(); }},
-      children_);
+  switch (kind_) {
+    case detail::node_kind::null:
+      // null is always empty
+      break;
+    case detail::node_kind::string:
+      set_string({});
+      break;
+    case detail::node_kind::array:
+      // There's no point in cloning a shared container only to clear it.
+      if (block<array_t>()->unique()) {
+        mutate<array_t>(false).clear();
+      } else {
+        make_empty(kind_);
+      }
+      break;
+    case detail::node_kind::object:
+      if (block<object_t>()->unique()) {
+        mutate<object_t>(false).clear();
+      } else {
+        const auto& object = block<object_t>()->value();
+        auto* empty = make_block<object_t>(resource_, object.keys(), object.order());
+        reset();
+        set_payload(empty);
+        kind_ = detail::node_kind::object;
+      }
+      break;
+    default:
+      // Numbers are reset to zero and bools to false.
+      data_ = {};
+      break;
+  }
 }
 
 bool Node::empty() const noexcept {
-  return std::visit(
-      detail::overloaded{[](const null_t&) { return true; }, [](const value_t&) { return false; },
-                         [](const auto& v) { return std::empty(v); }},
-      children_);
+  switch (kind_) {
+    case detail::node_kind::null:
+      return true;
+    case detail::node_kind::array:
+      return block<array_t>()->value().empty();
+    case detail::node_kind::object:
+      return block<object_t>()->value().empty();
+    default:
+      return false;
+  }
 }
 
-Node::size_type Node::size() const noexcept {
-  return std::visit(detail::overloaded{[](const null_t&) { return Node::size_type{0}; },
-                                       [](const value_t&) { return Node::size_type{1}; },
-                                       [](const auto& v) { return v.size(); }},
-                    children_);
+void Node::reserve(const size_type size) {
+  switch (kind_) {
+    case detail::node_kind::array:
+      mutate<array_t>(false).reserve(size);
+      break;
+    case detail::node_kind::object:
+      mutate<object_t>(false).reserve(size);
+      break;
+    default:
+      SOURCERER_THROW(
+          std::invalid_argument("Can't reserve on a node of type " + detail::type_name(kind_)));
+  }
 }
 
-void Node::insert(const size_type index, const Node& node) {
-  prepare_for<array_t>("Can't insert with index on a node of type " + detail::type_name(children_));
+Node::size_type Node::capacity() const noexcept {
+  switch (kind_) {
+    case detail::node_kind::array:
+      return block<array_t>()->value().capacity();
+    case detail::node_kind::object:
+      return block<object_t>()->value().capacity();
+    default:
+      return 0;
+  }
+}
 
-  std::get<array_t>(children_).insert(std::get<array_t>(children_).begin() + index,
-                                      std::make_unique<Node>(this, node));
+Node::size_type Node::size() const noexcept {
+  switch (kind_) {
+    case detail::node_kind::null:
+      return 0;
+    case detail::node_kind::array:
+      return block<array_t>()->value().size();
+    case detail::node_kind::object:
+      return block<object_t>()->value().size();
+    default:
+      return 1;
+  }
 }
 
-void Node::insert(const key_type& key, const Node& node) {
-  prepare_for<object_t>("Can't insert with key on a node of type " + detail::type_name(children_));
+Node::reference Node::operator=(const Node& other) {
+  if (this != &other) {
+    // Copy first, other might be one of our own children.
+    Node copy{other, resource_};
+    steal(copy);
+  }
 
-  std::get<object_t>(children_).insert({key, std::make_unique<Node>(this, node)});
+  return *this;
 }
 
-void Node::emplace(const size_type index, const Node& node) {
-  prepare_for<array_t>("Can't emplace with index on a node of type " +
-                       detail::type_name(children_));
+Node::reference Node::operator=(Node&& other) {
+  // Like the pmr containers, a node keeps its memory resource on assignment. The payload can only
+  // be stolen if it lives in the same resource, otherwise it's copied over.
+  if (resource_ != other.resource_) {
+    return *this = std::as_const(other);
+  }
 
-  std::get<array_t>(children_).emplace(std::get<array_t>(children_).begin() + index,
-                                       std::make_unique<Node>(this, node));
+  if (this != &other) {
+    Node tmp{std::move(other)};
+    steal(tmp);
+  }
+
+  return *this;
 }
 
-void Node::emplace(const key_type& key, const Node& node) {
-  prepare_for<object_t>("Can't emplace with key on a node of type " + detail::type_name(children_));
+bool Node::operator==(const Node& other) const {
+  if (kind_ != other.kind_) {
+    return is_number() && other.is_number() && equal_numbers(*this, other);
+  }
 
-  std::get<object_t>(children_).emplace(key, std::make_unique<Node>(this, node));
+  switch (kind_) {
+    case detail::node_kind::boolean:
+      return payload<bool>() == other.payload<bool>();
+    case detail::node_kind::integer:
+      return payload<std::int64_t>() == other.payload<std::int64_t>();
+    case detail::node_kind::unsigned_integer:
+      return payload<std::uint64_t>() == other.payload<std::uint64_t>();
+    case detail::node_kind::floating:
+      return payload<double>() == other.payload<double>();
+    case detail::node_kind::string:
+      return string() == other.string();
+    case detail::node_kind::array:
+      // Copies sharing a container are equal without looking at it, and containers with different
+      // hashes are unequal. Equal hashes are verified, they could collide.
+      if (block<array_t>() == other.block<array_t>()) return true;
+      return !hashes_differ<array_t>(other) &&
+             block<array_t>()->value() == other.block<array_t>()->value();
+    case detail::node_kind::object:
+      if (block<object_t>() == other.block<object_t>()) return true;
+      return !hashes_differ<object_t>(other) &&
+             block<object_t>()->value() == other.block<object_t>()->value();
+    default:
+      return true;
+  }
 }
 
-Node::reference Node::operator=(const Node& other) {
-  if (this != &other) {
-    std::visit([this](const auto& v) { this->copy(v); }, other.children_);
+template <detail::packed_number T>
+detail::packed_numbers& Node::packed() const {
+  const auto& array = get<array_t>();
+  const auto* block = this->block<array_t>();
+
+  const auto convert = [](const Node& element) {
+    if constexpr (std::is_same_v<T, double>) {
+      if (element.kind_ == detail::node_kind::floating) return element.payload<double>();
+    } else {
+      if (element.kind_ == detail::node_kind::integer) return element.payload<std::int64_t>();
+    }
+    return element.as<T>();
+  };
+
+  auto* buffer = detail::packed_numbers::find<T>(block->packed().load(std::memory_order_acquire));
+  if (buffer != nullptr) {
+    if (block->leaked()) {
+      // Only values that changed are written, so concurrent readers of an unchanged array don't
+      // race. Changing the size of the array would have dropped the buffer.
+      auto values = buffer->template values<T>();
+      for (size_type i = 0; i < values.size(); ++i) {
+        if (const auto value = convert(array[i]);
+            std::bit_cast<std::uint64_t>(value) != std::bit_cast<std::uint64_t>(values[i])) {
+          values[i] = value;
+        }
+      }
+    }
+    return *buffer;
   }
 
-  return *this;
+  buffer = detail::packed_numbers::create<T>(array.size());
+  SOURCERER_TRY {
+    auto values = buffer->template values<T>();
+    for (size_type i = 0; i < values.size(); ++i) {
+      values[i] = convert(array[i]);
+    }
+  } SOURCERER_CATCH(...) {
+    detail::packed_numbers::destroy(buffer);
+    SOURCERER_RETHROW;
+  }
+  return *detail::packed_numbers::append<T>(block->packed(), buffer);
+}
+
+template detail::packed_numbers& Node::packed<std::int64_t>() const;
+template detail::packed_numbers& Node::packed<double>() const;
+
+std::uint64_t Node::hash() const noexcept {
+  switch (kind_) {
+    case detail::node_kind::boolean:
+      return mix(kind_seed(detail::node_kind::boolean) + (payload<bool>() ? 1 : 0));
+    case detail::node_kind::integer:
+    case detail::node_kind::unsigned_integer:
+    case detail::node_kind::floating: {
+      // Numbers that compare equal hash alike: integers a double represents exactly hash as that
+      // double, with -0.0 as 0.0. The others can't equal a double, they hash as themselves, apart
+      // from other integers. Hashing them as the double they round to would make all integers
+      // rounding to it collide.
+      auto value = payload<double>();
+      if (kind_ == detail::node_kind::integer) {
+        const auto integer = payload<std::int64_t>();
+        value = static_cast<double>(integer);
+        if (!is_exactly(value, integer)) {
+          return integer < 0 ? mix(kind_seed(detail::node_kind::integer) ^
+                                   static_cast<std::uint64_t>(integer))
+                             : mix(kind_seed(detail::node_kind::unsigned_integer) ^
+                                   static_cast<std::uint64_t>(integer));
+        }
+      } else if (kind_ == detail::node_kind::unsigned_integer) {
+        const auto integer = payload<std::uint64_t>();
+        value = static_cast<double>(integer);
+        if (!is_exactly(value, integer)) {
+          return mix(kind_seed(detail::node_kind::unsigned_integer) ^ integer);
+        }
+      }
+      if (value == 0.0) value = 0.0;
+      return mix(kind_seed(detail::node_kind::floating) ^ std::bit_cast<std::uint64_t>(value));
+    }
+    case detail::node_kind::string:
+      return mix(kind_seed(detail::node_kind::string) ^ detail::content_hash(string()));
+    case detail::node_kind::array: {
+      const auto* block = this->block<array_t>();
+      if (const auto cached = block->hash()) return cached;
+
+      auto hash = kind_seed(detail::node_kind::array);
+      for (const auto& child : block->value()) {
+        hash = mix(hash ^ child.hash());
+      }
+      return cache(*block, mix(hash + block->value().size()));
+    }
+    case detail::node_kind::object: {
+      const auto* block = this->block<object_t>();
+      if (const auto cached = block->hash()) return cached;
+
+      // Summed, so the order of the keys doesn't matter.
+      auto hash = kind_seed(detail::node_kind::object);
+      for (const auto& [key, child] : block->value()) {
+        hash += mix(detail::content_hash(key.view()) ^ std::rotl(child.hash(), 29));
+      }
+      return cache(*block, mix(hash + block->value().size()));
+    }
+    default:
+      return mix(kind_seed(detail::node_kind::null));
+  }
 }
 
-bool Node::operator==(const Node& other) const { return children_ == other.children_; }
+bool Node::equal_numbers(const Node& lhs, const Node& rhs) noexcept {
+  // Numbers compare by value, regardless of the kind they are stored as. An integer only equals
+  // the double that is exactly it, not every double it rounds to.
+  if (lhs.is_floating() || rhs.is_floating()) {
+    const auto equals = [](const double value, const Node& node) {
+      switch (node.kind_) {
+        case detail::node_kind::integer:
+          return is_exactly(value, node.payload<std::int64_t>());
+        case detail::node_kind::unsigned_integer:
+          return is_exactly(value, node.payload<std::uint64_t>());
+        default:
+          return value == node.payload<double>();
+      }
+    };
+    return lhs.is_floating() ? equals(lhs.payload<double>(), rhs)
+                             : equals(rhs.payload<double>(), lhs);
+  }
+
+  if (lhs.kind_ == detail::node_kind::integer) {
+    return std::cmp_equal(lhs.payload<std::int64_t>(), rhs.payload<std::uint64_t>());
+  }
+  return std::cmp_equal(lhs.payload<std::uint64_t>(), rhs.payload<std::int64_t>());
+}
 
 void Node::swap(Node& other) noexcept {
-  std::swap(parent_, other.parent_);
-  children_.swap(other.children_);
+  std::swap(data_, other.data_);
+  std::swap(kind_, other.kind_);
+  std::swap(resource_, other.resource_);
 }
 
-Node::iterator Node::begin() noexcept {
+Node::iterator Node::begin() {
   iterator it{this};
   it.set_begin();
   return it;
@@ -192,7 +591,7 @@ Node::const_iterator Node::cbegin() const noexcept {
 
 Node::const_iterator Node::begin() const noexcept { return cbegin(); }
 
-Node::iterator Node::end() noexcept {
+Node::iterator Node::end() {
   iterator it{this};
   it.set_end();
   return it;
@@ -206,4 +605,118 @@ Node::const_iterator Node::cend() const noexcept {
 
 Node::const_iterator Node::end() const noexcept { return cend(); }
 
+Node::array_view Node::as_array() {
+  if (is_null()) return {};
+  return get<array_t>();
+}
+
+Node::const_array_view Node::as_array() const {
+  if (is_null()) return {};
+  return get<array_t>();
+}
+
+Node::object_view Node::as_object() {
+  if (is_null()) return {};
+  return object_view{&get<object_t>()};
+}
+
+Node::const_object_view Node::as_object() const {
+  if (is_null()) return {};
+  return const_object_view{&get<object_t>()};
+}
+
+std::string_view Node::string() const noexcept {
+  const auto size = static_cast<unsigned char>(data_.back());
+  if (size == large_string) {
+    return {payload<const char*>(), payload<std::uint32_t, sizeof(char*)>()};
+  }
+  return {data_.data(), size};
+}
+
+void Node::set_string(std::string_view value) {
+  if (value.size() > std::numeric_limits<std::uint32_t>::max()) {
+    SOURCERER_THROW(std::length_error("String value is too long"));
+  }
+
+  std::array<char, small_capacity + 1> data{};
+  if (value.size() <= small_capacity) {
+    std::ranges::copy(value, data.begin());
+    data.back() = static_cast<char>(value.size());
+  } else {
+    auto* buffer = static_cast<char*>(resource_->allocate(value.size(), 1));
+    std::ranges::copy(value, buffer);
+
+    const auto size = static_cast<std::uint32_t>(value.size());
+    std::memcpy(data.data(), &buffer, sizeof(buffer));
+    std::memcpy(data.data() + sizeof(buffer), &size, sizeof(size));
+    data.back() = static_cast<char>(large_string);
+  }
+
+  // value might point into the current payload, so it's only released once the copy is done.
+  reset();
+  data_ = data;
+  kind_ = detail::node_kind::string;
+}
+
+void Node::unshare() {
+  switch (kind_) {
+    case detail::node_kind::array: {
+      auto* copy = make_block<array_t>(resource_, std::as_const(block<array_t>()->value()));
+      block<array_t>()->release();
+      set_payload(copy);
+      break;
+    }
+    case detail::node_kind::object: {
+      auto* copy = make_block<object_t>(resource_, std::as_const(block<object_t>()->value()));
+      block<object_t>()->release();
+      set_payload(copy);
+      break;
+    }
+    default:
+      break;
+  }
+}
+
+void Node::make_empty(const detail::node_kind kind) {
+  if (kind == detail::node_kind::array) {
+    auto* empty = make_block<array_t>(resource_);
+    reset();
+    set_payload(empty);
+  } else {
+    auto* empty = make_block<object_t>(resource_);
+    reset();
+    set_payload(empty);
+  }
+  kind_ = kind;
+}
+
+void Node::steal(Node& other) noexcept {
+  assert(resource_ == other.resource_);
+
+  reset();
+  data_ = other.data_;
+  kind_ = std::exchange(other.kind_, detail::node_kind::null);
+}
+
+void Node::reset() noexcept {
+  switch (kind_) {
+    case detail::node_kind::string:
+      if (static_cast<unsigned char>(data_.back()) == large_string) {
+        const auto view = string();
+        resource_->deallocate(const_cast<char*>(view.data()), view.size(), 1);
+      }
+      break;
+    case detail::node_kind::array:
+      block<array_t>()->release();
+      break;
+    case detail::node_kind::object:
+      block<object_t>()->release();
+      break;
+    default:
+      break;
+  }
+
+  kind_ = detail::node_kind::null;
+}
+
 }  // namespace sourcerer
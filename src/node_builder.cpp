@@ -0,0 +1,131 @@
+#include "sourcerer/node_builder.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace sourcerer {
+
+NodeBuilder::NodeBuilder(const Node::allocator_type& alloc, std::shared_ptr<KeyPool> keys,
+                         const Node::key_order order)
+    : alloc_{alloc}, pool_{std::move(keys)}, order_{order} {}
+
+void NodeBuilder::begin_array() {
+  expect_value();
+  frames_.push_back({false, values_.size(), keys_.size()});
+}
+
+void NodeBuilder::end_array() {
+  const auto frame = pop_frame(false);
+  const auto first = values_.begin() + static_cast<std::ptrdiff_t>(frame.first_value);
+
+  Node::array_t array{alloc_};
+  array.reserve(static_cast<size_type>(values_.end() - first));
+  for (auto it = first; it != values_.end(); ++it) {
+    array.emplace_back(std::move(*it));
+  }
+
+  values_.erase(first, values_.end());
+  values_.emplace_back(std::move(array));
+}
+
+void NodeBuilder::begin_object() {
+  expect_value();
+  frames_.push_back({true, values_.size(), keys_.size()});
+}
+
+void NodeBuilder::end_object() {
+  const auto frame = pop_frame(true);
+  if (keys_.size() - frame.first_key != values_.size() - frame.first_value) {
+    SOURCERER_THROW(std::logic_error("The last key of the object has no value"));
+  }
+
+  const auto size = values_.size() - frame.first_value;
+  const auto key_at = [&](const size_type i) -> const Key& { return keys_[frame.first_key + i]; };
+  const auto value_at = [&](const size_type i) -> Node& { return values_[frame.first_value + i]; };
+
+  Node::object_t object{pool_, order_, alloc_};
+  object.reserve(size);
+
+  if (order_ == Node::key_order::insertion) {
+    for (size_type i = 0; i < size; ++i) {
+      auto [it, inserted] = object.try_emplace(key_at(i), std::move(value_at(i)));
+      if (!inserted) {
+        it->second = std::move(value_at(i));
+      }
+    }
+  } else {
+    permutation_.resize(size);
+    std::iota(permutation_.begin(), permutation_.end(), size_type{0});
+    if (!std::ranges::is_sorted(permutation_, std::less<>{}, key_at)) {
+      std::ranges::stable_sort(permutation_, std::less<>{}, key_at);
+    }
+
+    // Equal keys are next to each other now, in the order they were added.
+    for (size_type i = 0; i < size; ++i) {
+      const auto current = permutation_[i];
+      if (i + 1 < size && key_at(permutation_[i + 1]) == key_at(current)) continue;
+
+      object.emplace_hint(object.cend(), key_at(current), std::move(value_at(current)));
+    }
+  }
+
+  values_.erase(values_.begin() + static_cast<std::ptrdiff_t>(frame.first_value), values_.end());
+  keys_.erase(keys_.begin() + static_cast<std::ptrdiff_t>(frame.first_key), keys_.end());
+  values_.emplace_back(std::move(object));
+}
+
+void NodeBuilder::key(std::string_view key) { this->key(pool_->intern(key)); }
+
+void NodeBuilder::key(const Key& key) {
+  if (frames_.empty() || !frames_.back().object) {
+    SOURCERER_THROW(std::logic_error("Keys can only be added to objects"));
+  }
+
+  const auto& frame = frames_.back();
+  if (keys_.size() - frame.first_key != values_.size() - frame.first_value) {
+    SOURCERER_THROW(std::logic_error("The previous key of the object has no value"));
+  }
+
+  keys_.push_back(key);
+}
+
+Node NodeBuilder::finish() {
+  if (!frames_.empty()) {
+    SOURCERER_THROW(std::logic_error("Can't finish a tree with open containers"));
+  }
+  if (values_.empty()) {
+    SOURCERER_THROW(std::logic_error("Can't finish an empty tree"));
+  }
+
+  Node root{std::move(values_.back())};
+  values_.clear();
+  return root;
+}
+
+void NodeBuilder::expect_value() const {
+  if (frames_.empty()) {
+    if (!values_.empty()) {
+      SOURCERER_THROW(std::logic_error("A tree can only have one root"));
+    }
+    return;
+  }
+
+  const auto& frame = frames_.back();
+  if (frame.object && keys_.size() - frame.first_key != values_.size() - frame.first_value + 1) {
+    SOURCERER_THROW(std::logic_error("Values of an object need a key"));
+  }
+}
+
+NodeBuilder::Frame NodeBuilder::pop_frame(const bool object) {
+  if (frames_.empty() || frames_.back().object != object) {
+    SOURCERER_THROW(std::logic_error(object ? "end_object without a matching begin_object"
+                                            : "end_array without a matching begin_array"));
+  }
+
+  const auto frame = frames_.back();
+  frames_.pop_back();
+  return frame;
+}
+
+}  // namespace sourcerer
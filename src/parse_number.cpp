@@ -0,0 +1,147 @@
+#include "sourcerer/detail/parse_number.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <system_error>
+
+namespace sourcerer::detail {
+
+namespace {
+
+// Eight more digits always fit into 64 bits while the value is below this.
+constexpr std::uint64_t max_before_chunk = 100000000000;
+// Any digit can be appended to values below this without overflowing.
+constexpr std::uint64_t max_before_digit = (std::numeric_limits<std::uint64_t>::max() - 9) / 10;
+// Integers up to this are exactly representable as doubles.
+constexpr std::uint64_t max_exact = std::uint64_t{1} << 53;
+
+constexpr std::array<double, 23> powers_of_ten = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Whether the eight characters in chunk are all digits.
+bool all_digits(const std::uint64_t chunk) noexcept {
+  return ((chunk & 0xF0F0F0F0F0F0F0F0) |
+          (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) == 0x3333333333333333;
+}
+
+// The value of the eight digits in chunk, the first one in its lowest byte. Pairs of digits are
+// combined, then pairs of pairs, then the two halves.
+std::uint64_t eight_digits(std::uint64_t chunk) noexcept {
+  constexpr std::uint64_t mask = 0x000000FF000000FF;
+  constexpr std::uint64_t high = 100 + (std::uint64_t{1000000} << 32);
+  constexpr std::uint64_t low = 1 + (std::uint64_t{10000} << 32);
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  return (((chunk & mask) * high) + (((chunk >> 16) & mask) * low)) >> 32;
+}
+
+// Adds the digits at p to value and returns where they end, or nullptr if the value doesn't fit
+// into 64 bits. Leading zeros don't count against that.
+const char* digits(const char* p, const char* end, std::uint64_t& value) noexcept {
+  // A local, so the loops don't store it through the reference p may alias.
+  auto result = value;
+  if constexpr (std::endian::native == std::endian::little) {
+    while (end - p >= 8 && result < max_before_chunk) {
+      std::uint64_t chunk;
+      std::memcpy(&chunk, p, sizeof(chunk));
+      if (!all_digits(chunk)) break;
+
+      result = result * 100000000 + eight_digits(chunk);
+      p += 8;
+    }
+  }
+  for (; p != end && *p >= '0' && *p <= '9'; ++p) {
+    const auto digit = static_cast<std::uint64_t>(*p - '0');
+    if (result > max_before_digit &&
+        result > (std::numeric_limits<std::uint64_t>::max() - digit) / 10) {
+      return nullptr;
+    }
+    result = result * 10 + digit;
+  }
+  value = result;
+  return p;
+}
+
+template <class T>
+bool from_chars(const std::string_view text, T& value) noexcept {
+  const auto [ptr, ec] = std::from_chars(text.data(), text.data() + text.size(), value);
+  return ec == std::errc{} && ptr == text.data() + text.size();
+}
+
+}  // namespace
+
+bool parse_integer(const std::string_view text, std::uint64_t& magnitude,
+                   bool& negative) noexcept {
+  const auto* p = text.data();
+  const auto* end = p + text.size();
+  negative = p != end && *p == '-';
+  if (negative) ++p;
+
+  std::uint64_t value = 0;
+  const auto* first = p;
+  p = digits(p, end, value);
+  if (p != end || p == first) return false;
+
+  magnitude = value;
+  return true;
+}
+
+bool parse_double(const std::string_view text, double& value) noexcept {
+  const auto* p = text.data();
+  const auto* end = p + text.size();
+  const auto negative = p != end && *p == '-';
+  if (negative) ++p;
+
+  std::uint64_t mantissa = 0;
+  const auto* first = p;
+  p = digits(p, end, mantissa);
+  if (p == nullptr || p == first) return false;
+
+  std::size_t decimals = 0;
+  if (p != end && *p == '.') {
+    first = p + 1;
+    p = digits(first, end, mantissa);
+    if (p == nullptr || p == first) return false;
+    decimals = static_cast<std::size_t>(p - first);
+  }
+  if (p != end || mantissa > max_exact || decimals >= powers_of_ten.size()) return false;
+
+  // Both operands are exact, so the quotient is rounded once, like from_chars rounds.
+  value = static_cast<double>(mantissa) / powers_of_ten[decimals];
+  if (negative) value = -value;
+  return true;
+}
+
+std::size_t parse_numbers(const std::span<const std::string_view> texts,
+                          const std::span<double> values) noexcept {
+  const auto size = std::min(texts.size(), values.size());
+  for (std::size_t i = 0; i < size; ++i) {
+    if (!parse_double(texts[i], values[i]) && !from_chars(texts[i], values[i])) return i;
+  }
+  return size;
+}
+
+std::size_t parse_numbers(const std::span<const std::string_view> texts,
+                          const std::span<std::int64_t> values) noexcept {
+  constexpr auto max = static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max());
+
+  const auto size = std::min(texts.size(), values.size());
+  for (std::size_t i = 0; i < size; ++i) {
+    std::uint64_t magnitude = 0;
+    bool negative = false;
+    if (parse_integer(texts[i], magnitude, negative) && magnitude <= max) {
+      values[i] = negative ? -static_cast<std::int64_t>(magnitude)
+                           : static_cast<std::int64_t>(magnitude);
+    } else if (!from_chars(texts[i], values[i])) {
+      return i;
+    }
+  }
+  return size;
+}
+
+}  // namespace sourcerer::detail
@@ -0,0 +1,337 @@
+#include "sourcerer/path.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <stdexcept>
+
+namespace sourcerer {
+
+namespace {
+
+using step_kind = detail::path_step::kind;
+
+class Parser {
+ public:
+  explicit Parser(std::string_view path) : path_{path} {}
+
+  std::vector<detail::path_step> parse() {
+    std::vector<detail::path_step> steps;
+    if (path_.empty()) return steps;
+
+    // The first key may leave out its dot.
+    if (peek() != '[' && peek() != '.') {
+      steps.push_back(key());
+    }
+
+    while (!done()) {
+      if (peek() == '.') {
+        ++position_;
+        steps.push_back(key());
+      } else if (peek() == '[') {
+        ++position_;
+        steps.push_back(bracket());
+        expect(']');
+      } else {
+        fail("expected '.' or '['");
+      }
+    }
+    return steps;
+  }
+
+ private:
+  bool done() const noexcept { return position_ == path_.size(); }
+  char peek() const noexcept { return done() ? '\0' : path_[position_]; }
+
+  [[noreturn]] void fail(const std::string& reason) const {
+    SOURCERER_THROW(std::invalid_argument("Invalid path \"" + std::string{path_} +
+                                          "\" at position " + std::to_string(position_) + ": " +
+                                          reason));
+  }
+
+  void expect(const char c) {
+    if (peek() != c) fail(std::string{"expected '"} + c + "'");
+    ++position_;
+  }
+
+  detail::path_step key() {
+    const auto end = path_.find_first_of(".[]", position_);
+    const auto text = path_.substr(position_, end - position_);
+    if (text.empty()) fail("expected a key");
+
+    position_ += text.size();
+    if (text == "*") return {};
+    return make_key(std::string{text});
+  }
+
+  detail::path_step bracket() {
+    if (peek() == '"') return quoted();
+    if (peek() == '*') {
+      ++position_;
+      return {};
+    }
+
+    detail::path_step step;
+    step.type = step_kind::index;
+    step.start = number();
+    if (peek() == ':') {
+      ++position_;
+      step.type = step_kind::slice;
+      step.stop = number();
+    } else if (!step.start) {
+      fail("expected an index, a slice, '*' or a quoted key");
+    }
+    return step;
+  }
+
+  detail::path_step quoted() {
+    ++position_;
+    std::string text;
+    while (peek() != '"') {
+      if (done()) fail("unterminated key");
+      if (peek() == '\\') {
+        ++position_;
+        if (peek() != '"' && peek() != '\\') fail("expected '\"' or '\\' after '\\'");
+      }
+      text.push_back(path_[position_++]);
+    }
+    ++position_;
+    return make_key(std::move(text));
+  }
+
+  std::optional<std::int64_t> number() {
+    if (peek() != '-' && (peek() < '0' || peek() > '9')) return std::nullopt;
+
+    std::int64_t value = 0;
+    const auto* first = path_.data() + position_;
+    const auto [ptr, ec] = std::from_chars(first, path_.data() + path_.size(), value);
+    if (ec != std::errc{}) fail("expected a number");
+
+    position_ += static_cast<std::size_t>(ptr - first);
+    return value;
+  }
+
+  static detail::path_step make_key(std::string text) {
+    detail::path_step step;
+    step.type = step_kind::key;
+    step.hash = Key::hash(text);
+    step.key = std::move(text);
+    return step;
+  }
+
+  std::string_view path_;
+  std::size_t position_ = 0;
+};
+
+// Resolves a possibly negative index into an array of size, clamped to [0, size].
+std::size_t clamp(const std::int64_t index, const std::size_t size) noexcept {
+  const auto signed_size = static_cast<std::int64_t>(size);
+  const auto resolved = index < 0 ? index + signed_size : index;
+  return static_cast<std::size_t>(std::clamp<std::int64_t>(resolved, 0, signed_size));
+}
+
+}  // namespace
+
+namespace detail {
+
+void append_key(std::string& path, std::string_view key) {
+  if (!key.empty() && key != "*" && key.find_first_of(".[]") == std::string_view::npos) {
+    if (!path.empty()) path += '.';
+    path += key;
+    return;
+  }
+
+  path += "[\"";
+  for (const auto c : key) {
+    if (c == '"' || c == '\\') path += '\\';
+    path += c;
+  }
+  path += "\"]";
+}
+
+void append_index(std::string& path, const std::size_t index) {
+  path += '[';
+  path += std::to_string(index);
+  path += ']';
+}
+
+}  // namespace detail
+
+Path::Path(std::string_view path) : text_{path}, steps_{Parser{path}.parse()} {
+  single_ = std::ranges::all_of(steps_, [](const detail::path_step& step) {
+    return step.type == step_kind::key || step.type == step_kind::index;
+  });
+}
+
+const Node* Path::find(const Node& root) const noexcept {
+  if (single_) {
+    // Each step selects at most one node, so they are simply taken one after the other.
+    const auto* node = &root;
+    for (const auto& step : steps_) {
+      node = select(step, *node);
+      if (node == nullptr) break;
+    }
+    return node;
+  }
+
+  const Node* found = nullptr;
+  const auto first = [](void* context, std::size_t, const Node& node) {
+    *static_cast<const Node**>(context) = &node;
+    return false;
+  };
+  visit(root, steps_, 0, first, &found);
+  return found;
+}
+
+const Node& Path::at(const Node& root) const {
+  if (const auto* node = find(root); node != nullptr) {
+    return *node;
+  }
+  SOURCERER_THROW(std::out_of_range("Path not found: " + text_));
+}
+
+const Node* Path::select(const detail::path_step& step, const Node& node) noexcept {
+  if (step.type == step_kind::key) {
+    if (!node.is_object()) return nullptr;
+
+    const auto& object = node.get<Node::object_t>();
+    const auto it = object.find(step.key, step.hash);
+    return it == object.end() ? nullptr : &it->second;
+  }
+
+  if (!node.is_array()) return nullptr;
+
+  const auto& array = node.get<Node::array_t>();
+  const auto signed_size = static_cast<std::int64_t>(array.size());
+  const auto index = *step.start < 0 ? *step.start + signed_size : *step.start;
+  if (index < 0 || index >= signed_size) return nullptr;
+  return &array[static_cast<std::size_t>(index)];
+}
+
+bool Path::apply(const detail::path_step& step, const Node& node, const std::size_t path,
+                 detail::path_visitor visitor, void* context) {
+  switch (step.type) {
+    case step_kind::key:
+    case step_kind::index: {
+      const auto* selected = select(step, node);
+      return selected == nullptr || visitor(context, path, *selected);
+    }
+    case step_kind::slice: {
+      if (!node.is_array()) return true;
+
+      const auto& array = node.get<Node::array_t>();
+      const auto first = step.start ? clamp(*step.start, array.size()) : 0;
+      const auto last = step.stop ? clamp(*step.stop, array.size()) : array.size();
+      for (auto i = first; i < last; ++i) {
+        if (!visitor(context, path, array[i])) return false;
+      }
+      return true;
+    }
+    case step_kind::wildcard:
+      if (node.is_array()) {
+        for (const auto& child : node.get<Node::array_t>()) {
+          if (!visitor(context, path, child)) return false;
+        }
+      } else if (node.is_object()) {
+        for (const auto& [key, child] : node.get<Node::object_t>()) {
+          if (!visitor(context, path, child)) return false;
+        }
+      }
+      return true;
+  }
+
+  return true;  // Make compiler happy.
+}
+
+bool Path::visit(const Node& node, std::span<const detail::path_step> steps, const std::size_t path,
+                 detail::path_visitor visitor, void* context) {
+  if (steps.empty()) {
+    return visitor(context, path, node);
+  }
+
+  struct Rest {
+    std::span<const detail::path_step> steps;
+    detail::path_visitor visitor;
+    void* context;
+  };
+  Rest rest{steps.subspan(1), visitor, context};
+
+  const auto descend = [](void* rest_context, const std::size_t rest_path, const Node& child) {
+    const auto& next = *static_cast<Rest*>(rest_context);
+    return visit(child, next.steps, rest_path, next.visitor, next.context);
+  };
+  return apply(steps.front(), node, path, descend, &rest);
+}
+
+PathSet::PathSet() : trie_(1) {}
+
+PathSet::PathSet(std::span<const std::string_view> paths) : PathSet() {
+  for (const auto path : paths) {
+    add(path);
+  }
+}
+
+PathSet::size_type PathSet::add(const Path& path) {
+  size_type current = 0;
+  for (const auto& step : path.steps_) {
+    const auto& children = trie_[current].children;
+    const auto it = std::ranges::find_if(
+        children, [&](const size_type child) { return trie_[child].step == step; });
+    if (it != children.end()) {
+      current = *it;
+      continue;
+    }
+
+    trie_.push_back({step, {}, {}});
+    trie_[current].children.push_back(trie_.size() - 1);
+    current = trie_.size() - 1;
+  }
+
+  paths_.push_back(path);
+  trie_[current].paths.push_back(paths_.size() - 1);
+  return paths_.size() - 1;
+}
+
+void PathSet::resolve(const Node& root, std::span<const Node*> results) const {
+  if (results.size() != size()) {
+    SOURCERER_THROW(std::invalid_argument("Need one result per path, got " +
+                                          std::to_string(results.size()) + " for " +
+                                          std::to_string(size()) + " paths"));
+  }
+
+  std::ranges::fill(results, nullptr);
+  const auto first = [](void* context, const std::size_t path, const Node& node) {
+    auto& result = static_cast<const Node**>(context)[path];
+    if (result == nullptr) {
+      result = &node;
+    }
+    return true;
+  };
+  visit(root, 0, first, results.data());
+}
+
+void PathSet::visit(const Node& node, const size_type trie, detail::path_visitor visitor,
+                    void* context) const {
+  const auto& current = trie_[trie];
+  for (const auto path : current.paths) {
+    visitor(context, path, node);
+  }
+
+  struct Child {
+    const PathSet* set;
+    size_type trie;
+    detail::path_visitor visitor;
+    void* context;
+  };
+
+  for (const auto child : current.children) {
+    Child next{this, child, visitor, context};
+    const auto descend = [](void* child_context, std::size_t, const Node& match) {
+      const auto& next = *static_cast<Child*>(child_context);
+      next.set->visit(match, next.trie, next.visitor, next.context);
+      return true;
+    };
+    Path::apply(trie_[child].step, node, 0, descend, &next);
+  }
+}
+
+}  // namespace sourcerer
@@ -0,0 +1,152 @@
+#include "sourcerer/publisher.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace sourcerer {
+
+// A cache line of its own, so readers announcing their epochs don't slow each other down.
+struct alignas(64) Publisher::Reader::Slot {
+  // The epoch the reader started reading in, 0 while it doesn't read.
+  std::atomic<std::uint64_t> epoch{0};
+  std::atomic<bool> taken{true};
+  Slot* next = nullptr;
+};
+
+Publisher::Guard::Guard(Guard&& other) noexcept
+    : reader_{std::exchange(other.reader_, nullptr)},
+      root_{other.root_},
+      version_{other.version_} {}
+
+Publisher::Guard::~Guard() {
+  if (reader_ != nullptr) {
+    reader_->unpin();
+  }
+}
+
+Publisher::Reader::Reader(Reader&& other) noexcept
+    : publisher_{other.publisher_},
+      slot_{std::exchange(other.slot_, nullptr)},
+      depth_{other.depth_} {}
+
+Publisher::Reader::~Reader() {
+  if (slot_ != nullptr) {
+    slot_->epoch.store(0, std::memory_order_release);
+    slot_->taken.store(false, std::memory_order_release);
+  }
+}
+
+Publisher::Guard Publisher::Reader::read() noexcept {
+  // The epoch is announced before the version is loaded. A writer that doesn't see the
+  // announcement yet replaced the version before it is loaded, so the reader gets the new one.
+  if (depth_++ == 0) {
+    slot_->epoch.store(publisher_->epoch_.load(std::memory_order_seq_cst),
+                       std::memory_order_seq_cst);
+  }
+  const auto* version = publisher_->current_.load(std::memory_order_seq_cst);
+  return Guard{*this, version->root, version->number};
+}
+
+void Publisher::Reader::unpin() noexcept {
+  if (--depth_ == 0) {
+    slot_->epoch.store(0, std::memory_order_release);
+  }
+}
+
+Publisher::Publisher(Node root) : current_{new Version{std::move(root), 0}} {}
+
+Publisher::~Publisher() {
+  delete current_.load(std::memory_order_relaxed);
+  auto* slot = slots_.load(std::memory_order_relaxed);
+  while (slot != nullptr) {
+    delete std::exchange(slot, slot->next);
+  }
+}
+
+Publisher::Reader Publisher::reader() {
+  auto* head = slots_.load(std::memory_order_acquire);
+  for (auto* slot = head; slot != nullptr; slot = slot->next) {
+    if (bool taken = false; slot->taken.compare_exchange_strong(taken, true)) {
+      return Reader{*this, *slot};
+    }
+  }
+
+  auto* slot = new Reader::Slot;
+  slot->next = head;
+  while (!slots_.compare_exchange_weak(slot->next, slot, std::memory_order_release,
+                                       std::memory_order_acquire)) {
+  }
+  return Reader{*this, *slot};
+}
+
+void Publisher::publish(Node root) {
+  auto next = std::make_unique<Version>(Version{std::move(root), 0});
+  std::vector<std::unique_ptr<Version>> drained;
+  {
+    std::scoped_lock lock{mutex_};
+    replace(std::move(next));
+    collect(drained);
+  }
+  // The drained versions are destroyed here, without holding up other writers.
+}
+
+void Publisher::update(const std::function<void(Node&)>& update) {
+  std::vector<std::unique_ptr<Version>> drained;
+  {
+    std::scoped_lock lock{mutex_};
+    // The copy shares the containers of the current version, and clones the ones it changes.
+    const auto& current = current_.load(std::memory_order_relaxed)->root;
+    auto next = std::make_unique<Version>(Version{current, 0});
+    update(next->root);
+    replace(std::move(next));
+    collect(drained);
+  }
+}
+
+Node Publisher::current() const {
+  std::scoped_lock lock{mutex_};
+  return current_.load(std::memory_order_relaxed)->root;
+}
+
+void Publisher::reclaim() {
+  std::vector<std::unique_ptr<Version>> drained;
+  std::scoped_lock lock{mutex_};
+  collect(drained);
+}
+
+std::size_t Publisher::retired() const {
+  std::scoped_lock lock{mutex_};
+  return retired_.size();
+}
+
+void Publisher::replace(std::unique_ptr<Version> next) {
+  next->number = version_.load(std::memory_order_relaxed) + 1;
+  std::unique_ptr<Version> previous{current_.exchange(next.release(), std::memory_order_seq_cst)};
+  // Readers that announce this epoch or a later one load the new version.
+  const auto epoch = epoch_.fetch_add(1, std::memory_order_seq_cst) + 1;
+  version_.fetch_add(1, std::memory_order_release);
+  retired_.push_back({std::move(previous), epoch});
+}
+
+void Publisher::collect(std::vector<std::unique_ptr<Version>>& drained) {
+  if (retired_.empty()) return;
+
+  auto oldest = std::numeric_limits<std::uint64_t>::max();
+  for (auto* slot = slots_.load(std::memory_order_acquire); slot != nullptr; slot = slot->next) {
+    if (const auto epoch = slot->epoch.load(std::memory_order_seq_cst); epoch != 0) {
+      oldest = std::min(oldest, epoch);
+    }
+  }
+
+  // A reader that announced an epoch before the one a version was retired in may still see it,
+  // the others are moved to the back.
+  const auto unseen = std::ranges::stable_partition(
+      retired_, [&](const Retired& retired) { return oldest < retired.epoch; });
+  for (auto& retired : unseen) {
+    drained.push_back(std::move(retired.version));
+  }
+  retired_.erase(unseen.begin(), unseen.end());
+}
+
+}  // namespace sourcerer
@@ -0,0 +1,317 @@
+#include "sourcerer/sourcerers/reloading_sourcerer.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_set>
+
+#if __has_include(<sys/inotify.h>)
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include <cerrno>
+#define SOURCERER_HAS_INOTIFY
+#endif
+
+#include "sourcerer/conjurers/file_conjurer.hpp"
+#include "sourcerer/sourcerers/json_sourcerer.hpp"
+
+namespace sourcerer {
+
+#ifndef SOURCERER_HAS_INOTIFY
+namespace {
+
+// How often the modification times are compared while waiting.
+constexpr std::chrono::milliseconds poll_interval{50};
+
+}  // namespace
+#endif
+
+Node ReloadingSourcerer::parse_json(Conjurer& conjurer) {
+  return JsonSourcerer{conjurer}.source();
+}
+
+ReloadingSourcerer::ReloadingSourcerer(std::filesystem::path file, parser parse)
+    : parse_{std::move(parse)} {
+  files_.push_back(File{{}, std::move(file)});
+  watch();
+
+  FileConjurer conjurer{files_.front().path.string()};
+  root_ = parse_(conjurer);
+  own(root_);
+}
+
+ReloadingSourcerer::ReloadingSourcerer(
+    std::vector<std::pair<std::string, std::filesystem::path>> files, parser parse)
+    : parse_{std::move(parse)} {
+  // Reserved, the keys refer to the files.
+  files_.reserve(files.size());
+  std::unordered_set<std::string_view> keys;
+  for (auto& [key, path] : files) {
+    files_.push_back(File{std::move(key), std::move(path)});
+    if (!keys.insert(files_.back().key).second) {
+      SOURCERER_THROW(std::invalid_argument("Key mounted twice: " + files_.back().key));
+    }
+  }
+  watch();
+
+  root_ = Node{Node::object_t{}};
+  for (const auto& file : files_) {
+    FileConjurer conjurer{file.path.string()};
+    root_.emplace(file.key, parse_(conjurer));
+  }
+  own(root_);
+}
+
+ReloadingSourcerer::~ReloadingSourcerer() = default;
+
+ReloadingSourcerer::Watcher::~Watcher() {
+#ifdef SOURCERER_HAS_INOTIFY
+  if (descriptor >= 0) {
+    ::close(descriptor);
+  }
+#endif
+}
+
+ReloadReport ReloadingSourcerer::poll() {
+  collect();
+  return reload_dirty();
+}
+
+ReloadReport ReloadingSourcerer::wait(const std::chrono::milliseconds timeout) {
+  const auto deadline = std::chrono::steady_clock::now() + timeout;
+  while (true) {
+    // Changes to other files of the watched directories don't count.
+    auto report = poll();
+    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(
+        deadline - std::chrono::steady_clock::now());
+    if (!report.empty() || remaining.count() <= 0) return report;
+
+#ifdef SOURCERER_HAS_INOTIFY
+    pollfd descriptor{watcher_.descriptor, POLLIN, 0};
+    ::poll(&descriptor, 1, static_cast<int>(remaining.count()));
+#else
+    std::this_thread::sleep_for(std::min(remaining, poll_interval));
+#endif
+  }
+}
+
+ReloadReport ReloadingSourcerer::reload() {
+  // Events that are pending refer to the state that is reloaded now.
+  collect();
+  for (auto& file : files_) {
+    file.dirty = true;
+  }
+  return reload_dirty();
+}
+
+ReloadReport ReloadingSourcerer::reload(const std::size_t file) {
+  if (file >= files_.size()) {
+    SOURCERER_THROW(std::out_of_range("File out of range"));
+  }
+  ReloadReport report;
+  files_[file].dirty = false;
+  load(files_[file], report);
+  return report;
+}
+
+void ReloadingSourcerer::watch() {
+#ifdef SOURCERER_HAS_INOTIFY
+  watcher_.descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (watcher_.descriptor < 0) {
+    SOURCERER_THROW(std::system_error(errno, std::generic_category(), "Can't watch files"));
+  }
+
+  // The directories are watched rather than the files, which editors and deployments replace by
+  // renaming a new file over them. Watching a directory twice returns the same watch.
+  for (auto& file : files_) {
+    auto directory = file.path.parent_path();
+    if (directory.empty()) directory = ".";
+    file.watch = inotify_add_watch(watcher_.descriptor, directory.c_str(),
+                                   IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (file.watch < 0) {
+      const auto error = errno;
+      SOURCERER_THROW(std::system_error(error, std::generic_category(),
+                                        "Can't watch directory: " + directory.string()));
+    }
+  }
+#else
+  for (auto& file : files_) {
+    std::error_code error;
+    file.modified = std::filesystem::last_write_time(file.path, error);
+  }
+#endif
+}
+
+void ReloadingSourcerer::collect() {
+#ifdef SOURCERER_HAS_INOTIFY
+  alignas(inotify_event) char buffer[4096];
+  while (true) {
+    const auto length = ::read(watcher_.descriptor, buffer, sizeof(buffer));
+    // Fails with EAGAIN once all events are read.
+    if (length <= 0) return;
+
+    for (auto offset = 0L; offset < length;) {
+      const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+      offset += static_cast<long>(sizeof(inotify_event) + event->len);
+
+      if ((event->mask & IN_Q_OVERFLOW) != 0) {
+        // Events were dropped, so any file could have changed.
+        for (auto& file : files_) file.dirty = true;
+        continue;
+      }
+      if (event->len == 0) continue;
+
+      const std::string_view name{event->name};
+      for (auto& file : files_) {
+        if (file.watch == event->wd && file.path.filename() == name) {
+          file.dirty = true;
+        }
+      }
+    }
+  }
+#else
+  for (auto& file : files_) {
+    std::error_code error;
+    const auto modified = std::filesystem::last_write_time(file.path, error);
+    if (!error && modified != file.modified) {
+      file.modified = modified;
+      file.dirty = true;
+    }
+  }
+#endif
+}
+
+ReloadReport ReloadingSourcerer::reload_dirty() {
+  ReloadReport report;
+  for (auto& file : files_) {
+    if (!file.dirty) continue;
+    file.dirty = false;
+    load(file, report);
+  }
+  return report;
+}
+
+void ReloadingSourcerer::load(File& file, ReloadReport& report) {
+  Node fresh;
+  SOURCERER_TRY {
+    FileConjurer conjurer{file.path.string()};
+    // Swapped in, assigning would copy the tree out of the arena of the parser.
+    auto parsed = parse_(conjurer);
+    fresh.swap(parsed);
+  } SOURCERER_CATCH(...) {
+    report.failed.emplace_back(file.path, std::current_exception());
+    return;
+  }
+
+  std::string path;
+  if (file.key.empty()) {
+    patch(root_, fresh, path, report.changed);
+    return;
+  }
+
+  // Only written to if the file changed, which would clone it if a snapshot shares it.
+  if (std::as_const(root_).at(file.key) == fresh) return;
+  detail::append_key(path, file.key);
+  patch(root_.mutate<Node::object_t>(false).find(file.key)->second, fresh, path, report.changed);
+}
+
+void ReloadingSourcerer::patch(Node& live, const Node& fresh, std::string& path,
+                               std::vector<Path>& changed) {
+  const auto length = path.size();
+
+  if (live.is_object() && fresh.is_object()) {
+    const auto& current = std::as_const(live).get<Node::object_t>();
+    const auto& next = fresh.get<Node::object_t>();
+
+    // The changes are found first, the container is only written to if there are any. Subtrees
+    // with different hashes differ, the hashes of the live tree are cached from the last reload.
+    // Equal hashes are verified by operator==, they could collide.
+    std::vector<std::string_view> removed;
+    std::vector<std::pair<std::string_view, const Node*>> replaced;
+    std::vector<std::pair<std::string_view, const Node*>> added;
+    for (const auto& [key, value] : current) {
+      if (!next.contains(key.view())) removed.push_back(key.view());
+    }
+    for (const auto& [key, value] : next) {
+      const auto it = current.find(key.view());
+      if (it == current.end()) {
+        added.emplace_back(key.view(), &value);
+      } else if (it->second != value) {
+        replaced.emplace_back(key.view(), &value);
+      }
+    }
+    if (removed.empty() && replaced.empty() && added.empty()) return;
+
+    auto& object = live.mutate<Node::object_t>(false);
+    for (const auto key : removed) {
+      object.erase(key);
+      detail::append_key(path, key);
+      changed.emplace_back(path);
+      path.resize(length);
+    }
+    for (const auto& [key, value] : replaced) {
+      detail::append_key(path, key);
+      patch(object.find(key)->second, *value, path, changed);
+      path.resize(length);
+    }
+    for (const auto& [key, value] : added) {
+      own(object.try_emplace(key, *value).first->second);
+      detail::append_key(path, key);
+      changed.emplace_back(path);
+      path.resize(length);
+    }
+    return;
+  }
+
+  if (live.is_array() && fresh.is_array()) {
+    const auto& current = std::as_const(live).get<Node::array_t>();
+    const auto& next = fresh.get<Node::array_t>();
+    const auto common = std::min(current.size(), next.size());
+
+    std::vector<std::size_t> replaced;
+    for (std::size_t i = 0; i < common; ++i) {
+      if (current[i] != next[i]) replaced.push_back(i);
+    }
+    if (replaced.empty() && current.size() == next.size()) return;
+
+    // Elements are patched by position, the ones past the end of the shorter array are added or
+    // removed.
+    auto& array = live.mutate<Node::array_t>(false);
+    for (const auto i : replaced) {
+      detail::append_index(path, i);
+      patch(array[i], next[i], path, changed);
+      path.resize(length);
+    }
+    for (auto i = common; i < std::max(array.size(), next.size()); ++i) {
+      detail::append_index(path, i);
+      changed.emplace_back(path);
+      path.resize(length);
+    }
+    array.erase(array.begin() + static_cast<std::ptrdiff_t>(common), array.end());
+    for (auto i = common; i < next.size(); ++i) {
+      own(array.emplace_back(next[i]));
+    }
+    return;
+  }
+
+  if (live != fresh) {
+    live = fresh;
+    own(live);
+    changed.emplace_back(path);
+  }
+}
+
+void ReloadingSourcerer::own(Node& node) {
+  // Writing to a container clones it if it is shared or lives in another resource.
+  if (node.is_object()) {
+    for (auto& [key, child] : node.mutate<Node::object_t>(false)) own(child);
+  } else if (node.is_array()) {
+    for (auto& child : node.mutate<Node::array_t>(false)) own(child);
+  }
+}
+
+}  // namespace sourcerer
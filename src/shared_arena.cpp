@@ -0,0 +1,37 @@
+#include "sourcerer/detail/shared_arena.hpp"
+
+namespace sourcerer::detail {
+
+shared_arena::owner shared_arena::create(std::pmr::memory_resource* upstream) {
+  return owner{new shared_arena{upstream}};
+}
+
+shared_arena::shared_arena(std::pmr::memory_resource* upstream) : arena_{upstream} {}
+
+void shared_arena::release() noexcept {
+  if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    delete this;
+  }
+}
+
+void* shared_arena::do_allocate(std::size_t bytes, std::size_t alignment) {
+  auto* p = arena_.allocate(bytes, alignment);
+  refs_.fetch_add(1, std::memory_order_relaxed);
+  return p;
+}
+
+void shared_arena::do_deallocate(void* /*p*/, std::size_t /*bytes*/, std::size_t /*alignment*/) {
+  // Monotonic memory is only freed all at once, with the arena.
+  release();
+}
+
+bool shared_arena::do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+  return this == &other;
+}
+
+bool outlives_its_nodes(const std::pmr::memory_resource* resource) noexcept {
+  return resource == std::pmr::new_delete_resource() ||
+         dynamic_cast<const shared_arena*>(resource) != nullptr;
+}
+
+}  // namespace sourcerer::detail
@@ -0,0 +1,549 @@
+#include "sourcerer/snapshot.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <ranges>
+#include <span>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SOURCERER_HAS_MMAP
+#else
+#include <sstream>
+#endif
+
+#include "sourcerer/conjurers/string_conjurer.hpp"
+#include "sourcerer/node_builder.hpp"
+#include "sourcerer/sourcerers/json_sourcerer.hpp"
+
+namespace sourcerer {
+
+namespace {
+
+constexpr std::array<char, 8> magic = {'S', 'R', 'C', 'S', 'N', 'A', 'P', '\0'};
+
+std::uint32_t checked_offset(const std::size_t offset) {
+  if (offset > std::numeric_limits<std::uint32_t>::max()) {
+    SOURCERER_THROW(std::length_error("Node is too large for a snapshot"));
+  }
+  return static_cast<std::uint32_t>(offset);
+}
+
+void check_byte_order() {
+  if constexpr (std::endian::native != std::endian::little) {
+    SOURCERER_THROW(
+        std::invalid_argument("Snapshots are only supported on little-endian machines"));
+  }
+}
+
+// Why an entry reachable from the one at root refers to bytes outside the size bytes at data, empty
+// if none does. Children are written after their parent, and there are no more entries than fit,
+// which bounds the walk for crafted snapshots as well.
+std::string check_entries(const std::byte* data, const std::size_t size, const std::uint64_t root) {
+  using detail::node_kind;
+  using detail::snapshot_entry;
+  using detail::snapshot_member;
+  const auto fits = [&](const std::uint64_t offset, const std::uint64_t length) {
+    return offset >= sizeof(detail::snapshot_header) && offset <= size && length <= size - offset;
+  };
+
+  std::vector<std::uint64_t> pending{root};
+  auto entries = size / sizeof(snapshot_entry) - 1;
+  while (!pending.empty()) {
+    const auto offset = pending.back();
+    pending.pop_back();
+    const auto& entry = *reinterpret_cast<const snapshot_entry*>(data + offset);
+
+    switch (entry.kind) {
+      case node_kind::null:
+      case node_kind::boolean:
+      case node_kind::integer:
+      case node_kind::unsigned_integer:
+      case node_kind::floating:
+        break;
+      case node_kind::string:
+        if (!fits(entry.payload, entry.size)) return "string out of bounds";
+        break;
+      case node_kind::array:
+      case node_kind::object: {
+        const auto first = entry.payload;
+        const std::uint64_t count = entry.size;
+        const auto is_object = entry.kind == node_kind::object;
+        const auto unsorted = is_object && entry.sorted == 0;
+        const auto length = count * sizeof(snapshot_entry) +
+                            (is_object ? count * sizeof(snapshot_member) : 0) +
+                            (unsorted ? count * sizeof(std::uint32_t) : 0);
+        if (first % alignof(snapshot_entry) != 0 || first <= offset || !fits(first, length)) {
+          return "children out of bounds";
+        }
+        if (count > entries) return "too many entries";
+        entries -= count;
+
+        if (is_object) {
+          const auto* members = reinterpret_cast<const snapshot_member*>(
+              data + first + count * sizeof(snapshot_entry));
+          for (std::uint64_t i = 0; i < count; ++i) {
+            if (!fits(members[i].key, members[i].size)) return "key out of bounds";
+          }
+          const auto* order = reinterpret_cast<const std::uint32_t*>(members + count);
+          for (std::uint64_t i = 0; unsorted && i < count; ++i) {
+            if (order[i] >= count) return "key order out of bounds";
+          }
+        }
+        for (std::uint64_t i = 0; i < count; ++i) {
+          pending.push_back(first + i * sizeof(snapshot_entry));
+        }
+        break;
+      }
+      default:
+        return "unknown kind";
+    }
+  }
+  return {};
+}
+
+#ifndef SOURCERER_HAS_MMAP
+std::string read_file(const std::filesystem::path& path) {
+  std::ifstream file{path, std::ios::binary};
+  if (!file) {
+    SOURCERER_THROW(std::runtime_error("Can't read snapshot: " + path.string()));
+  }
+  std::stringstream buffer;
+  buffer << file.rdbuf();
+  return buffer.str();
+}
+#endif
+
+}  // namespace
+
+SnapshotNode SnapshotNode::at(const size_type index) const {
+  detail::throw_if_not(detail::node_kind::array, kind());
+  if (index >= entry_->size) {
+    SOURCERER_THROW(std::out_of_range("Index out of range"));
+  }
+  return SnapshotNode{base_, children() + index};
+}
+
+SnapshotNode SnapshotNode::at(std::string_view key) const {
+  if (const auto value = find(key)) {
+    return *value;
+  }
+  SOURCERER_THROW(std::out_of_range("Key not found: " + std::string{key}));
+}
+
+SnapshotNode SnapshotNode::operator[](const size_type index) const noexcept {
+  return SnapshotNode{base_, children() + index};
+}
+
+std::optional<SnapshotNode> SnapshotNode::find(std::string_view key) const {
+  detail::throw_if_not(detail::node_kind::object, kind());
+  const auto size = entry_->size;
+  const auto* members = this->members();
+  const auto key_of = [&](const std::uint32_t i) {
+    return std::string_view{at_offset<char>(members[i].key), members[i].size};
+  };
+
+  std::uint32_t found = size;
+  if (entry_->sorted != 0) {
+    const auto positions = std::views::iota(std::uint32_t{0}, size);
+    const auto it = std::ranges::lower_bound(positions, key, std::less<>{}, key_of);
+    if (it != positions.end() && key_of(*it) == key) found = *it;
+  } else {
+    const auto order = std::span{reinterpret_cast<const std::uint32_t*>(members + size), size};
+    const auto it = std::ranges::lower_bound(order, key, std::less<>{}, key_of);
+    if (it != order.end() && key_of(*it) == key) found = *it;
+  }
+
+  if (found == size) return std::nullopt;
+  return SnapshotNode{base_, children() + found, members + found};
+}
+
+std::string_view SnapshotNode::key() const {
+  if (member_ == nullptr) {
+    SOURCERER_THROW(std::logic_error("Only members of an object have a key"));
+  }
+  return {at_offset<char>(member_->key), member_->size};
+}
+
+SnapshotNode::size_type SnapshotNode::size() const noexcept {
+  switch (kind()) {
+    case detail::node_kind::null:
+      return 0;
+    case detail::node_kind::array:
+    case detail::node_kind::object:
+      return entry_->size;
+    default:
+      return 1;
+  }
+}
+
+Node SnapshotNode::node() const {
+  const auto order = is_object() && entry_->sorted == 0 ? Node::key_order::insertion
+                                                        : Node::key_order::sorted;
+  NodeBuilder builder{{}, std::make_shared<KeyPool>(), order};
+  build(builder);
+  return builder.finish();
+}
+
+void SnapshotNode::build(NodeBuilder& builder) const {
+  switch (kind()) {
+    case detail::node_kind::boolean:
+      builder.value(entry_->payload != 0);
+      break;
+    case detail::node_kind::integer:
+      builder.value(std::bit_cast<std::int64_t>(entry_->payload));
+      break;
+    case detail::node_kind::unsigned_integer:
+      builder.value(entry_->payload);
+      break;
+    case detail::node_kind::floating:
+      builder.value(std::bit_cast<double>(entry_->payload));
+      break;
+    case detail::node_kind::string:
+      builder.value(string());
+      break;
+    case detail::node_kind::array:
+      builder.begin_array();
+      for (const auto child : *this) {
+        child.build(builder);
+      }
+      builder.end_array();
+      break;
+    case detail::node_kind::object:
+      builder.begin_object();
+      for (const auto child : *this) {
+        builder.key(child.key());
+        child.build(builder);
+      }
+      builder.end_object();
+      break;
+    default:
+      builder.value();
+      break;
+  }
+}
+
+SnapshotNode::const_iterator SnapshotNode::begin() const noexcept {
+  switch (kind()) {
+    case detail::node_kind::null:
+      return const_iterator{base_, entry_, nullptr};
+    case detail::node_kind::array:
+      return const_iterator{base_, children(), nullptr};
+    case detail::node_kind::object:
+      return const_iterator{base_, children(), members()};
+    default:
+      // Values iterate over themselves.
+      return const_iterator{base_, entry_, member_};
+  }
+}
+
+SnapshotNode::const_iterator SnapshotNode::end() const noexcept {
+  switch (kind()) {
+    case detail::node_kind::null:
+      return const_iterator{base_, entry_, nullptr};
+    case detail::node_kind::array:
+    case detail::node_kind::object:
+      return const_iterator{base_, children() + entry_->size, nullptr};
+    default:
+      return const_iterator{base_, entry_ + 1, nullptr};
+  }
+}
+
+// Appends the entries of a tree to a buffer. Containers reserve the entries of their children
+// before writing them, so every entry is written into place exactly once.
+struct Snapshot::Writer {
+  std::string out;
+  // Every distinct string is stored once, at this offset.
+  std::unordered_map<std::string_view, std::uint32_t> strings;
+  // Reused to order the keys of objects that aren't sorted.
+  std::vector<std::uint32_t> order;
+
+  // Appends size zeroed bytes, aligned for entries, and returns their offset.
+  std::uint32_t reserve(const std::size_t size) {
+    out.resize((out.size() + alignof(detail::snapshot_entry) - 1) &
+               ~(alignof(detail::snapshot_entry) - 1));
+    const auto offset = out.size();
+    checked_offset(offset + size);
+    out.resize(offset + size);
+    return static_cast<std::uint32_t>(offset);
+  }
+
+  std::uint32_t store(std::string_view text) {
+    const auto [it, inserted] = strings.try_emplace(text, 0);
+    if (inserted) {
+      it->second = checked_offset(out.size());
+      out.append(text);
+    }
+    return it->second;
+  }
+
+  template <class T>
+  void put(const std::size_t offset, const T& value) noexcept {
+    std::memcpy(out.data() + offset, &value, sizeof(T));
+  }
+
+  void write(const Node& node, const std::uint32_t at) {
+    detail::snapshot_entry entry{};
+    entry.kind = node.kind_;
+    switch (node.kind_) {
+      case detail::node_kind::boolean:
+        entry.payload = node.payload<bool>() ? 1 : 0;
+        break;
+      case detail::node_kind::integer:
+        entry.payload = std::bit_cast<std::uint64_t>(node.payload<std::int64_t>());
+        break;
+      case detail::node_kind::unsigned_integer:
+        entry.payload = node.payload<std::uint64_t>();
+        break;
+      case detail::node_kind::floating:
+        entry.payload = std::bit_cast<std::uint64_t>(node.payload<double>());
+        break;
+      case detail::node_kind::string: {
+        const auto value = node.string();
+        entry.payload = store(value);
+        entry.size = checked_offset(value.size());
+        break;
+      }
+      case detail::node_kind::array: {
+        const auto& array = node.get<Node::array_t>();
+        entry.size = checked_offset(array.size());
+        const auto first = reserve(array.size() * sizeof(detail::snapshot_entry));
+        entry.payload = first;
+        for (std::size_t i = 0; i < array.size(); ++i) {
+          write(array[i], first + static_cast<std::uint32_t>(i * sizeof(detail::snapshot_entry)));
+        }
+        break;
+      }
+      case detail::node_kind::object:
+        write_object(node.get<Node::object_t>(), entry);
+        break;
+      default:
+        break;
+    }
+    put(at, entry);
+  }
+
+  void write_object(const Node::object_t& object, detail::snapshot_entry& entry) {
+    const auto size = checked_offset(object.size());
+    const auto sorted = std::ranges::is_sorted(
+        object, std::less<>{}, [](const auto& member) { return member.first.view(); });
+
+    const auto first = reserve(size * sizeof(detail::snapshot_entry) +
+                               size * sizeof(detail::snapshot_member) +
+                               (sorted ? 0 : size * sizeof(std::uint32_t)));
+    const auto members = first + size * sizeof(detail::snapshot_entry);
+    entry.payload = first;
+    entry.size = size;
+    entry.sorted = sorted ? 1 : 0;
+
+    std::uint32_t i = 0;
+    for (const auto& [key, value] : object) {
+      put(members + i * sizeof(detail::snapshot_member),
+          detail::snapshot_member{store(key.view()), static_cast<std::uint32_t>(key.size())});
+      ++i;
+    }
+
+    if (!sorted) {
+      const auto key_of = [&](const std::uint32_t j) { return (object.begin() + j)->first.view(); };
+      order.resize(size);
+      std::iota(order.begin(), order.end(), std::uint32_t{0});
+      std::ranges::sort(order, std::less<>{}, key_of);
+      std::memcpy(out.data() + members + size * sizeof(detail::snapshot_member), order.data(),
+                  size * sizeof(std::uint32_t));
+    }
+
+    i = 0;
+    for (const auto& [key, value] : object) {
+      write(value, first + i * static_cast<std::uint32_t>(sizeof(detail::snapshot_entry)));
+      ++i;
+    }
+  }
+};
+
+// Entries are read in place, so the bytes are copied into a buffer aligned for them.
+Snapshot Snapshot::copy(std::string_view bytes) {
+  const auto words = (bytes.size() + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+  std::shared_ptr<std::uint64_t[]> buffer{new std::uint64_t[words]};
+  std::memcpy(buffer.get(), bytes.data(), bytes.size());
+  const auto* data = reinterpret_cast<const std::byte*>(buffer.get());
+  return Snapshot{data, bytes.size(), std::move(buffer)};
+}
+
+Snapshot::Snapshot(std::string_view bytes) : Snapshot{copy(bytes)} { validate(); }
+
+Snapshot::Snapshot(const std::byte* data, const std::size_t size,
+                   std::shared_ptr<const void> storage)
+    : data_{data}, size_{size}, storage_{std::move(storage)} {}
+
+std::string Snapshot::problem() const {
+  if (size_ < sizeof(detail::snapshot_header)) return "too short";
+  const auto& header = this->header();
+  if (header.magic != magic) return "not a snapshot";
+  if (header.version != version) {
+    return "version " + std::to_string(header.version) + ", expected " + std::to_string(version);
+  }
+  if (header.size != size_) return "truncated";
+  if (header.root % alignof(detail::snapshot_entry) != 0 ||
+      header.root < sizeof(detail::snapshot_header) ||
+      header.root + sizeof(detail::snapshot_entry) > size_) {
+    return "root out of bounds";
+  }
+
+  const auto* body = reinterpret_cast<const char*>(data_) + sizeof(detail::snapshot_header);
+  if (detail::content_hash({body, size_ - sizeof(detail::snapshot_header)}) != header.checksum) {
+    return "checksum mismatch";
+  }
+  // The checksum only catches accidents, the offsets are what reading trusts.
+  return check_entries(data_, size_, header.root);
+}
+
+void Snapshot::validate() const {
+  check_byte_order();
+  if (auto reason = problem(); !reason.empty()) {
+    SOURCERER_THROW(std::invalid_argument("Invalid snapshot: " + reason));
+  }
+}
+
+Snapshot Snapshot::open(const std::filesystem::path& path) {
+  auto snapshot = map(path);
+  snapshot.validate();
+  return snapshot;
+}
+
+Snapshot Snapshot::map(const std::filesystem::path& path) {
+#ifdef SOURCERER_HAS_MMAP
+  const auto fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    SOURCERER_THROW(std::runtime_error("Can't read snapshot: " + path.string()));
+  }
+
+  struct stat status {};
+  if (fstat(fd, &status) != 0) {
+    ::close(fd);
+    SOURCERER_THROW(std::runtime_error("Can't read snapshot: " + path.string()));
+  }
+  const auto size = static_cast<std::size_t>(status.st_size);
+  if (size == 0) {
+    // Empty files can't be mapped, and are too short anyway.
+    ::close(fd);
+    return Snapshot{nullptr, 0, nullptr};
+  }
+
+  // The mapping stays valid after closing the file.
+  auto* data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) {
+    SOURCERER_THROW(std::runtime_error("Can't map snapshot: " + path.string()));
+  }
+
+  std::shared_ptr<const void> mapping{
+      data, [size](const void* mapped) { munmap(const_cast<void*>(mapped), size); }};
+  return Snapshot{static_cast<const std::byte*>(data), size, std::move(mapping)};
+#else
+  return copy(read_file(path));
+#endif
+}
+
+std::string Snapshot::encode(const Node& node, const std::uint64_t source_hash) {
+  check_byte_order();
+  Writer writer;
+  writer.out.resize(sizeof(detail::snapshot_header));
+  const auto root = writer.reserve(sizeof(detail::snapshot_entry));
+  writer.write(node, root);
+
+  auto& out = writer.out;
+  // The whole snapshot is padded to entries, so its size is too.
+  writer.reserve(0);
+  detail::snapshot_header header{magic, version, root, out.size(), source_hash, 0};
+  header.checksum = detail::content_hash(std::string_view{out}.substr(sizeof(header)));
+  writer.put(0, header);
+  return std::move(out);
+}
+
+void Snapshot::write(const Node& node, const std::filesystem::path& path,
+                     const std::uint64_t source_hash) {
+  const auto bytes = encode(node, source_hash);
+
+  // Written under a unique name first, so readers only ever see complete snapshots.
+  auto temporary = path;
+  temporary += "." + std::to_string(std::random_device{}()) + ".tmp";
+  {
+    std::ofstream file{temporary, std::ios::binary | std::ios::trunc};
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+    if (!file.flush()) {
+      std::filesystem::remove(temporary);
+      SOURCERER_THROW(std::runtime_error("Can't write snapshot: " + path.string()));
+    }
+  }
+  std::filesystem::rename(temporary, path);
+}
+
+SnapshotNode Snapshot::root() const noexcept {
+  return SnapshotNode{data_,
+                      reinterpret_cast<const detail::snapshot_entry*>(data_ + header().root)};
+}
+
+Node SnapshotCache::parse_json(std::string text) {
+  StringConjurer conjurer{std::move(text)};
+  return JsonSourcerer{conjurer, nullptr, JsonSourcerer::parse_mode::simd}.source();
+}
+
+SnapshotCache::SnapshotCache(std::filesystem::path directory, parser parse)
+    : directory_{std::move(directory)}, parse_{std::move(parse)} {
+  std::filesystem::create_directories(directory_);
+}
+
+Snapshot SnapshotCache::load(Conjurer& conjurer) {
+  auto text = conjurer.conjure();
+  const auto hash = detail::content_hash(text);
+  {
+    std::scoped_lock lock{mutex_};
+    if (const auto it = snapshots_.find(hash); it != snapshots_.end()) {
+      return it->second;
+    }
+  }
+
+  const auto path = path_of(hash);
+  auto snapshot = [&]() -> std::optional<Snapshot> {
+    if (!std::filesystem::exists(path)) return std::nullopt;
+    // Corrupt ones and those of another version are replaced below.
+    auto existing = Snapshot::map(path);
+    if (existing.problem().empty() && existing.source_hash() == hash) return existing;
+    return std::nullopt;
+  }();
+
+  if (!snapshot) {
+    Snapshot::write(parse_(std::move(text)), path, hash);
+    snapshot = Snapshot::open(path);
+  }
+
+  std::scoped_lock lock{mutex_};
+  return snapshots_.try_emplace(hash, std::move(*snapshot)).first->second;
+}
+
+std::size_t SnapshotCache::size() const {
+  std::scoped_lock lock{mutex_};
+  return snapshots_.size();
+}
+
+void SnapshotCache::clear() {
+  std::scoped_lock lock{mutex_};
+  snapshots_.clear();
+}
+
+std::filesystem::path SnapshotCache::path_of(const std::uint64_t hash) const {
+  std::array<char, 17> name{};
+  std::snprintf(name.data(), name.size(), "%016llx", static_cast<unsigned long long>(hash));
+  return directory_ / (std::string{name.data()} + ".snapshot");
+}
+
+}  // namespace sourcerer
@@ -0,0 +1,106 @@
+#include "sourcerer/thread_pool.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace sourcerer {
+
+namespace {
+
+// The pool the current thread belongs to and its queue, so tasks submitted by tasks stay local.
+thread_local const ThreadPool* current_pool = nullptr;
+thread_local std::size_t current_queue = 0;
+
+}  // namespace
+
+ThreadPool::ThreadPool(const std::size_t threads) {
+  if (threads == 0) {
+    SOURCERER_THROW(std::invalid_argument("A ThreadPool needs at least one thread"));
+  }
+  queues_.reserve(threads);
+  for (std::size_t i = 0; i < threads; ++i) {
+    queues_.push_back(std::make_unique<Queue>());
+  }
+  threads_.reserve(threads);
+  for (std::size_t i = 0; i < threads; ++i) {
+    threads_.emplace_back([this, i] { run(i); });
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::scoped_lock lock{mutex_};
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+void ThreadPool::execute(std::function<void()> task) {
+  const auto index = current_pool == this
+                         ? current_queue
+                         : next_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+  // Counted before it is queued, so a thread that takes it right away can't drop pending_ below
+  // the tasks that are queued, or wrap it around.
+  {
+    std::scoped_lock lock{mutex_};
+    pending_.fetch_add(1, std::memory_order_release);
+  }
+  {
+    auto& queue = *queues_[index];
+    std::scoped_lock lock{queue.mutex};
+    queue.tasks.push_back(std::move(task));
+  }
+  wake_.notify_one();
+}
+
+std::size_t ThreadPool::default_size() noexcept {
+  return std::max(1U, std::thread::hardware_concurrency());
+}
+
+void ThreadPool::run(const std::size_t index) {
+  current_pool = this;
+  current_queue = index;
+
+  std::function<void()> task;
+  while (true) {
+    if (take(index, task)) {
+      pending_.fetch_sub(1, std::memory_order_relaxed);
+      task();
+      task = nullptr;
+      continue;
+    }
+
+    std::unique_lock lock{mutex_};
+    wake_.wait(lock, [this] { return stopping_ || pending_.load(std::memory_order_acquire) > 0; });
+    if (stopping_ && pending_.load(std::memory_order_acquire) == 0) return;
+  }
+}
+
+bool ThreadPool::take(const std::size_t index, std::function<void()>& task) {
+  {
+    auto& own = *queues_[index];
+    std::scoped_lock lock{own.mutex};
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      return true;
+    }
+  }
+
+  for (std::size_t i = 1; i < queues_.size(); ++i) {
+    auto& victim = *queues_[(index + i) % queues_.size()];
+    std::scoped_lock lock{victim.mutex};
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      return true;
+    }
+  }
+  return false;
+}
+
+}  // namespace sourcerer
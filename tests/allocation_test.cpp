@@ -0,0 +1,201 @@
+#include <sourcerer/node.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+#include <doctest.h>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Counts the allocations of the thread while an Allocations is alive. Replacing the global
+// operator new counts everything: containers, strings, keys and error messages.
+namespace {
+
+thread_local std::size_t* counter = nullptr;
+
+void* allocate(std::size_t size, const std::size_t alignment) {
+  if (counter != nullptr) ++*counter;
+  if (size == 0) size = 1;
+  // aligned_alloc() needs a multiple of the alignment.
+  void* memory = alignment <= alignof(std::max_align_t)
+                     ? std::malloc(size)
+                     : std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+  if (memory == nullptr) SOURCERER_THROW(std::bad_alloc{});
+  return memory;
+}
+
+// GCC can't tell that the replaced operator new allocates with malloc.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void release(void* memory) noexcept { std::free(memory); }
+
+class Allocations {
+ public:
+  Allocations() { counter = &count_; }
+  ~Allocations() { counter = nullptr; }
+
+  Allocations(const Allocations&) = delete;
+  Allocations& operator=(const Allocations&) = delete;
+
+  std::size_t count() const noexcept { return count_; }
+
+ private:
+  std::size_t count_ = 0;
+};
+
+}  // namespace
+
+void* operator new(const std::size_t size) { return allocate(size, alignof(std::max_align_t)); }
+void* operator new[](const std::size_t size) { return allocate(size, alignof(std::max_align_t)); }
+void* operator new(const std::size_t size, const std::align_val_t alignment) {
+  return allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](const std::size_t size, const std::align_val_t alignment) {
+  return allocate(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* memory) noexcept { release(memory); }
+void operator delete[](void* memory) noexcept { release(memory); }
+void operator delete(void* memory, std::size_t /*size*/) noexcept { release(memory); }
+void operator delete[](void* memory, std::size_t /*size*/) noexcept { release(memory); }
+void operator delete(void* memory, std::align_val_t /*alignment*/) noexcept { release(memory); }
+void operator delete[](void* memory, std::align_val_t /*alignment*/) noexcept {
+  release(memory);
+}
+void operator delete(void* memory, std::size_t /*size*/, std::align_val_t /*alignment*/) noexcept {
+  release(memory);
+}
+void operator delete[](void* memory, std::size_t /*size*/,
+                       std::align_val_t /*alignment*/) noexcept {
+  release(memory);
+}
+
+TEST_SUITE_BEGIN("[Allocations]");
+using namespace sourcerer;
+
+// Mutations that succeed allocate nothing but the data they insert: nothing at all once the
+// containers have room and the keys exist.
+TEST_CASE("Mutators") {
+  SUBCASE("arrays with room") {
+    Node array{Node::array_t{}};
+    array.reserve(16);
+    const Node element{42};
+
+    Allocations allocations;
+    array.push_back(1);
+    array.push_back(element);
+    array.push_back(Node{2.5});
+    array.emplace_back("short string");
+    array.emplace_back(true);
+    array.insert(0, 0);
+    array.insert(1, element);
+    array.emplace(2, -1);
+    array[0] = 7;
+    array.at(1) = "other";
+    array.erase(0);
+    CHECK(allocations.count() == 0);
+    CHECK(array.size() == 7);
+  }
+
+  SUBCASE("objects with existing keys") {
+    Node object;
+    object.insert("host", "localhost");
+    object.insert("port", 80);
+    object.insert("tls", false);
+
+    Allocations allocations;
+    object["port"] = 8080;
+    object["host"] = "example.org";
+    object.insert("tls", true);
+    object.emplace("tls", true);
+    object.at("tls") = true;
+    object[object.keys()->intern("port")] = 443;
+    object.erase("missing");
+    CHECK(allocations.count() == 0);
+    CHECK(object.at("port").as<int>() == 443);
+    CHECK(object.at("host").as<std::string>() == "example.org");
+    CHECK(object.at("tls").as<bool>());
+  }
+
+  SUBCASE("objects with room and interned keys") {
+    Node object{Node::object_t{}};
+    object.reserve(4);
+    object.insert("host", "localhost");
+    const auto keys = object.keys();
+    const auto port = keys->intern("port");
+    const auto tls = keys->intern("tls");
+
+    Allocations allocations;
+    object[port] = 80;
+    object.emplace("tls", true);
+    object.erase("port");
+    CHECK(allocations.count() == 0);
+    CHECK(object.size() == 2);
+    CHECK(object.contains(tls));
+  }
+
+  SUBCASE("indexed objects with room") {
+    constexpr std::size_t count = 64;
+    Node object{Node::object_t{}};
+    object.reserve(count);
+    object.insert("first", 0);
+    std::vector<Key> keys;
+    for (std::size_t i = 1; i < count; ++i) {
+      keys.push_back(object.keys()->intern("key" + std::to_string(i)));
+    }
+
+    Allocations allocations;
+    for (const auto& key : keys) {
+      object[key] = 1;
+    }
+    CHECK(allocations.count() == 0);
+    CHECK(object.size() == count);
+  }
+
+  SUBCASE("assigning scalars") {
+    Node node{"a string too long to be stored inline"};
+    Node other;
+
+    Allocations allocations;
+    node = 42;
+    node = 0.5;
+    node = "inline";
+    node = true;
+    other = node;
+    other = std::move(node);
+    CHECK(allocations.count() == 0);
+    CHECK(other.as<bool>());
+  }
+
+  SUBCASE("only inserted data is allocated") {
+    Node array{Node::array_t{}};
+    array.reserve(4);
+    const Node text{"a string too long to be stored inline"};
+
+    Allocations allocations;
+    array.push_back(text);
+    CHECK(allocations.count() == 1);
+    array.emplace_back("another string too long to be stored inline");
+    CHECK(allocations.count() == 2);
+    array[0] = "a third string too long to be stored inline";
+    CHECK(allocations.count() == 3);
+  }
+
+  SUBCASE("copies share their containers") {
+    Node hosts;
+    hosts.push_back("a");
+    Node root;
+    root.insert("hosts", hosts);
+    root.insert("port", 5432);
+
+    Allocations allocations;
+    const Node copy = root;
+    Node moved = std::move(root);
+    moved = copy;
+    CHECK(allocations.count() == 0);
+    CHECK(moved == copy);
+  }
+}
+
+TEST_SUITE_END();
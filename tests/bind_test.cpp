@@ -0,0 +1,150 @@
+#include <sourcerer/bind.hpp>
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/node_builder.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <doctest.h>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace sourcerer;
+
+namespace {
+
+struct Pool {
+  int size = 0;
+  int idle = 1;
+};
+
+struct Database {
+  std::string host;
+  int port = 0;
+  std::optional<Pool> pool;
+};
+
+struct Service {
+  std::string name;
+  Database db;
+  std::vector<std::string> hosts;
+  std::map<std::string, double> weights;
+  std::optional<bool> tls;
+  int retries = 3;
+  Node extra;
+};
+
+Node parse(const char* text) {
+  StringConjurer conjurer{text};
+  return JsonSourcerer{conjurer}.source();
+}
+
+std::vector<std::string> paths(const std::vector<BindError>& errors) {
+  std::vector<std::string> result;
+  for (const auto& error : errors) {
+    result.push_back(error.path);
+  }
+  return result;
+}
+
+}  // namespace
+
+template <>
+struct sourcerer::binding<Pool> {
+  static constexpr field_list fields{field("size", &Pool::size),
+                                     field("idle", &Pool::idle, if_present)};
+};
+
+template <>
+struct sourcerer::binding<Database> {
+  static constexpr field_list fields{field("host", &Database::host), field("port", &Database::port),
+                                     field("pool", &Database::pool)};
+};
+
+template <>
+struct sourcerer::binding<Service> {
+  static constexpr field_list fields{
+      field("name", &Service::name),       field("db", &Service::db),
+      field("hosts", &Service::hosts),     field("weights", &Service::weights),
+      field("tls", &Service::tls),         field("retries", &Service::retries, if_present),
+      field("extra", &Service::extra, if_present)};
+};
+
+TEST_SUITE_BEGIN("[bind]");
+
+TEST_CASE("Bind") {
+  const auto node = parse(R"({
+    "name": "service",
+    "db": {"host": "localhost", "port": 5432, "pool": {"size": 10}},
+    "hosts": ["a", "b"],
+    "weights": {"a": 0.5, "b": 2},
+    "extra": {"anything": [1, 2]},
+    "unknown": true
+  })");
+
+  const auto service = bind<Service>(node);
+  CHECK(service.name == "service");
+  CHECK(service.db.host == "localhost");
+  CHECK(service.db.port == 5432);
+  REQUIRE(service.db.pool.has_value());
+  CHECK(service.db.pool->size == 10);
+  CHECK(service.db.pool->idle == 1);
+  CHECK(service.hosts == std::vector<std::string>{"a", "b"});
+  CHECK(service.weights == std::map<std::string, double>{{"a", 0.5}, {"b", 2.0}});
+  CHECK(!service.tls.has_value());
+  CHECK(service.retries == 3);
+  CHECK(service.extra == node.at("extra"));
+
+  // Top level containers are bound as well.
+  CHECK(bind<std::vector<int>>(parse("[1, 2, 3]")) == std::vector<int>{1, 2, 3});
+  CHECK(bind<std::optional<int>>(parse("null")) == std::nullopt);
+}
+
+TEST_CASE("Collect all errors") {
+  const auto node = parse(R"({
+    "db": {"host": "localhost", "port": "http", "pool": {"idle": null}},
+    "hosts": ["a", {"b": 1}],
+    "weights": {"a": "heavy"},
+    "tls": 1,
+    "retries": null
+  })");
+
+  Service service;
+  const auto errors = bind(node, service);
+  CHECK(paths(errors) ==
+        std::vector<std::string>{"db.pool.size", "db.port", "hosts[1]", "name", "weights.a"});
+  // What could be bound is.
+  CHECK(service.db.host == "localhost");
+  CHECK(service.hosts.front() == "a");
+  CHECK(service.tls == true);
+  CHECK(service.retries == 3);
+
+  REQUIRE_THROWS_AS(bind<Service>(node), BindErrors);
+#if SOURCERER_EXCEPTIONS
+  try {
+    bind<Service>(node);
+  } catch (const BindErrors& e) {
+    CHECK(e.errors().size() == 5);
+    CHECK(std::string{e.what()}.find("db.pool.size: Missing") != std::string::npos);
+  }
+#endif
+
+  CHECK(paths(bind(parse("[]"), service)) == std::vector<std::string>{""});
+}
+
+TEST_CASE("Objects in insertion order") {
+  NodeBuilder builder{{}, std::make_shared<KeyPool>(), Node::key_order::insertion};
+  builder.begin_object();
+  builder.key("size");
+  builder.value(4);
+  builder.key("idle");
+  builder.value(2);
+  builder.end_object();
+
+  const auto pool = bind<Pool>(builder.finish());
+  CHECK(pool.size == 4);
+  CHECK(pool.idle == 2);
+}
+
+TEST_SUITE_END();
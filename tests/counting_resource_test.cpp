@@ -0,0 +1,79 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/counting_resource.hpp>
+#include <sourcerer/key_pool.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <doctest.h>
+#include <memory_resource>
+#include <vector>
+
+TEST_SUITE_BEGIN("[CountingResource]");
+using namespace sourcerer;
+
+TEST_CASE("Counting") {
+  CountingResource counting;
+
+  SUBCASE("allocations") {
+    auto* first = counting.allocate(100);
+    auto* second = counting.allocate(50);
+    counting.deallocate(first, 100);
+    auto* third = counting.allocate(20);
+
+    auto stats = counting.stats();
+    CHECK(stats.allocations == 3);
+    CHECK(stats.deallocations == 1);
+    CHECK(stats.bytes == 70);
+    CHECK(stats.peak_bytes == 150);
+    CHECK(stats.total_bytes == 170);
+
+    counting.reset();
+    stats = counting.stats();
+    CHECK(stats.allocations == 0);
+    CHECK(stats.peak_bytes == 70);
+    CHECK(stats.total_bytes == 0);
+
+    counting.deallocate(second, 50);
+    counting.deallocate(third, 20);
+    CHECK(counting.stats().bytes == 0);
+    CHECK(counting.stats().deallocations == 2);
+  }
+
+  SUBCASE("containers") {
+    {
+      std::pmr::vector<int> numbers{&counting};
+      for (int i = 0; i < 100; ++i) numbers.push_back(i);
+      CHECK(counting.stats().bytes == numbers.capacity() * sizeof(int));
+    }
+    const auto stats = counting.stats();
+    CHECK(stats.allocations > 1);
+    CHECK(stats.deallocations == stats.allocations);
+    CHECK(stats.bytes == 0);
+  }
+}
+
+TEST_CASE("Counting a load") {
+  CountingResource counting;
+  StringConjurer conjurer{R"({
+    "name": "a string too long to be stored inline",
+    "ports": [80, 443],
+    "tls": {"on": true}
+  })"};
+
+  {
+    JsonSourcerer sourcerer{conjurer, &counting};
+    const auto& root = sourcerer.source();
+    const auto stats = counting.stats();
+    CHECK(stats.allocations > 0);
+    CHECK(stats.peak_bytes >= stats.bytes);
+
+    // What's left is the tree, apart from the root the sourcerer holds and the pool of the keys.
+    const auto usage = root.memory_usage();
+    CHECK(stats.bytes == usage.total() - sizeof(Node) - sizeof(KeyPool) - root.keys()->bytes());
+  }
+
+  const auto stats = counting.stats();
+  CHECK(stats.deallocations == stats.allocations);
+  CHECK(stats.bytes == 0);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,85 @@
+#include <sourcerer/detail/json_index.hpp>
+
+#include <cstdint>
+#include <doctest.h>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+
+TEST_SUITE_BEGIN("[json_index]");
+using sourcerer::detail::json_index;
+using sourcerer::detail::node_kind;
+using sourcerer::detail::simd_level;
+
+TEST_CASE("Tape") {
+  const std::string_view text = R"( {"a": [1, -2, 3.5], "b": {}, "c": "text", "d": null} )";
+  const json_index index{text};
+
+  // {, "a", [, 1, -2, 3.5, "b", {, "c", "text", "d", null
+  REQUIRE(index.size() == 12);
+  CHECK(index.kind(0) == node_kind::object);
+  CHECK(index.skip(0) == 12);
+  CHECK(index.raw_string(1) == "a");
+  CHECK(index.kind(2) == node_kind::array);
+  CHECK(index.skip(2) == 6);
+  CHECK(index.kind(3) == node_kind::unsigned_integer);
+  CHECK(index.kind(4) == node_kind::integer);
+  CHECK(index.kind(5) == node_kind::floating);
+  CHECK(index.skip(7) == 8);
+  CHECK(index.kind(9) == node_kind::string);
+  CHECK(index.string(9) == "text");
+  CHECK(index.kind(11) == node_kind::null);
+}
+
+TEST_CASE("Numbers") {
+  const auto number = [](const std::string& text) { return json_index{text}.number(0); };
+
+  CHECK(std::get<std::uint64_t>(number("0")) == 0);
+  CHECK(std::get<std::uint64_t>(number("18446744073709551615")) == 18446744073709551615ULL);
+  CHECK(std::get<std::int64_t>(number("-9223372036854775808")) == INT64_MIN);
+  CHECK(std::get<double>(number("18446744073709551616")) == 18446744073709551616.0);
+  CHECK(std::get<double>(number("-1.5e3")) == -1500.0);
+  CHECK(std::get<double>(number("1E-2")) == 0.01);
+}
+
+TEST_CASE("Strings") {
+  const json_index index{R"(["plain", "tab\t quote\" slash\/ é 😀"])"};
+  CHECK_FALSE(index.is_escaped(1));
+  CHECK(index.is_escaped(2));
+  CHECK(index.string(2) == "tab\t quote\" slash/ \xc3\xa9 \xf0\x9f\x98\x80");
+
+  // Lone surrogates are rejected while indexing, not once the string is read.
+  CHECK_THROWS_AS(json_index{R"(["\ud83d"])"}, std::invalid_argument);
+  CHECK_THROWS_AS(json_index{R"(["\ude00 "])"}, std::invalid_argument);
+}
+
+TEST_CASE("Every SIMD level builds the same tape") {
+  std::string text = R"({"list": [)";
+  for (int i = 0; i < 200; ++i) {
+    text += R"({"key \"\\ )" + std::to_string(i) + R"(": [true, false, null, -1.5e3, "é"]},)";
+  }
+  text += "{}]}";
+
+  const json_index expected{text, simd_level::portable};
+  for (const auto level : {simd_level::sse42, simd_level::avx2}) {
+    const json_index index{text, level};
+    REQUIRE(index.size() == expected.size());
+    for (std::uint32_t i = 0; i < index.size(); ++i) {
+      CHECK(index[i].offset == expected[i].offset);
+      CHECK(index[i].extent == expected[i].extent);
+    }
+  }
+}
+
+TEST_CASE("Invalid JSON") {
+  for ([[maybe_unused]] const auto* text :
+       {"", " ", "{", "[1,]", "[1 2]", R"({"a" 1})", R"({"a": 1,})", "{1: 2}", "01", "1.", "-",
+        "1e", "tru", "nul", "[1]]", R"("unterminated)", R"("bad \x escape")", R"("\u12")",
+        "\"tab\there\"", "1x", "[truex]", "\"\xff\"", "[\"a\"b]", "\x01", "[1\f]",
+        R"("\ud800\u0041")", R"("\ud800\u12")"}) {
+    CHECK_THROWS_AS(json_index{text}, std::invalid_argument);
+  }
+}
+
+TEST_SUITE_END();
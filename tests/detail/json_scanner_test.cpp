@@ -0,0 +1,143 @@
+#include <sourcerer/detail/json_scanner.hpp>
+
+#include <cstdint>
+#include <doctest.h>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_SUITE_BEGIN("[json_scanner]");
+using sourcerer::detail::json_scanner;
+using sourcerer::detail::simd_level;
+
+namespace {
+
+constexpr simd_level levels[] = {simd_level::portable, simd_level::sse42, simd_level::avx2};
+
+std::vector<std::uint32_t> scan(std::string_view text, const simd_level level) {
+  json_scanner scanner{text, level};
+  std::vector<std::uint32_t> positions;
+  while (scanner.next(positions)) {
+  }
+  return positions;
+}
+
+// Finds the structural characters one character at a time.
+std::vector<std::uint32_t> reference(std::string_view text) {
+  std::vector<std::uint32_t> positions;
+  bool in_string = false;
+  bool in_scalar = false;
+  for (std::uint32_t i = 0; i < text.size(); ++i) {
+    const auto c = text[i];
+    if (in_string) {
+      if (c == '\\') {
+        ++i;
+      } else if (c == '"') {
+        positions.push_back(i);
+        in_string = false;
+      }
+      continue;
+    }
+
+    const auto structural = std::string_view{"{}[]:,"}.find(c) != std::string_view::npos;
+    const auto whitespace = std::string_view{" \t\n\r"}.find(c) != std::string_view::npos;
+    if (c == '"') {
+      in_string = true;
+    }
+    if (structural || c == '"' || (!whitespace && !in_scalar)) {
+      positions.push_back(i);
+    }
+    in_scalar = !structural && !whitespace && c != '"';
+  }
+  return positions;
+}
+
+}  // namespace
+
+TEST_CASE("Structural characters") {
+  // Odd and even runs of backslashes ending at and crossing the 64 byte boundaries.
+  const auto backslashes = "[\"" + std::string(95, '\\') + "\", \"" + std::string(100, '\\') +
+                           "\", \"x\"]";
+  const std::string texts[] = {
+      "",
+      R"({"a": [1, 2.5, true], "b": null})",
+      R"(["comma, colon: and {brackets}", "quote \" and backslashes \\", "\\\"", "\\\\"])",
+      "  {\"x\":-1e5,\"y\":[[],{}]}\n\t",
+      backslashes,
+      "[1 2 abc]",
+  };
+
+  for (const auto& text : texts) {
+    for (const auto level : levels) {
+      CHECK(scan(text, level) == reference(text));
+    }
+  }
+}
+
+TEST_CASE("Random documents") {
+  // Mostly structure, with strings, escapes and multi-byte characters sprinkled in, and every
+  // offset from a block boundary.
+  const std::string_view pieces[] = {"{", "}", "[", "]", ":", ",", " ", "\n", "1", "-2.5", "true",
+                                     "\"s\"", "\"\\\"\"", "\"\\\\\"", "\"a,b\"", "\"\xc3\xa9\"",
+                                     "\"\xf0\x9f\x98\x80\"", "\"\\\\\\\"\""};
+  std::mt19937 random{42};
+  for (int round = 0; round < 200; ++round) {
+    std::string text(random() % 64, ' ');
+    const auto count = random() % 200;
+    for (std::uint32_t i = 0; i < count; ++i) {
+      text += pieces[random() % std::size(pieces)];
+    }
+
+    const auto expected = reference(text);
+    for (const auto level : levels) {
+      CHECK(scan(text, level) == expected);
+    }
+  }
+}
+
+TEST_CASE("UTF-8") {
+  const std::string padding(61, ' ');
+  const std::string valid[] = {
+      "\"\xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80\xf4\x8f\xbf\xbf\"",
+      // A sequence that crosses the boundary of two blocks.
+      padding + "\"\xf0\x9f\x98\x80\"",
+  };
+  const std::string invalid[] = {
+      "\"\xc0\x80\"",          // Overlong.
+      "\"\xe0\x80\x80\"",      // Overlong.
+      "\"\xed\xa0\x80\"",      // Surrogate.
+      "\"\xf4\x90\x80\x80\"",  // Above U+10FFFF.
+      "\"\xf5\x80\x80\x80\"",  // Invalid lead byte.
+      "\"\x80\"",              // Continuation without a lead byte.
+      "\"\xc3\"",              // Cut off.
+      "\"\xe2\x82",            // Cut off by the end of the text.
+      padding + "\"\xf0\x9f\"",
+  };
+
+  for (const auto level : levels) {
+    for (const auto& text : valid) {
+      CHECK_NOTHROW(scan(text, level));
+    }
+    for ([[maybe_unused]] const auto& text : invalid) {
+      CHECK_THROWS_AS(scan(text, level), std::invalid_argument);
+    }
+  }
+}
+
+TEST_CASE("Control characters in strings") {
+  for (const auto level : levels) {
+    CHECK_THROWS_AS(scan("[\"tab\there\"]", level), std::invalid_argument);
+    // Outside of strings they are only ordinary characters, which the parser rejects.
+    CHECK_NOTHROW(scan("[\x01]", level));
+  }
+}
+
+TEST_CASE("Levels") {
+  const auto detected = sourcerer::detail::detect_simd_level();
+  CHECK(json_scanner{"", simd_level::portable}.level() == simd_level::portable);
+  CHECK(json_scanner{"", simd_level::avx2}.level() <= detected);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,153 @@
+#include <sourcerer/detail/object_map.hpp>
+
+#include <algorithm>
+#include <doctest.h>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+TEST_SUITE_BEGIN("[object_map]");
+using sourcerer::detail::key_order;
+using object_map = sourcerer::detail::object_map<int>;
+
+namespace {
+
+std::vector<std::string> keys_of(const object_map& map) {
+  std::vector<std::string> keys;
+  for (const auto& [key, value] : map) {
+    keys.emplace_back(key);
+  }
+  return keys;
+}
+
+}  // namespace
+
+TEST_CASE_TEMPLATE("Lookup", Size, std::integral_constant<int, 3>,
+                   std::integral_constant<int, object_map::index_threshold>,
+                   std::integral_constant<int, 1000>) {
+  object_map map;
+  for (int i = 0; i < Size::value; ++i) {
+    CHECK(map.try_emplace("key" + std::to_string(i), i).second);
+  }
+
+  SUBCASE("find") {
+    for (int i = 0; i < Size::value; ++i) {
+      auto it = map.find("key" + std::to_string(i));
+      REQUIRE(it != map.end());
+      CHECK(it->second == i);
+    }
+    CHECK(map.find("missing") == map.end());
+  }
+
+  SUBCASE("try_emplace doesn't overwrite") {
+    auto [it, inserted] = map.try_emplace("key0", -1);
+    CHECK_FALSE(inserted);
+    CHECK(it->second == 0);
+    CHECK(map.size() == Size::value);
+  }
+
+  SUBCASE("erase") {
+    for (int i = 0; i < Size::value; i += 2) {
+      CHECK(map.erase("key" + std::to_string(i)) == 1);
+    }
+    for (int i = 0; i < Size::value; ++i) {
+      CHECK(map.contains("key" + std::to_string(i)) == (i % 2 == 1));
+    }
+  }
+
+  SUBCASE("copy") {
+    const object_map copy{map};
+    CHECK(copy == map);
+    CHECK(copy.find("key1")->second == 1);
+  }
+}
+
+TEST_CASE("Order") {
+  SUBCASE("sorted") {
+    object_map map;
+    map.try_emplace("b", 1);
+    map.try_emplace("c", 2);
+    map.try_emplace("a", 3);
+    CHECK(keys_of(map) == std::vector<std::string>{"a", "b", "c"});
+    CHECK(map.find("a")->second == 3);
+  }
+
+  SUBCASE("insertion") {
+    object_map map{key_order::insertion};
+    map.try_emplace("b", 1);
+    map.try_emplace("c", 2);
+    map.try_emplace("a", 3);
+    CHECK(keys_of(map) == std::vector<std::string>{"b", "c", "a"});
+    CHECK(map.find("a")->second == 3);
+  }
+
+  SUBCASE("sorted insertion into an indexed map") {
+    object_map map;
+    for (int i = 100; i > 0; --i) {
+      map.try_emplace("key" + std::to_string(i), i);
+    }
+    CHECK(std::ranges::is_sorted(keys_of(map)));
+    for (int i = 1; i <= 100; ++i) {
+      CHECK(map.find("key" + std::to_string(i))->second == i);
+    }
+  }
+
+  SUBCASE("equality ignores the order") {
+    object_map sorted;
+    object_map insertion{key_order::insertion};
+    for (const auto* key : {"b", "a"}) {
+      sorted.try_emplace(key, 1);
+      insertion.try_emplace(key, 1);
+    }
+    CHECK(sorted == insertion);
+
+    insertion.find("a")->second = 2;
+    CHECK_FALSE(sorted == insertion);
+  }
+}
+
+TEST_CASE("Keys") {
+  auto pool = std::make_shared<sourcerer::KeyPool>();
+
+  SUBCASE("a map creates its own pool") {
+    object_map map;
+    CHECK(map.keys() == nullptr);
+    map.try_emplace("key", 1);
+    REQUIRE(map.keys() != nullptr);
+    CHECK(map.keys()->size() == 1);
+  }
+
+  SUBCASE("maps share a pool") {
+    object_map first{pool};
+    object_map second{pool};
+    first.try_emplace("key", 1);
+    second.try_emplace("key", 2);
+    CHECK(pool->size() == 1);
+    CHECK(first.begin()->first.view().data() == second.begin()->first.view().data());
+  }
+
+  SUBCASE("lookup by an interned key") {
+    object_map map{pool};
+    for (int i = 0; i < 100; ++i) {
+      map.try_emplace("key" + std::to_string(i), i);
+    }
+    CHECK(map.find(pool->intern("key42"))->second == 42);
+    CHECK(map.find(pool->intern("missing")) == map.end());
+
+    sourcerer::KeyPool other;
+    CHECK(map.find(other.intern("key42"))->second == 42);
+    CHECK(map.try_emplace(other.intern("key101"), 101).second);
+    CHECK(pool->find("key101").has_value());
+  }
+
+  SUBCASE("copies share the pool") {
+    object_map map{pool};
+    map.try_emplace("key", 1);
+    const object_map copy{map};
+    CHECK(copy.keys() == pool);
+    CHECK(copy.find(pool->intern("key"))->second == 1);
+  }
+}
+
+TEST_SUITE_END();
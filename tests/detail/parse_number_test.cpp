@@ -0,0 +1,108 @@
+#include <sourcerer/detail/parse_number.hpp>
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <doctest.h>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_SUITE_BEGIN("[parse_number]");
+using namespace sourcerer::detail;
+
+namespace {
+
+double from_chars_double(const std::string_view text) {
+  double value = 0;
+  std::from_chars(text.data(), text.data() + text.size(), value);
+  return value;
+}
+
+}  // namespace
+
+TEST_CASE("Integers") {
+  std::uint64_t magnitude = 0;
+  bool negative = false;
+  for (const std::string_view text :
+       {"0", "7", "-7", "12345678", "123456789", "9999999999999999999", "0000000000000042"}) {
+    CAPTURE(text);
+    REQUIRE(parse_integer(text, magnitude, negative));
+    const auto digits = text.substr(negative ? 1 : 0);
+    std::uint64_t expected = 0;
+    std::from_chars(digits.data(), digits.data() + digits.size(), expected);
+    CHECK(magnitude == expected);
+    CHECK(negative == text.starts_with('-'));
+  }
+
+  // Anything but plain digits is left to std::from_chars.
+  for (const std::string_view text :
+       {"", "-", "+1", " 1", "1 ", "1.0", "12345678a", "a2345678", "99999999999999999999"}) {
+    CAPTURE(text);
+    CHECK_FALSE(parse_integer(text, magnitude, negative));
+  }
+}
+
+TEST_CASE("Doubles") {
+  double value = 0;
+  for (const std::string_view text : {"0", "-0", "0.1", "1.5", "-2.25", "3.14159265358979",
+                                      "123456789.123456", "0.0000000000000000000001",
+                                      "9007199254740992", "123456789012345.6"}) {
+    CAPTURE(text);
+    REQUIRE(parse_double(text, value));
+    CHECK(std::bit_cast<std::uint64_t>(value) ==
+          std::bit_cast<std::uint64_t>(from_chars_double(text)));
+  }
+
+  // Mantissas above 2^53 and more than 22 decimals aren't exact.
+  for (const std::string_view text :
+       {"", "-", ".5", "1.", "1e5", "1.5e3", "inf", "nan", "1,5", "9007199254740993",
+        "1234567890123456.0", "0.00000000000000000000001"}) {
+    CAPTURE(text);
+    CHECK_FALSE(parse_double(text, value));
+  }
+
+  // Random decimals the fast path takes give the same double as std::from_chars.
+  std::mt19937_64 random{42};
+  std::size_t fast = 0;
+  for (int i = 0; i < 100000; ++i) {
+    auto text = std::to_string(random() % 1000000000000000ULL);
+    text.insert(text.size() - random() % text.size(), ".");
+    if (text.front() == '.') text.insert(0, "0");
+    if (text.back() == '.') text.push_back('0');
+    if (random() % 2 == 0) text.insert(0, "-");
+
+    if (parse_double(text, value)) {
+      ++fast;
+      REQUIRE(std::bit_cast<std::uint64_t>(value) ==
+              std::bit_cast<std::uint64_t>(from_chars_double(text)));
+    }
+  }
+  CHECK(fast > 90000);
+}
+
+TEST_CASE("Batches") {
+  const std::array<std::string_view, 5> texts{"1", "-2.5", "1e3", "12345678901234567890123", "x"};
+
+  std::array<double, 5> doubles{};
+  CHECK(parse_numbers(texts, doubles) == 4);
+  CHECK(doubles[0] == 1.0);
+  CHECK(doubles[1] == -2.5);
+  CHECK(doubles[2] == 1000.0);
+  CHECK(doubles[3] == 12345678901234567890123.0);
+
+  std::array<std::int64_t, 5> integers{};
+  CHECK(parse_numbers(texts, integers) == 1);
+  CHECK(integers[0] == 1);
+
+  const std::array<std::string_view, 3> limits{"-9223372036854775808", "9223372036854775807",
+                                               "9223372036854775808"};
+  CHECK(parse_numbers(limits, integers) == 2);
+  CHECK(integers[0] == std::numeric_limits<std::int64_t>::min());
+  CHECK(integers[1] == std::numeric_limits<std::int64_t>::max());
+}
+
+TEST_SUITE_END();
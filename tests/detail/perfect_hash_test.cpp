@@ -0,0 +1,48 @@
+#include <sourcerer/detail/perfect_hash.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <doctest.h>
+#include <random>
+#include <vector>
+
+TEST_SUITE_BEGIN("[perfect_hash]");
+namespace perfect_hash = sourcerer::detail::perfect_hash;
+
+TEST_CASE("Build") {
+  for (const std::size_t size : {0, 1, 2, 7, 100, 5000}) {
+    std::mt19937 random{static_cast<std::uint32_t>(size)};
+    std::vector<std::uint32_t> hashes;
+    while (hashes.size() < size) {
+      const auto hash = random();
+      if (std::ranges::find(hashes, hash) == hashes.end()) {
+        hashes.push_back(hash);
+      }
+    }
+
+    std::vector<std::uint32_t> displacements(perfect_hash::buckets_for(size));
+    std::vector<std::uint32_t> slots(size);
+    REQUIRE(perfect_hash::build(hashes, displacements, slots));
+
+    // Every key gets its own slot.
+    auto sorted = slots;
+    std::ranges::sort(sorted);
+    for (std::size_t i = 0; i < size; ++i) {
+      CHECK(sorted[i] == i);
+    }
+
+    for (std::size_t i = 0; i < size; ++i) {
+      CHECK(perfect_hash::lookup(hashes[i], displacements, static_cast<std::uint32_t>(size)) ==
+            slots[i]);
+    }
+  }
+}
+
+TEST_CASE("Duplicate hashes") {
+  const std::vector<std::uint32_t> hashes{1, 2, 1};
+  std::vector<std::uint32_t> displacements(perfect_hash::buckets_for(hashes.size()));
+  std::vector<std::uint32_t> slots(hashes.size());
+  CHECK_FALSE(perfect_hash::build(hashes, displacements, slots));
+}
+
+TEST_SUITE_END();
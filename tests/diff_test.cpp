@@ -0,0 +1,96 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/diff.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <algorithm>
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+TEST_SUITE_BEGIN("[diff]");
+using namespace sourcerer;
+
+namespace {
+
+Node parse(const char* text) {
+  StringConjurer conjurer{text};
+  return JsonSourcerer{conjurer}.source();
+}
+
+std::vector<std::string> strings(const std::vector<Path>& paths) {
+  std::vector<std::string> result;
+  for (const auto& path : paths) {
+    result.push_back(path.str());
+  }
+  return result;
+}
+
+std::vector<std::string> sorted(std::vector<std::string> strings) {
+  std::ranges::sort(strings);
+  return strings;
+}
+
+}  // namespace
+
+TEST_CASE("Diff") {
+  const auto before = parse(R"({
+    "name": "service",
+    "db": {"host": "localhost", "port": 5432, "pool": {"size": 10}},
+    "hosts": ["a", "b", "c"],
+    "tls": {"enabled": false},
+    "weights": [1, 2],
+    "the.key": 1
+  })");
+  const auto after = parse(R"({
+    "name": "service",
+    "db": {"host": "db.internal", "port": 5432.0, "pool": {"size": 10, "idle": 2}},
+    "hosts": ["a", "x"],
+    "tls": true,
+    "weights": [1, 2, 3],
+    "region": "eu"
+  })");
+
+  const auto result = diff(before, after);
+  // Members of both objects come first, then the ones only the tree after has.
+  CHECK(strings(result.added) ==
+        std::vector<std::string>{"db.pool.idle", "weights[2]", "region"});
+  CHECK(strings(result.removed) == std::vector<std::string>{"hosts[2]", R"(["the.key"])"});
+  CHECK(strings(result.changed) == std::vector<std::string>{"db.host", "hosts[1]", "tls"});
+
+  // The paths select the values in the trees.
+  CHECK(result.added.front().at(after).as<int>() == 2);
+  CHECK(result.removed.back().at(before).as<int>() == 1);
+
+  const auto reversed = diff(after, before);
+  CHECK(sorted(strings(reversed.added)) == sorted(strings(result.removed)));
+  CHECK(sorted(strings(reversed.removed)) == sorted(strings(result.added)));
+  CHECK(strings(reversed.changed) == strings(result.changed));
+}
+
+TEST_CASE("Equal trees") {
+  const auto tree = parse(R"({"a": [1, {"b": null}], "c": "d"})");
+  CHECK(diff(tree, tree).empty());
+  CHECK(diff(tree, parse(R"({"c": "d", "a": [1.0, {"b": null}]})")).empty());
+
+  // A root that changes as a whole is the empty path.
+  const auto result = diff(tree, parse("[]"));
+  CHECK(strings(result.changed) == std::vector<std::string>{""});
+  CHECK(result.added.empty());
+  CHECK(result.removed.empty());
+}
+
+TEST_CASE("Large integers") {
+  // Both round to the same double, they still differ.
+  const auto before = parse(R"({"ts": 1760000000000000001})");
+  const auto after = parse(R"({"ts": 1760000000000000100})");
+  CHECK(before.hash() != after.hash());
+  CHECK(strings(diff(before, after).changed) == std::vector<std::string>{"ts"});
+  CHECK(strings(diff(parse("[18446744073709551615]"), parse("[18446744073709551614]")).changed) ==
+        std::vector<std::string>{"[0]"});
+
+  // Integers a double holds exactly still equal it.
+  CHECK(diff(parse(R"({"ts": 9007199254740992})"), parse(R"({"ts": 9007199254740992.0})")).empty());
+  CHECK_FALSE(parse("9007199254740993") == parse("9007199254740992.0"));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,165 @@
+#include <sourcerer/frozen_node.hpp>
+#include <sourcerer/node_builder.hpp>
+
+#include <cstdint>
+#include <doctest.h>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+TEST_SUITE_BEGIN("[FrozenNode]");
+using namespace sourcerer;
+
+namespace {
+
+Node make_tree() {
+  NodeBuilder builder;
+  builder.begin_object();
+  builder.key("name");
+  builder.value("a rather long string value");
+  builder.key("list");
+  builder.begin_array();
+  builder.value(1);
+  builder.value(std::uint64_t{2});
+  builder.value(0.5);
+  builder.value(true);
+  builder.value();
+  builder.end_array();
+  builder.key("nested");
+  builder.begin_object();
+  builder.key("name");
+  builder.value("short");
+  builder.end_object();
+  builder.key("empty");
+  builder.begin_object();
+  builder.end_object();
+  builder.end_object();
+  return builder.finish();
+}
+
+}  // namespace
+
+TEST_CASE("Freeze") {
+  const auto node = make_tree();
+  const auto tree = freeze(node);
+  const auto& root = tree.root();
+
+  SUBCASE("kinds") {
+    CHECK(root.is_object());
+    CHECK(root.at("name").is_string());
+    CHECK(root.at("list").is_array());
+    CHECK(root.at("list").at(0).is_integer());
+    CHECK(root.at("list").at(1).is_integer());
+    CHECK(root.at("list").at(2).is_floating());
+    CHECK(root.at("list").at(3).is_bool());
+    CHECK(root.at("list").at(4).is_null());
+    CHECK(root.at("empty").is_object());
+    CHECK(root.at("empty").empty());
+  }
+
+  SUBCASE("values") {
+    CHECK(root.at("name").as<std::string>() == "a rather long string value");
+    CHECK(root["nested"]["name"].as<std::string_view>() == "short");
+    CHECK(root.at("list").at(0).as<int>() == 1);
+    CHECK(root.at("list")[1].as<std::uint64_t>() == 2);
+    CHECK(root.at("list").at(2).as<double>() == 0.5);
+    CHECK(root.at("list").at(3).as<bool>());
+    CHECK(root.at("list").at(0).as<std::string>() == "1");
+  }
+
+  SUBCASE("lookups") {
+    CHECK(root.size() == node.size());
+    CHECK(root.contains("nested"));
+    CHECK_FALSE(root.contains("missing"));
+    CHECK(root.at("empty").find("name") == nullptr);
+    CHECK(root.at(node.keys()->intern("list")).size() == 5);
+
+    CHECK_THROWS_AS(root.at("missing"), std::out_of_range);
+    CHECK_THROWS_AS(root.at("list").at(5), std::out_of_range);
+    CHECK_THROWS_AS(root.at(0), std::invalid_argument);
+    CHECK_THROWS_AS(root.at("list").at("name"), std::invalid_argument);
+    CHECK_THROWS_AS(root.at("list").as<int>(), std::invalid_argument);
+  }
+
+  SUBCASE("iteration") {
+    std::vector<std::int64_t> values;
+    const auto& list = root.at("list");
+    for (auto it = list.begin(); it != list.begin() + 2; ++it) {
+      values.push_back(it->as<std::int64_t>());
+    }
+    CHECK(values == std::vector<std::int64_t>{1, 2});
+
+    // Children are contiguous.
+    CHECK(&list[1] == &list[0] + 1);
+
+    // Values iterate over themselves.
+    const auto& name = root.at("name");
+    CHECK(name.begin() == &name);
+    CHECK(name.end() == &name + 1);
+
+    std::size_t count = 0;
+    for (const auto& child : root) {
+      static_cast<void>(child);
+      ++count;
+    }
+    CHECK(count == 4);
+  }
+}
+
+TEST_CASE("Freeze scalars") {
+  CHECK(freeze(Node{}).root().is_null());
+  CHECK(freeze(Node{42}).root().as<int>() == 42);
+  CHECK(freeze(Node{"value"}).root().as<std::string>() == "value");
+}
+
+TEST_CASE("Freeze large objects") {
+  Node node;
+  for (int i = 0; i < 1000; ++i) {
+    node.insert("key" + std::to_string(i), i);
+  }
+
+  const auto tree = freeze(node);
+  for (int i = 0; i < 1000; ++i) {
+    CHECK(tree.root().at("key" + std::to_string(i)).as<int>() == i);
+  }
+  CHECK(tree.root().find("key1000") == nullptr);
+}
+
+TEST_CASE("Freeze keys with colliding hashes") {
+  // Search two keys whose hashes collide, the birthday bound makes that quick.
+  std::unordered_map<std::uint32_t, std::string> seen;
+  std::string first;
+  std::string second;
+  for (int i = 0; first.empty(); ++i) {
+    auto key = "key" + std::to_string(i);
+    if (auto [it, inserted] = seen.try_emplace(Key::hash(key), key); !inserted) {
+      first = it->second;
+      second = std::move(key);
+    }
+  }
+
+  Node node;
+  node.insert(first, 1);
+  node.insert(second, 2);
+  for (int i = 0; i < 100; ++i) {
+    node.insert("other" + std::to_string(i), 0);
+  }
+
+  const auto tree = freeze(node);
+  CHECK(tree.root().at(first).as<int>() == 1);
+  CHECK(tree.root().at(second).as<int>() == 2);
+  CHECK(tree.root().at(node.keys()->intern(second)).as<int>() == 2);
+  CHECK(tree.root().at("other42").as<int>() == 0);
+}
+
+TEST_CASE("Moving keeps the nodes in place") {
+  auto tree = freeze(make_tree());
+  const auto* list = &tree.root().at("list");
+
+  const auto moved = std::move(tree);
+  CHECK(&moved.root().at("list") == list);
+  CHECK(list->at(0).as<int>() == 1);
+}
+
+TEST_SUITE_END();
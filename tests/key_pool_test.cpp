@@ -0,0 +1,72 @@
+#include <sourcerer/key_pool.hpp>
+
+#include <doctest.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_SUITE_BEGIN("[KeyPool]");
+using namespace sourcerer;
+
+TEST_CASE("Intern") {
+  KeyPool pool;
+
+  SUBCASE("the same key is interned once") {
+    const auto host = pool.intern("host");
+    CHECK(host.view() == "host");
+    CHECK(host.hash() == Key::hash("host"));
+    CHECK(pool.intern(std::string{"host"}) == host);
+    CHECK(pool.size() == 1);
+    CHECK(pool.bytes() >= 4);
+  }
+
+  SUBCASE("distinct keys") {
+    const auto host = pool.intern("host");
+    const auto port = pool.intern("port");
+    CHECK_FALSE(host == port);
+    CHECK(host < port);
+    CHECK(pool.size() == 2);
+  }
+
+  SUBCASE("empty key") { CHECK(pool.intern("").view().empty()); }
+
+  SUBCASE("find") {
+    CHECK_FALSE(pool.find("host").has_value());
+    const auto host = pool.intern("host");
+    CHECK(pool.find("host") == host);
+  }
+
+  SUBCASE("many keys") {
+    std::vector<Key> keys;
+    for (int i = 0; i < 1000; ++i) {
+      keys.push_back(pool.intern("key" + std::to_string(i)));
+    }
+    CHECK(pool.size() == 1000);
+    for (int i = 0; i < 1000; ++i) {
+      CHECK(pool.intern("key" + std::to_string(i)) == keys[i]);
+    }
+  }
+
+  SUBCASE("keys of different pools compare by text") {
+    KeyPool other;
+    CHECK(pool.intern("host") == other.intern("host"));
+    CHECK_FALSE(pool.intern("host") == other.intern("port"));
+  }
+
+  SUBCASE("concurrently") {
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+      threads.emplace_back([&pool] {
+        for (int i = 0; i < 1000; ++i) {
+          pool.intern("key" + std::to_string(i));
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    CHECK(pool.size() == 1000);
+  }
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,131 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/loader.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <deque>
+#include <doctest.h>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+TEST_SUITE_BEGIN("[Loader]");
+using namespace sourcerer;
+
+namespace {
+
+// Holds the tasks back until it has count of them and runs them in reverse, so they finish in
+// another order than they were submitted.
+class Reversed : public Executor {
+ public:
+  explicit Reversed(const std::size_t count) : count_{count} {}
+
+  void execute(std::function<void()> task) override {
+    tasks_.push_front(std::move(task));
+    if (tasks_.size() < count_) return;
+    for (auto& held : tasks_) held();
+    tasks_.clear();
+  }
+
+ private:
+  std::size_t count_;
+  std::deque<std::function<void()>> tasks_;
+};
+
+// Sources fail with the exceptions their parsers throw, which builds without exceptions don't.
+#if SOURCERER_EXCEPTIONS
+class Refusing : public Executor {
+ public:
+  void execute(std::function<void()>) override { throw std::runtime_error("Refused"); }
+};
+#endif
+
+// Runs a task right away, as soon as it is submitted.
+class Inline : public Executor {
+ public:
+  void execute(std::function<void()> task) override { task(); }
+};
+
+}  // namespace
+
+TEST_CASE("Load") {
+  std::deque<StringConjurer> conjurers;
+  Loader loader;
+  for (int i = 0; i < 50; ++i) {
+    conjurers.emplace_back(R"({"fragment": )" + std::to_string(i) + "}");
+    CHECK(loader.add(conjurers.back()) == static_cast<std::size_t>(i));
+  }
+  CHECK(loader.size() == 50);
+
+  for (int pass = 0; pass < 2; ++pass) {
+    const auto results = loader.load();
+    REQUIRE(results.size() == 50);
+    for (int i = 0; i < 50; ++i) {
+      REQUIRE(results[i].ok());
+      CHECK(results[i].value().at("fragment").as<int>() == i);
+    }
+  }
+
+  CHECK(Loader{}.load().empty());
+}
+
+#if SOURCERER_EXCEPTIONS
+TEST_CASE("Errors stay with their source") {
+  StringConjurer valid{R"({"a": 1})"};
+  StringConjurer invalid{R"({"a": )"};
+  StringConjurer other{"[1, 2]"};
+
+  ThreadPool pool{2};
+  Loader loader{pool};
+  loader.add(valid);
+  loader.add(invalid);
+  loader.add(other, [](Conjurer& conjurer) -> Node {
+    throw std::runtime_error("Can't parse " + conjurer.conjure());
+  });
+
+  auto results = loader.load();
+  CHECK(results[0]);
+  CHECK(results[0].value().at("a").as<int>() == 1);
+  CHECK_FALSE(results[1]);
+  CHECK(results[1].error());
+  CHECK_THROWS_AS(results[1].value(), nlohmann::json::parse_error);
+  CHECK_FALSE(results[2].ok());
+  CHECK_THROWS_WITH_AS(results[2].value(), "Can't parse [1, 2]", std::runtime_error);
+
+  const auto tree = std::move(results[0]).value();
+  CHECK(tree.at("a").as<int>() == 1);
+}
+#endif
+
+TEST_CASE("Executors") {
+  StringConjurer first{"1"};
+  StringConjurer second{"2"};
+
+  Inline now;
+  Loader direct{now};
+  direct.add(first);
+  direct.add(second);
+  const auto results = direct.load();
+  CHECK(results[0].value().as<int>() == 1);
+  CHECK(results[1].value().as<int>() == 2);
+
+#if SOURCERER_EXCEPTIONS
+  // An executor that refuses tasks fails their sources.
+  Refusing refusing;
+  Loader refused{refusing};
+  refused.add(first);
+  const auto failed = refused.load();
+  CHECK_THROWS_WITH_AS(failed[0].value(), "Refused", std::runtime_error);
+#endif
+
+  // Tasks can finish in any order, the results are in the order of the sources.
+  Reversed reversed{2};
+  Loader loader{reversed};
+  loader.add(first);
+  loader.add(second);
+  const auto loaded = loader.load();
+  CHECK(loaded[0].value().as<int>() == 1);
+  CHECK(loaded[1].value().as<int>() == 2);
+}
+
+TEST_SUITE_END();
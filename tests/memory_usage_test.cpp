@@ -0,0 +1,153 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/key_pool.hpp>
+#include <sourcerer/memory_usage.hpp>
+#include <sourcerer/node.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+TEST_SUITE_BEGIN("[MemoryUsage]");
+using namespace sourcerer;
+
+namespace {
+
+using entry = Node::object_t::value_type;
+constexpr auto key_handle = sizeof(entry) - sizeof(Node);
+
+Node parse(const std::string& text) {
+  StringConjurer conjurer{text};
+  return JsonSourcerer{conjurer}.source();
+}
+
+std::size_t pool_bytes(const Node& object) {
+  return sizeof(KeyPool) + object.keys()->bytes();
+}
+
+}  // namespace
+
+TEST_CASE("Memory usage") {
+  const std::string text = "a string too long to be stored inline";
+
+  SUBCASE("scalars are stored in their node") {
+    for (const auto& node : {Node{}, Node{42}, Node{0.5}, Node{true}, Node{"inline"}}) {
+      CHECK(node.memory_usage() == MemoryUsage{sizeof(Node), 0, 0, 0});
+    }
+    CHECK(Node{text}.memory_usage() == MemoryUsage{sizeof(Node), 0, text.size(), 0});
+  }
+
+  SUBCASE("arrays") {
+    Node array{Node::array_t{}};
+    array.reserve(4);
+    array.push_back(1);
+    array.push_back(text);
+
+    const auto usage = array.memory_usage();
+    CHECK(usage.nodes == 3 * sizeof(Node));
+    CHECK(usage.keys == 0);
+    CHECK(usage.values == text.size());
+    CHECK(usage.containers == sizeof(detail::shared_block<Node::array_t>) + 2 * sizeof(Node));
+    CHECK(usage.total() == usage.nodes + usage.values + usage.containers);
+  }
+
+  SUBCASE("packed numbers count towards their array") {
+    const auto array = parse("[1, 2, 3]");
+    const auto before = array.memory_usage();
+    array.numbers<double>();
+    array.numbers<std::int64_t>();
+    CHECK(array.memory_usage().containers ==
+          before.containers + 2 * (sizeof(detail::packed_numbers) + 3 * sizeof(double)));
+  }
+
+  SUBCASE("objects") {
+    Node object{Node::object_t{}};
+    object.reserve(2);
+    object.insert("host", text);
+    object.insert("port", 80);
+
+    const auto usage = object.memory_usage();
+    CHECK(usage.nodes == 3 * sizeof(Node));
+    CHECK(usage.keys == 2 * key_handle + pool_bytes(object));
+    CHECK(usage.values == text.size());
+    // The entries are full, and the hashes of two keys are all there is to look them up by.
+    CHECK(usage.containers ==
+          sizeof(detail::shared_block<Node::object_t>) + 2 * sizeof(std::uint32_t));
+  }
+
+  SUBCASE("shared containers and key pools count once") {
+    const auto tree = parse(R"({"a": {"x": 1, "y": 2}, "b": {"x": 3, "y": 4}})");
+    const auto child = tree.at("a").memory_usage();
+    const auto usage = tree.memory_usage();
+    CHECK(usage.keys == 6 * key_handle + pool_bytes(tree));
+    CHECK(usage.keys < tree.at("a").memory_usage().keys * 2);
+
+    Node copies;
+    copies.push_back(tree.at("a"));
+    copies.push_back(tree.at("a"));
+    const auto shared = copies.memory_usage();
+    CHECK(shared.nodes == sizeof(Node) + 2 * sizeof(Node) + child.nodes - sizeof(Node));
+    CHECK(shared.keys == child.keys);
+  }
+
+  SUBCASE("budgets") {
+    std::string document = "[";
+    for (int i = 0; i < 100; ++i) {
+      if (i != 0) document += ',';
+      document += R"({"name": "service_)" + std::to_string(i) +
+                  R"(", "port": 8080, "tags": ["a", "b"], "url": "https://example.org/)" +
+                  std::to_string(i) + "\"}";
+    }
+    document += ']';
+
+    // 100 records of 7 nodes, 4 keys and 1 long string each, in their containers.
+    const auto usage = parse(document).memory_usage();
+    CHECK(usage.nodes == (1 + 100 * 7) * sizeof(Node));
+    CHECK(usage.values == 100 * 20 + 10 * 1 + 90 * 2);
+    CHECK(usage.total() < 100 * 512);
+  }
+}
+
+TEST_CASE("Memory usage by path") {
+  const auto tree = parse(R"({
+    "small": 1,
+    "hosts": [
+      "primary.database.eu-west-1.example.org",
+      "replica-1.database.eu-west-1.example.org",
+      "replica-2.database.eu-west-1.example.org",
+      "replica-3.database.eu-west-1.example.org",
+      "replica-4.database.eu-west-1.example.org"
+    ],
+    "db": {"pool": {"size": 10}}
+  })");
+
+  SUBCASE("largest first") {
+    const auto subtrees = memory_usage_by_path(tree);
+    REQUIRE(subtrees.size() == 3);
+    CHECK(subtrees[0].path == "hosts");
+    CHECK(subtrees[0].usage == tree.at("hosts").memory_usage());
+    CHECK(subtrees[1].path == "db");
+    CHECK(subtrees[1].usage.keys == 2 * key_handle);
+    CHECK(subtrees[2].path == "small");
+    CHECK(subtrees[2].usage == MemoryUsage{sizeof(Node), 0, 0, 0});
+  }
+
+  SUBCASE("deeper") {
+    std::vector<std::string> paths;
+    for (const auto& subtree : memory_usage_by_path(tree, 3)) {
+      paths.push_back(subtree.path);
+    }
+    CHECK(paths.size() == 10);
+    CHECK(std::ranges::find(paths, "hosts[4]") != paths.end());
+    CHECK(std::ranges::find(paths, "db.pool.size") != paths.end());
+  }
+
+  SUBCASE("scalars have no subtrees") {
+    CHECK(memory_usage_by_path(Node{42}, 3).empty());
+    CHECK(memory_usage_by_path(tree, 0).empty());
+  }
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,202 @@
+#include <sourcerer/node_builder.hpp>
+
+#include <cstddef>
+#include <doctest.h>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+
+TEST_SUITE_BEGIN("[NodeBuilder]");
+using namespace sourcerer;
+
+namespace {
+
+// Counts the allocations made through it.
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  std::size_t allocations = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace
+
+TEST_CASE("Build") {
+  NodeBuilder builder;
+
+  SUBCASE("a value") {
+    builder.value(42);
+    const auto node = builder.finish();
+    CHECK(node.as<int>() == 42);
+  }
+
+  SUBCASE("nested containers") {
+    builder.begin_object();
+    builder.key("list");
+    builder.begin_array();
+    builder.value("a rather long string value");
+    builder.value(true);
+    builder.value();
+    builder.begin_array();
+    builder.end_array();
+    builder.end_array();
+    builder.key("name");
+    builder.value("sourcerer");
+    builder.end_object();
+
+    const auto node = builder.finish();
+    CHECK(node.size() == 2);
+    CHECK(node.at("name").as<std::string>() == "sourcerer");
+
+    const auto& list = node.at("list");
+    REQUIRE(list.size() == 4);
+    CHECK(list.capacity() == 4);
+    CHECK(list[0].as<std::string>() == "a rather long string value");
+    CHECK(list[1].as<bool>());
+    CHECK(list[2].is_null());
+    CHECK(list[3].is_array());
+    CHECK(list[3].empty());
+  }
+
+  SUBCASE("objects share the pool of the builder") {
+    builder.begin_array();
+    for (int i = 0; i < 3; ++i) {
+      builder.begin_object();
+      builder.key("port");
+      builder.value(i);
+      builder.end_object();
+    }
+    builder.end_array();
+
+    const auto node = builder.finish();
+    const auto port = builder.keys()->intern("port");
+    for (int i = 0; i < 3; ++i) {
+      CHECK(node[i].keys() == builder.keys());
+      CHECK(node[i].at(port).as<int>() == i);
+    }
+    CHECK(builder.keys()->size() == 1);
+  }
+
+  SUBCASE("the builder can be reused") {
+    builder.value(1);
+    CHECK(builder.finish().as<int>() == 1);
+    builder.value(2);
+    CHECK(builder.finish().as<int>() == 2);
+  }
+}
+
+TEST_CASE("Object keys") {
+  SUBCASE("unsorted keys are sorted") {
+    NodeBuilder builder;
+    builder.begin_object();
+    for (const auto* key : {"c", "a", "b"}) {
+      builder.key(key);
+      builder.value(key);
+    }
+    builder.end_object();
+
+    const auto node = builder.finish();
+    std::string order;
+    for (const auto& value : node) {
+      order += value.as<std::string>();
+    }
+    CHECK(order == "abc");
+    CHECK(node.at("c").as<std::string>() == "c");
+  }
+
+  SUBCASE("insertion order") {
+    NodeBuilder builder{{}, std::make_shared<KeyPool>(), Node::key_order::insertion};
+    builder.begin_object();
+    for (const auto* key : {"c", "a", "b"}) {
+      builder.key(key);
+      builder.value(key);
+    }
+    builder.end_object();
+
+    std::string order;
+    for (const auto& value : builder.finish()) {
+      order += value.as<std::string>();
+    }
+    CHECK(order == "cab");
+  }
+
+  SUBCASE("the last duplicate wins") {
+    for (const auto order : {Node::key_order::sorted, Node::key_order::insertion}) {
+      NodeBuilder builder{{}, std::make_shared<KeyPool>(), order};
+      builder.begin_object();
+      builder.key("b");
+      builder.value(1);
+      builder.key("a");
+      builder.value(2);
+      builder.key("b");
+      builder.value(3);
+      builder.end_object();
+
+      const auto node = builder.finish();
+      CHECK(node.size() == 2);
+      CHECK(node.at("b").as<int>() == 3);
+    }
+  }
+}
+
+TEST_CASE("Children are moved, not copied") {
+  CountingResource resource;
+  NodeBuilder builder{&resource};
+
+  builder.begin_array();
+  for (int i = 0; i < 3; ++i) {
+    builder.begin_object();
+    builder.key("a_rather_long_key_name");
+    builder.value("a rather long string value");
+    builder.end_object();
+  }
+  builder.end_array();
+  const auto node = builder.finish();
+
+  // One allocation for the string, the object container and its entries and hashes each, plus the
+  // root array container and its elements.
+  CHECK(resource.allocations == 3 * 4 + 2);
+  CHECK(node.get_allocator().resource() == &resource);
+  CHECK(node[2].at("a_rather_long_key_name").get_allocator().resource() == &resource);
+}
+
+TEST_CASE("Misuse") {
+  NodeBuilder builder;
+
+  SUBCASE("unbalanced containers") {
+    CHECK_THROWS_AS(builder.end_array(), std::logic_error);
+    builder.begin_array();
+    CHECK_THROWS_AS(builder.end_object(), std::logic_error);
+    CHECK_THROWS_AS(builder.finish(), std::logic_error);
+  }
+
+  SUBCASE("keys") {
+    CHECK_THROWS_AS(builder.key("key"), std::logic_error);
+    builder.begin_object();
+    CHECK_THROWS_AS(builder.value(1), std::logic_error);
+    builder.key("key");
+    CHECK_THROWS_AS(builder.key("other"), std::logic_error);
+    CHECK_THROWS_AS(builder.end_object(), std::logic_error);
+  }
+
+  SUBCASE("more than one root") {
+    builder.value(1);
+    CHECK_THROWS_AS(builder.value(2), std::logic_error);
+  }
+
+  SUBCASE("empty") { CHECK_THROWS_AS(builder.finish(), std::logic_error); }
+}
+
+TEST_SUITE_END();
@@ -1,6 +1,15 @@
 #include <sourcerer/node.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <doctest.h>
+#include <limits>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 
 TEST_SUITE_BEGIN("[Node]");
 using namespace sourcerer;
@@ -19,19 +28,18 @@ TEST_CASE("Simple constructors") {
     CHECK(node2.is_array());
   }
 
-  SUBCASE("Default constructor with parent") {
-    Node node1;
-    Node node2(&node1);
-    CHECK(node2.is_null());
-    CHECK(node2.parent() == &node1);
+  SUBCASE("Copy constructor of a value") {
+    Node node{"value"};
+    Node copy{node};
+    CHECK(copy.is_value());
+    CHECK(copy.as<Node::value_t>() == "value");
   }
 
-  SUBCASE("Copy constructor with parent") {
-    Node parent{Node::object_t{}};
-    Node node{&parent, "value"};
-    Node copy{&parent, node};
+  SUBCASE("Copy constructor of a long value") {
+    Node node{"a value that doesn't fit inline"};
+    Node copy{node};
     CHECK(copy.is_value());
-    CHECK(copy.as<Node::value_t>() == "value");
+    CHECK(copy.as<Node::value_t>() == "a value that doesn't fit inline");
   }
 }
 
@@ -41,31 +49,62 @@ TEST_CASE_TEMPLATE("Move constructors", T, Node::null_t, Node::value_t, Node::ar
     const T value{};
     Node node{value};
     CHECK(node.is<T>());
-    CHECK(!node.has_parent());
   }
 
   SUBCASE("Value move constructor") {
     Node node{T{}};
     CHECK(node.is<T>());
-    CHECK(!node.has_parent());
   }
 
   SUBCASE("Move constructor") {
     Node node{T{}};
     Node copy{std::move(node)};
     CHECK(copy.is<T>());
-    CHECK(!node.has_parent());
+    CHECK(node.is_null());
+  }
+}
+
+TEST_CASE("Layout") {
+  static_assert(sizeof(Node) <= 24);
+
+  Node node;
+  node["key"].push_back("value");
+  const Node* child = &node.at("key").at(0);
+
+  SUBCASE("Move constructor keeps the children in place") {
+    Node moved{std::move(node)};
+    CHECK(&moved.at("key").at(0) == child);
   }
 
-  SUBCASE("Copy constructor with parent") {
-    Node parent{Node::object_t{}};
-    Node node{&parent, Node::null_t{}};
-    Node copy{&parent, node};
-    CHECK(copy.is_null());
-    CHECK(copy.parent() == &parent);
+  SUBCASE("Move assignment keeps the children in place") {
+    Node moved;
+    moved = std::move(node);
+    CHECK(&moved.at("key").at(0) == child);
+  }
+
+  SUBCASE("Assigning a child to its parent") {
+    node = node.at("key");
+    CHECK(node.is_array());
+    CHECK(node[0].as<Node::value_t>() == "value");
+  }
+
+  SUBCASE("Move assigning a child to its parent") {
+    node = std::move(node.at("key"));
+    CHECK(node.is_array());
+    CHECK(node[0].as<Node::value_t>() == "value");
   }
 }
 
+TEST_CASE("Find parent") {
+  Node node;
+  node["key"].push_back("value");
+
+  CHECK(node.find_parent(node.at("key")) == &node);
+  CHECK(node.find_parent(node.at("key").at(0)) == &node.at("key"));
+  CHECK(node.find_parent(node) == nullptr);
+  CHECK(node.at("key").find_parent(node) == nullptr);
+}
+
 TEST_CASE_TEMPLATE("Array accessors", T, Node, const Node) {
   Node init_node;
   init_node.push_back("value");
@@ -166,6 +205,151 @@ TEST_CASE("Array modifiers") {
   }
 }
 
+TEST_CASE("Moving children") {
+  Node child;
+  child.push_back("a rather long string value");
+  const auto* grandchild = &child[0];
+
+  SUBCASE("push_back steals the subtree") {
+    Node node;
+    node.push_back(std::move(child));
+    CHECK(&node[0][0] == grandchild);
+    CHECK(child.is_null());
+  }
+
+  SUBCASE("insert steals the subtree") {
+    Node node;
+    node.insert("key", std::move(child));
+    CHECK(&node["key"][0] == grandchild);
+  }
+
+  SUBCASE("copies of a container with references into it are deep") {
+    Node node;
+    node.push_back(child);
+    CHECK(&node[0][0] != grandchild);
+    CHECK(node[0] == child);
+  }
+
+  SUBCASE("nodes of another resource are copied") {
+    std::pmr::monotonic_buffer_resource resource;
+    Node node{&resource};
+    node.push_back(std::move(child));
+    CHECK(node[0][0].as<std::string>() == "a rather long string value");
+    CHECK(node[0][0].get_allocator().resource() == &resource);
+  }
+
+  SUBCASE("assigning a container moves it") {
+    Node::array_t array;
+    array.emplace_back(1);
+    const auto* element = array.data();
+
+    Node node;
+    node = std::move(array);
+    CHECK(&node[0] == element);
+  }
+}
+
+TEST_CASE("Copy on write") {
+  Node::array_t list;
+  list.emplace_back(1);
+  list.emplace_back(2);
+  Node::array_t other;
+  other.emplace_back("a rather long string value");
+
+  Node::object_t object;
+  object.try_emplace("list", std::move(list));
+  object.try_emplace("other", std::move(other));
+  const Node original{std::move(object)};
+
+  SUBCASE("copies share the containers") {
+    const Node copy{original};
+    CHECK(&copy.at("list") == &original.at("list"));
+    CHECK(copy == original);
+  }
+
+  SUBCASE("writing to a copy only clones the path to the change") {
+    Node copy{original};
+    copy["list"].push_back(3);
+
+    CHECK(original.at("list").size() == 2);
+    CHECK(std::as_const(copy).at("list").size() == 3);
+    CHECK(&std::as_const(copy).at("other").at(0) == &original.at("other").at(0));
+  }
+
+  SUBCASE("references into a container make later copies deep") {
+    Node copy{original};
+    auto& element = copy["list"][0];
+    const Node second{copy};
+    element = 5;
+
+    CHECK(second.at("list").at(0).as<int>() == 1);
+    CHECK(original.at("list").at(0).as<int>() == 1);
+  }
+
+  SUBCASE("clearing a copy keeps the keys") {
+    Node copy{original};
+    copy.clear();
+    CHECK(copy.is_object());
+    CHECK(copy.empty());
+    CHECK(copy.keys() == original.keys());
+    CHECK(original.size() == 2);
+  }
+
+  SUBCASE("erasing from a copy") {
+    Node copy{original};
+    copy.erase("list");
+    CHECK(copy.size() == 1);
+    CHECK(original.size() == 2);
+  }
+}
+
+TEST_CASE("Emplace") {
+  Node node;
+
+  SUBCASE("emplace_back constructs in place") {
+    auto& element = node.emplace_back(42);
+    CHECK(&element == &node[0]);
+    CHECK(node[0].as<int>() == 42);
+    CHECK(node.emplace_back().is_null());
+  }
+
+  SUBCASE("emplace with key") {
+    node.emplace("key", "value");
+    CHECK(node.emplace("key", "other").as<std::string>() == "value");
+  }
+
+  SUBCASE("reserve") {
+    CHECK_THROWS_AS(node.reserve(8), std::invalid_argument);
+    CHECK(node.capacity() == 0);
+
+    node = Node::array_t{};
+    node.reserve(8);
+    CHECK(node.capacity() >= 8);
+
+    node = Node::object_t{};
+    node.reserve(8);
+    CHECK(node.capacity() >= 8);
+  }
+
+  SUBCASE("errors name the modifier") {
+    node = Node::object_t{};
+    CHECK_THROWS_WITH_AS(node.push_back(1), "Can't push_back on a node of type object",
+                         std::invalid_argument);
+    CHECK_THROWS_WITH_AS(node.emplace_back(1), "Can't emplace_back on a node of type object",
+                         std::invalid_argument);
+    CHECK_THROWS_WITH_AS(node.insert(0, 1), "Can't insert with index on a node of type object",
+                         std::invalid_argument);
+    CHECK_THROWS_WITH_AS(node.emplace(0, 1), "Can't emplace with index on a node of type object",
+                         std::invalid_argument);
+
+    node = Node::array_t{};
+    CHECK_THROWS_WITH_AS(node.insert("key", 1), "Can't insert with key on a node of type array",
+                         std::invalid_argument);
+    CHECK_THROWS_WITH_AS(node.emplace("key", 1), "Can't emplace with key on a node of type array",
+                         std::invalid_argument);
+  }
+}
+
 TEST_CASE_TEMPLATE("Object accessors", T, Node, const Node) {
   Node init_node;
   init_node["key"] = "value";
@@ -243,6 +427,48 @@ TEST_CASE("Object modifiers") {
   }
 }
 
+TEST_CASE("Interned keys") {
+  Node node;
+  node["host"] = "localhost";
+  node["port"] = 8080;
+
+  const auto keys = node.keys();
+  REQUIRE(keys != nullptr);
+  const auto port = keys->intern("port");
+
+  CHECK(node.at(port).as<int>() == 8080);
+  CHECK(std::as_const(node)[port].as<int>() == 8080);
+  CHECK_THROWS_AS(node.at(keys->intern("missing")), std::out_of_range);
+
+  node[keys->intern("timeout_ms")] = 100;
+  CHECK(node.at("timeout_ms").as<int>() == 100);
+
+  const Node copy{node};
+  CHECK(copy.keys() == keys);
+  CHECK(copy.at(port).as<int>() == 8080);
+
+  CHECK_THROWS_AS(Node{}.keys(), std::invalid_argument);
+}
+
+TEST_CASE("Object key order") {
+  SUBCASE("sorted by default") {
+    Node node;
+    node["b"] = "1";
+    node["a"] = "2";
+    CHECK(node.begin()->as<Node::value_t>() == "2");
+  }
+
+  SUBCASE("insertion order") {
+    Node node{Node::object_t{Node::key_order::insertion}};
+    node["b"] = "1";
+    node["a"] = "2";
+    CHECK(node.begin()->as<Node::value_t>() == "1");
+
+    Node copy{node};
+    CHECK(copy.begin()->as<Node::value_t>() == "1");
+  }
+}
+
 TEST_CASE("Size") {
   Node node;
 
@@ -271,6 +497,92 @@ TEST_CASE("Size") {
   }
 }
 
+TEST_CASE("Scalars") {
+  SUBCASE("are stored natively") {
+    CHECK(Node{"value"}.is_string());
+    CHECK(Node{true}.is_bool());
+    CHECK(Node{-1}.is_integer());
+    CHECK(Node{1U}.is_integer());
+    CHECK(Node{1.5}.is_floating());
+    CHECK(Node{1.5}.is_number());
+    CHECK(Node{1.5}.is_value());
+    CHECK_FALSE(Node{1.5}.is_string());
+  }
+
+  SUBCASE("read as their own type") {
+    CHECK(Node{true}.as<bool>());
+    CHECK(Node{std::int64_t{-42}}.as<std::int64_t>() == -42);
+    CHECK(Node{std::uint64_t{42}}.as<std::uint64_t>() == 42);
+    CHECK(Node{0.25}.as<double>() == 0.25);
+    CHECK(Node{"value"}.as<std::string>() == "value");
+  }
+
+  SUBCASE("numbers convert between each other if they fit") {
+    CHECK(Node{std::int64_t{-42}}.as<int>() == -42);
+    CHECK(Node{std::uint64_t{42}}.as<std::int8_t>() == 42);
+    CHECK(Node{42}.as<double>() == 42.0);
+    CHECK(Node{42.0}.as<int>() == 42);
+    CHECK(Node{1}.as<bool>());
+    CHECK(Node{true}.as<int>() == 1);
+
+    CHECK_THROWS_AS(Node{-1}.as<unsigned>(), std::out_of_range);
+    CHECK_THROWS_AS(Node{300}.as<std::uint8_t>(), std::out_of_range);
+    CHECK_THROWS_AS(Node{0.5}.as<int>(), std::out_of_range);
+    CHECK_THROWS_AS(Node{1e19}.as<std::int64_t>(), std::out_of_range);
+  }
+
+  SUBCASE("fall back to strings") {
+    CHECK(Node{"42"}.as<int>() == 42);
+    CHECK(Node{"0.5"}.as<double>() == 0.5);
+    CHECK(Node{"true"}.as<bool>());
+    CHECK(Node{-42}.as<std::string>() == "-42");
+    CHECK(Node{std::numeric_limits<std::int64_t>::min()}.as<std::string>() ==
+          "-9223372036854775808");
+    CHECK(Node{0.5}.as<Node::value_t>() == "0.5");
+    CHECK(Node{false}.as<std::string>() == "false");
+
+    CHECK_THROWS_AS(Node{"value"}.as<int>(), std::invalid_argument);
+  }
+
+  SUBCASE("assignment replaces the kind") {
+    Node node{"a rather long string value"};
+    node = 42;
+    CHECK(node.is_integer());
+    CHECK(node.as<int>() == 42);
+
+    node = "value";
+    CHECK(node.is_string());
+
+    node = Node::array_t{};
+    node.push_back(true);
+    CHECK(node.is_array());
+    CHECK(node[0].is_bool());
+  }
+
+  SUBCASE("copies keep the kind") {
+    const Node node{0.5};
+    const Node copy{node};
+    CHECK(copy.is_floating());
+    CHECK(copy == node);
+  }
+
+  SUBCASE("numbers compare by value") {
+    CHECK(Node{1} == Node{1U});
+    CHECK(Node{1} == Node{1.0});
+    CHECK(Node{1U} == Node{1.0});
+    CHECK_FALSE(Node{-1} == Node{std::numeric_limits<std::uint64_t>::max()});
+    CHECK_FALSE(Node{1} == Node{"1"});
+    CHECK_FALSE(Node{1} == Node{true});
+  }
+
+  SUBCASE("clear resets to zero") {
+    Node node{42};
+    node.clear();
+    CHECK(node.is_integer());
+    CHECK(node.as<int>() == 0);
+  }
+}
+
 TEST_CASE("Operators") {
   SUBCASE("operator==") {
     CHECK(Node{"value"} == Node{"value"});
@@ -283,6 +595,184 @@ TEST_CASE("Operators") {
   }
 }
 
+TEST_CASE("Hash") {
+  SUBCASE("equal trees hash equal") {
+    Node lhs;
+    lhs["number"] = 1;
+    lhs["list"].push_back("a rather long string value");
+    lhs["list"].push_back(0.0);
+    Node rhs;
+    rhs["list"].push_back("a rather long string value");
+    rhs["list"].push_back(-0.0);
+    rhs["number"] = 1.0;
+
+    CHECK(lhs == rhs);
+    CHECK(lhs.hash() == rhs.hash());
+    CHECK(Node{1}.hash() == Node{1U}.hash());
+    CHECK(Node{1}.hash() == Node{1.0}.hash());
+    CHECK(Node{}.hash() == Node{Node::null_t{}}.hash());
+
+    rhs["number"] = 2;
+    CHECK(lhs != rhs);
+    CHECK(lhs.hash() != rhs.hash());
+    CHECK(Node{"1"}.hash() != Node{1}.hash());
+    CHECK(Node{Node::array_t{}}.hash() != Node{Node::object_t{}}.hash());
+  }
+
+  SUBCASE("writing invalidates the hashes on the path") {
+    Node node;
+    node["outer"]["inner"].push_back(1);
+    node["other"] = "value";
+    const auto before = node.hash();
+    const Node copy{node};
+
+    node["outer"]["inner"].push_back(2);
+    CHECK(node.hash() != before);
+    CHECK(copy.hash() == before);
+
+    node["outer"]["inner"].erase(1);
+    CHECK(node.hash() == before);
+    CHECK(node == copy);
+  }
+
+  SUBCASE("references don't leave stale hashes") {
+    Node node;
+    node["list"].push_back(1);
+    auto& element = node["list"][0];
+    const auto before = node.hash();
+
+    element = 5;
+    Node expected;
+    expected["list"].push_back(5);
+    CHECK(node.hash() != before);
+    CHECK(node.hash() == expected.hash());
+  }
+}
+
+TEST_CASE("Numbers") {
+  Node node;
+  node.push_back(1);
+  node.push_back(2.5);
+  node.push_back("-3.25");
+  node.push_back(std::uint64_t{4});
+
+  SUBCASE("are packed once") {
+    const auto& array = std::as_const(node);
+    const auto doubles = array.numbers<double>();
+    CHECK(std::vector<double>(doubles.begin(), doubles.end()) ==
+          std::vector<double>{1.0, 2.5, -3.25, 4.0});
+    CHECK(array.numbers<double>().data() == doubles.data());
+    CHECK(array.as<std::vector<double>>() == std::vector<double>{1.0, 2.5, -3.25, 4.0});
+    CHECK(array.as<std::vector<std::string>>() ==
+          std::vector<std::string>{"1", "2.5", "-3.25", "4"});
+
+    // 2.5 isn't an integer.
+    CHECK_THROWS_AS(array.numbers<std::int64_t>(), std::out_of_range);
+    CHECK_THROWS_AS(array.as<std::vector<int>>(), std::out_of_range);
+    CHECK_THROWS_AS(Node{1}.numbers<double>(), std::invalid_argument);
+  }
+
+  SUBCASE("writing drops them") {
+    const Node copy{node};
+    const auto doubles = copy.numbers<double>();
+    node.push_back(5);
+    CHECK(node.numbers<double>().size() == 5);
+    // The copy keeps its buffer.
+    CHECK(copy.numbers<double>().data() == doubles.data());
+    CHECK(doubles.size() == 4);
+  }
+
+  SUBCASE("references don't leave stale numbers") {
+    auto& element = node[0];
+    CHECK(std::as_const(node).numbers<double>()[0] == 1.0);
+    element = 7;
+    CHECK(std::as_const(node).numbers<double>()[0] == 7.0);
+    CHECK(std::as_const(node).as<std::vector<double>>()[0] == 7.0);
+  }
+
+  SUBCASE("integers") {
+    Node integers;
+    for (std::int64_t i = -2; i < 100; ++i) {
+      integers.push_back(i);
+    }
+    integers.push_back("123456789012");
+    const auto values = std::as_const(integers).numbers<std::int64_t>();
+    REQUIRE(values.size() == 103);
+    CHECK(values.front() == -2);
+    CHECK(values[101] == 99);
+    CHECK(values.back() == 123456789012);
+  }
+}
+
+TEST_CASE("Non-throwing access") {
+  Node list;
+  list.push_back(1);
+  list.push_back("2");
+  Node root;
+  root.insert("name", "server");
+  root.insert("port", -1);
+  root.insert("list", list);
+  const auto& tree = std::as_const(root);
+
+  SUBCASE("find") {
+    REQUIRE(tree.find("name") != nullptr);
+    CHECK(tree.find("name")->as<std::string>() == "server");
+    CHECK(tree.find("missing") == nullptr);
+    CHECK(tree.find(0) == nullptr);
+    CHECK(tree.find("list")->find(1) == &tree.at("list").at(1));
+    CHECK(tree.find("list")->find(2) == nullptr);
+    CHECK(tree.find("list")->find("name") == nullptr);
+    CHECK(Node{1}.find("name") == nullptr);
+
+    CHECK(tree.contains("port"));
+    CHECK_FALSE(tree.contains("missing"));
+    CHECK_FALSE(Node{}.contains("port"));
+  }
+
+  SUBCASE("try_at") {
+    const auto name = tree.try_at("name");
+    REQUIRE(name);
+    CHECK(&*name == &tree.at("name"));
+    CHECK(name->as<std::string>() == "server");
+    CHECK(tree.try_at("list").value().try_at(1).value().as<int>() == 2);
+
+    CHECK(tree.try_at("missing").error() == errc::key_not_found);
+    CHECK(tree.try_at(0).error() == errc::wrong_type);
+    CHECK(tree.at("list").try_at(2).error() == errc::index_out_of_range);
+    CHECK(tree.at("list").try_at("name").error() == errc::wrong_type);
+    CHECK(tree.try_at(tree.keys()->intern("port")).value().as<int>() == -1);
+    CHECK(tree.try_at(tree.keys()->intern("missing")).error() == errc::key_not_found);
+
+    CHECK_THROWS_WITH_AS(tree.try_at("missing").value(), "Key not found", std::out_of_range);
+    CHECK_THROWS_WITH_AS(tree.try_at(0).value(), "Node is not of the requested type: object",
+                         std::invalid_argument);
+  }
+
+  SUBCASE("try_as") {
+    CHECK(tree.at("port").try_as<int>().value() == -1);
+    CHECK(tree.at("list").at(1).try_as<int>().value() == 2);
+    CHECK(tree.at("list").try_as<std::vector<int>>().value() == std::vector<int>{1, 2});
+
+    const auto port = tree.at("port").try_as<unsigned>();
+    CHECK(port.error() == errc::out_of_range);
+    CHECK(port.value_or(80U) == 80);
+    CHECK(tree.at("name").try_as<int>().error() == errc::invalid_number);
+    CHECK(tree.at("list").try_as<int>().error() == errc::not_convertible);
+    CHECK(Node{}.try_as<std::string>().error() == errc::not_convertible);
+    CHECK(tree.at("name").try_as<std::vector<int>>().error() == errc::wrong_type);
+    CHECK(tree.try_as<std::vector<std::string>>().error() == errc::wrong_type);
+
+    CHECK_THROWS_AS(port.value(), std::out_of_range);
+    CHECK_THROWS_AS(tree.at("name").try_as<int>().value(), std::invalid_argument);
+  }
+
+  SUBCASE("messages are formatted on demand") {
+    CHECK(tree.at("port").try_as<std::uint8_t>().error().message() ==
+          "Value can't be represented by type \"unsigned char\"");
+    CHECK(tree.at("list").try_at(2).error().message() == "Index out of range");
+  }
+}
+
 TEST_CASE("Swap") {
   Node node1;
   node1.push_back("value1");
@@ -395,4 +885,113 @@ TEST_CASE("Iterator") {
   }
 }
 
+TEST_CASE("Typed views") {
+  Node array;
+  array.push_back(1);
+  array.push_back(2);
+  array.push_back(3);
+
+  Node object;
+  object.insert("host", "localhost");
+  object.insert("port", 80);
+
+  SUBCASE("arrays") {
+    const auto& node = array;
+    int sum = 0;
+    for (const auto& element : node.as_array()) sum += element.as<int>();
+    CHECK(sum == 6);
+    CHECK(node.as_array().size() == 3);
+    CHECK(node.as_array()[2].as<int>() == 3);
+  }
+
+  SUBCASE("objects yield keys and values") {
+    const auto& node = object;
+    std::vector<std::pair<std::string, std::string>> items;
+    for (const auto& [key, value] : node.items()) {
+      items.emplace_back(key.view(), value.as<std::string>());
+    }
+    CHECK(items == std::vector<std::pair<std::string, std::string>>{{"host", "localhost"},
+                                                                    {"port", "80"}});
+    CHECK(std::ranges::distance(node.as_object()) == 2);
+    CHECK(node.as_object().size() == 2);
+  }
+
+  SUBCASE("key access") {
+    const auto view = std::as_const(object).as_object();
+    CHECK(view.contains("host"));
+    CHECK_FALSE(view.contains("missing"));
+    CHECK(view.find("missing") == nullptr);
+    CHECK(view.find("port")->as<int>() == 80);
+    CHECK(view.at(object.keys()->intern("host")).as<std::string>() == "localhost");
+    CHECK_THROWS_AS(view.at("missing"), std::out_of_range);
+  }
+
+  SUBCASE("mutable views change the node") {
+    for (auto& element : array.as_array()) element = element.as<int>() * 2;
+    CHECK(array.at(2).as<int>() == 6);
+
+    for (auto [key, value] : object.items()) value = std::string{key.view()};
+    CHECK(object.at("port").as<std::string>() == "port");
+    object.as_object().at("host") = 443;
+    CHECK(object.at("host").as<int>() == 443);
+  }
+
+  SUBCASE("mutable views don't change copies") {
+    const auto copy = array;
+    array.as_array()[0] = 42;
+    CHECK(copy.at(0).as<int>() == 1);
+    CHECK(array.at(0).as<int>() == 42);
+  }
+
+  SUBCASE("null nodes give empty views") {
+    const Node node;
+    CHECK(node.as_array().empty());
+    CHECK(node.as_object().empty());
+    CHECK(node.items().begin() == node.items().end());
+    CHECK(node.as_object().find("key") == nullptr);
+  }
+
+  SUBCASE("other kinds throw") {
+    CHECK_THROWS_AS(object.as_array(), std::invalid_argument);
+    CHECK_THROWS_AS(array.as_object(), std::invalid_argument);
+    CHECK_THROWS_AS(Node{1}.as_array(), std::invalid_argument);
+  }
+}
+
+TEST_CASE("Allocator") {
+  std::array<std::byte, 4096> buffer{};
+  std::pmr::monotonic_buffer_resource resource{buffer.data(), buffer.size(),
+                                               std::pmr::null_memory_resource()};
+
+  Node node{&resource};
+  node["key"].push_back("value");
+
+  SUBCASE("children are allocated from the node's resource") {
+    CHECK(node.get_allocator().resource() == &resource);
+    CHECK(node.at("key").get_allocator().resource() == &resource);
+    CHECK(node.at("key").at(0).get_allocator().resource() == &resource);
+  }
+
+  SUBCASE("copy constructor uses the default resource") {
+    Node copy{node};
+    CHECK(copy.get_allocator().resource() == std::pmr::get_default_resource());
+    CHECK(copy.at("key").get_allocator().resource() == std::pmr::get_default_resource());
+    CHECK(copy.at("key").at(0).as<Node::value_t>() == "value");
+  }
+
+  SUBCASE("copy constructor with allocator") {
+    Node copy{node, &resource};
+    CHECK(copy.at("key").get_allocator().resource() == &resource);
+    CHECK(copy.at("key").at(0).as<Node::value_t>() == "value");
+  }
+
+  SUBCASE("move assignment keeps the resource") {
+    Node other;
+    other = std::move(node);
+    CHECK(other.get_allocator().resource() == std::pmr::get_default_resource());
+    CHECK(other.at("key").get_allocator().resource() == std::pmr::get_default_resource());
+    CHECK(other.at("key").at(0).as<Node::value_t>() == "value");
+  }
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,144 @@
+#include <sourcerer/path.hpp>
+
+#include <algorithm>
+#include <array>
+#include <doctest.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+TEST_SUITE_BEGIN("[Path]");
+using namespace sourcerer;
+
+namespace {
+
+Node make_tree() {
+  Node root;
+  for (int i = 0; i < 4; ++i) {
+    Node server;
+    server["name"] = "server" + std::to_string(i);
+    server["tls"]["cert"] = "cert" + std::to_string(i);
+    server["tls"]["key"] = "key" + std::to_string(i);
+    root["servers"].push_back(std::move(server));
+  }
+  root["a.b"] = 1;
+  root["*"] = 2;
+  return root;
+}
+
+std::vector<std::string> names(const Path& path, const Node& root) {
+  std::vector<std::string> result;
+  path.for_each(root, [&](const Node& node) { result.push_back(node.as<std::string>()); });
+  return result;
+}
+
+}  // namespace
+
+TEST_CASE("Parse") {
+  SUBCASE("valid paths") {
+    for (const auto* text : {"", "a", ".a", "a.b", "a[0]", "[0]", "a[-1]", "a[1:2]", "a[:]",
+                             "a[:-1]", "a.*", "*", "[*]", R"(["a.b"])", R"(a["\"\\"])"}) {
+      CHECK_NOTHROW(Path{text});
+    }
+  }
+
+  SUBCASE("invalid paths") {
+    for ([[maybe_unused]] const auto* text :
+         {"a.", "a..b", "a[", "a[]", "a[0", "a[x]", "a]", R"(a["b)", R"(a["\b"])", "a[1:2:3]",
+          "a[-]"}) {
+      CHECK_THROWS_AS(Path{text}, std::invalid_argument);
+    }
+  }
+
+  SUBCASE("single paths") {
+    CHECK(Path{"a[0].b"}.is_single());
+    CHECK_FALSE(Path{"a[0:1]"}.is_single());
+    CHECK_FALSE(Path{"a.*"}.is_single());
+  }
+
+  SUBCASE("equality") {
+    CHECK(Path{"a.b[0]"} == Path{R"(["a"].b[0])"});
+    CHECK_FALSE(Path{"a.b"} == Path{"a[0]"});
+  }
+}
+
+TEST_CASE("Find") {
+  const auto root = make_tree();
+
+  CHECK(Path{"servers[3].tls.cert"}.at(root).as<std::string>() == "cert3");
+  CHECK(Path{"servers[-1].name"}.at(root).as<std::string>() == "server3");
+  CHECK(Path{R"(["a.b"])"}.at(root).as<int>() == 1);
+  CHECK(Path{R"(["*"])"}.at(root).as<int>() == 2);
+  CHECK(&Path{""}.at(root) == &root);
+
+  CHECK(Path{"servers[4]"}.find(root) == nullptr);
+  CHECK(Path{"servers[-5]"}.find(root) == nullptr);
+  CHECK(Path{"servers.name"}.find(root) == nullptr);
+  CHECK(Path{"servers[0].name[0]"}.find(root) == nullptr);
+  CHECK(Path{"missing"}.find(root) == nullptr);
+  CHECK_THROWS_AS(Path{"missing.key"}.at(root), std::out_of_range);
+
+  CHECK(Path{"servers[*].name"}.at(root).as<std::string>() == "server0");
+}
+
+TEST_CASE("Wildcards and slices") {
+  const auto root = make_tree();
+
+  CHECK(names(Path{"servers[*].name"}, root) ==
+        std::vector<std::string>{"server0", "server1", "server2", "server3"});
+  CHECK(names(Path{"servers[1:3].name"}, root) == std::vector<std::string>{"server1", "server2"});
+  CHECK(names(Path{"servers[-2:].tls.key"}, root) == std::vector<std::string>{"key2", "key3"});
+  CHECK(names(Path{"servers[:1].tls.*"}, root) == std::vector<std::string>{"cert0", "key0"});
+  CHECK(names(Path{"servers[3:1].name"}, root).empty());
+  CHECK(names(Path{"servers[:100].name"}, root).size() == 4);
+}
+
+TEST_CASE("Path sets") {
+  const auto root = make_tree();
+
+  constexpr std::array<std::string_view, 5> texts{"servers[3].tls.cert", "servers[3].tls.key",
+                                                  "servers[*].name", "missing", "servers[3]"};
+  const PathSet paths{texts};
+  REQUIRE(paths.size() == texts.size());
+  CHECK(paths[1].str() == "servers[3].tls.key");
+
+  SUBCASE("resolve") {
+    std::array<const Node*, texts.size()> results{};
+    paths.resolve(root, results);
+
+    for (std::size_t i = 0; i < texts.size(); ++i) {
+      CHECK(results[i] == Path{texts[i]}.find(root));
+    }
+
+    [[maybe_unused]] std::array<const Node*, 1> too_few{};
+    CHECK_THROWS_AS(paths.resolve(root, too_few), std::invalid_argument);
+  }
+
+  SUBCASE("for_each") {
+    std::vector<std::pair<std::size_t, const Node*>> matches;
+    paths.for_each(root, [&](const std::size_t path, const Node& node) {
+      matches.emplace_back(path, &node);
+    });
+
+    // One match for each single path that exists, and one for each server name.
+    CHECK(matches.size() == 3 + 4);
+    const auto names = std::ranges::count_if(matches, [](const auto& match) {
+      return match.first == 2;
+    });
+    CHECK(names == 4);
+  }
+
+  SUBCASE("add") {
+    PathSet more;
+    CHECK(more.add("servers[0].name") == 0);
+    CHECK(more.add(Path{"servers[0].tls"}) == 1);
+
+    std::array<const Node*, 2> results{};
+    more.resolve(root, results);
+    CHECK(results[0]->as<std::string>() == "server0");
+    CHECK(results[1]->is_object());
+  }
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,131 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/publisher.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <atomic>
+#include <doctest.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+TEST_SUITE_BEGIN("[Publisher]");
+using namespace sourcerer;
+
+namespace {
+
+Node parse(const char* text) {
+  StringConjurer conjurer{text};
+  return JsonSourcerer{conjurer}.source();
+}
+
+}  // namespace
+
+TEST_CASE("Publish") {
+  Publisher publisher{parse(R"({"port": 80, "hosts": ["a", "b"]})")};
+  auto reader = publisher.reader();
+  CHECK(publisher.version() == 0);
+
+  {
+    const auto guard = reader.read();
+    CHECK(guard.version() == 0);
+    CHECK(guard->at("port").as<int>() == 80);
+
+    // A guard keeps its version while newer ones are published, nested guards see them.
+    publisher.publish(parse(R"({"port": 81})"));
+    CHECK(publisher.version() == 1);
+    CHECK(guard->at("hosts").at(1).as<std::string>() == "b");
+    {
+      const auto inner = reader.read();
+      CHECK(inner.version() == 1);
+      CHECK(inner->at("port").as<int>() == 81);
+    }
+
+    publisher.reclaim();
+    CHECK(publisher.retired() == 1);
+  }
+
+  // The replaced version is destroyed once no reader can see it.
+  publisher.reclaim();
+  CHECK(publisher.retired() == 0);
+  CHECK(reader.read()->at("port").as<int>() == 81);
+  CHECK(publisher.current().at("port").as<int>() == 81);
+}
+
+TEST_CASE("Update") {
+  Publisher publisher{parse(R"({"db": {"host": "localhost", "port": 5432}, "name": "service"})")};
+  auto reader = publisher.reader();
+  const auto before = reader.read();
+
+  publisher.update([](Node& root) { root["db"]["host"] = "db.internal"; });
+  CHECK(publisher.version() == 1);
+  CHECK(before->at("db").at("host").as<std::string>() == "localhost");
+  CHECK(reader.read()->at("db").at("host").as<std::string>() == "db.internal");
+
+  // Nothing is published if the update throws.
+  CHECK_THROWS_AS(publisher.update([](Node& root) {
+    root["name"] = "other";
+    throw std::runtime_error("failed");
+  }),
+                  std::runtime_error);
+  CHECK(publisher.version() == 1);
+  CHECK(publisher.current().at("name").as<std::string>() == "service");
+}
+
+TEST_CASE("Readers reuse slots") {
+  Publisher publisher;
+  {
+    auto first = publisher.reader();
+    auto second = publisher.reader();
+    const auto guard = first.read();
+    publisher.publish(parse("[1]"));
+  }
+  // The destroyed readers don't hold anything back, and their slots are handed out again.
+  auto reader = publisher.reader();
+  publisher.publish(parse("[2]"));
+  CHECK(publisher.retired() == 0);
+  CHECK(reader.read()->at(0).as<int>() == 2);
+}
+
+TEST_CASE("Concurrent readers and writers") {
+  Publisher publisher{parse(R"({"a": 0, "b": 0})")};
+  std::atomic<bool> stop{false};
+  std::atomic<int> inconsistent{0};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&] {
+      auto reader = publisher.reader();
+      while (!stop.load()) {
+        // Every version has the same value at both keys.
+        const auto guard = reader.read();
+        if (guard->at("a").as<int>() != guard->at("b").as<int>()) ++inconsistent;
+        const Node copy = *guard;
+        if (copy.at("a").as<int>() != copy.at("b").as<int>()) ++inconsistent;
+      }
+    });
+  }
+
+  std::thread updater{[&] {
+    for (int i = 1; i <= 500; ++i) {
+      publisher.update([i](Node& root) {
+        root["a"] = i;
+        root["b"] = i;
+      });
+    }
+  }};
+  for (int i = 501; i <= 1000; ++i) {
+    publisher.publish(parse(R"({"a": -1, "b": -1})"));
+  }
+  updater.join();
+  stop = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+
+  CHECK(inconsistent == 0);
+  CHECK(publisher.version() == 1000);
+  publisher.reclaim();
+  CHECK(publisher.retired() == 0);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,324 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/node_builder.hpp>
+#include <sourcerer/snapshot.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_SUITE_BEGIN("[Snapshot]");
+using namespace sourcerer;
+
+namespace {
+
+// Long enough to be stored apart from its entry. It occurs as a value twice and as a key once, and
+// is stored once.
+constexpr std::string_view repeated = "a string that occurs more than once";
+
+// What the encoding treats specially: every kind, a number only an unsigned integer holds, empty
+// strings and containers, strings that repeat, and an object whose keys aren't sorted unless
+// order sorts them.
+Node make_document(const Node::key_order order = Node::key_order::sorted) {
+  NodeBuilder builder{{}, std::make_shared<KeyPool>(), order};
+  builder.begin_object();
+  builder.key("service");
+  builder.value(repeated);
+  builder.key("values");
+  builder.begin_array();
+  builder.value(-1);
+  builder.value(std::uint64_t{18446744073709551615ULL});
+  builder.value(0.5);
+  builder.value(true);
+  builder.value();
+  builder.value(repeated);
+  builder.value("");
+  builder.begin_array();
+  builder.end_array();
+  builder.end_array();
+  builder.key("replicas");
+  builder.begin_object();
+  builder.key("zeta");
+  builder.value("z");
+  builder.key("alpha");
+  builder.value("a");
+  builder.key(repeated);
+  builder.value(2);
+  builder.end_object();
+  builder.key("empty");
+  builder.begin_object();
+  builder.end_object();
+  builder.end_object();
+  return builder.finish();
+}
+
+// Overwrites the bytes at offset with value and fixes the checksum, like a crafted file would.
+template <class T>
+std::string craft(std::string bytes, const std::size_t offset, const T value) {
+  std::memcpy(bytes.data() + offset, &value, sizeof(T));
+  const auto body = std::string_view{bytes}.substr(sizeof(detail::snapshot_header));
+  const auto checksum = detail::content_hash(body);
+  std::memcpy(bytes.data() + offsetof(detail::snapshot_header, checksum), &checksum,
+              sizeof(checksum));
+  return bytes;
+}
+
+// A directory that is removed again at the end of a test.
+struct TemporaryDirectory {
+  std::filesystem::path path =
+      std::filesystem::temp_directory_path() /
+      ("sourcerer_snapshot_test_" + std::to_string(std::random_device{}()));
+
+  ~TemporaryDirectory() { std::filesystem::remove_all(path); }
+};
+
+// Counts how often it parses, to tell cache hits from misses.
+struct CountingParser {
+  int* parsed;
+
+  Node operator()(std::string text) const {
+    ++*parsed;
+    return SnapshotCache::parse_json(std::move(text));
+  }
+};
+
+}  // namespace
+
+TEST_CASE("Encode and read") {
+  const auto node = make_document();
+  const Snapshot snapshot{Snapshot::encode(node, 42)};
+  const auto root = snapshot.root();
+
+  CHECK(snapshot.source_hash() == 42);
+  CHECK(snapshot.bytes() % 8 == 0);
+
+  // The repeated string is stored once, for its values and its key alike.
+  const auto bytes = Snapshot::encode(node);
+  CHECK(bytes.find(repeated) == bytes.rfind(repeated));
+
+  SUBCASE("kinds") {
+    CHECK(root.is_object());
+    CHECK(root.at("service").is_string());
+    CHECK(root.at("values").is_array());
+    CHECK(root.at("values").at(0).is_integer());
+    CHECK(root.at("values").at(1).is_integer());
+    CHECK(root.at("values").at(2).is_floating());
+    CHECK(root.at("values").at(3).is_bool());
+    CHECK(root.at("values").at(4).is_null());
+    CHECK(root.at("values").at(6).is_string());
+    CHECK(root.at("values").at(7).is_array());
+    CHECK(root.at("values").at(7).empty());
+    CHECK(root.at("empty").is_object());
+    CHECK(root.at("empty").empty());
+  }
+
+  SUBCASE("values") {
+    CHECK(root.at("service").as<std::string>() == repeated);
+    CHECK(root["replicas"]["alpha"].as<std::string_view>() == "a");
+    CHECK(root.at("values").at(0).as<int>() == -1);
+    CHECK(root.at("values")[1].as<std::uint64_t>() == 18446744073709551615ULL);
+    CHECK(root.at("values").at(2).as<double>() == 0.5);
+    CHECK(root.at("values").at(3).as<bool>());
+    CHECK(root.at("values").at(0).as<std::string>() == "-1");
+    CHECK(root.at("values").at(5).as<std::string>() == repeated);
+    CHECK(root.at("values").at(6).as<std::string>().empty());
+    CHECK(root.at("replicas").at(repeated).as<int>() == 2);
+    CHECK_THROWS_AS(root.at("values").as<int>(), std::invalid_argument);
+  }
+
+  SUBCASE("lookups") {
+    CHECK(root.size() == node.size());
+    CHECK(root.contains("replicas"));
+    CHECK_FALSE(root.contains("missing"));
+    CHECK_FALSE(root.at("empty").find("service").has_value());
+
+    CHECK_THROWS_AS(root.at("missing"), std::out_of_range);
+    CHECK_THROWS_AS(root.at("values").at(8), std::out_of_range);
+    CHECK_THROWS_AS(root.at(0), std::invalid_argument);
+    CHECK_THROWS_AS(root.at("values").at("service"), std::invalid_argument);
+  }
+
+  SUBCASE("iteration") {
+    std::vector<std::string> keys;
+    for (const auto member : root) {
+      keys.emplace_back(member.key());
+    }
+    CHECK(keys == std::vector<std::string>{"empty", "replicas", "service", "values"});
+    CHECK(root.at("values").at(0).size() == 1);
+    CHECK((*root.at("service").begin()).as<std::string>() == repeated);
+    CHECK(root.at("values").at(4).begin() == root.at("values").at(4).end());
+    CHECK_THROWS_AS(root.at("values").at(0).key(), std::logic_error);
+  }
+
+  SUBCASE("nodes") {
+    CHECK(root.node() == node);
+    CHECK(root.at("replicas").node() == node.at("replicas"));
+    CHECK(root.at("values").at(1).node() == node.at("values").at(1));
+  }
+}
+
+TEST_CASE("Objects in insertion order") {
+  const auto node = make_document(Node::key_order::insertion);
+  const Snapshot snapshot{Snapshot::encode(node)};
+  const auto replicas = snapshot.root().at("replicas");
+
+  std::vector<std::string> keys;
+  for (const auto member : replicas) {
+    keys.emplace_back(member.key());
+  }
+  CHECK(keys == std::vector<std::string>{"zeta", "alpha", std::string{repeated}});
+  CHECK(replicas.at("alpha").as<std::string>() == "a");
+  CHECK(replicas.at("zeta").as<std::string>() == "z");
+  CHECK_FALSE(replicas.contains("beta"));
+  CHECK(snapshot.root().node() == node);
+}
+
+TEST_CASE("Scalar roots") {
+  CHECK(Snapshot{Snapshot::encode(Node{})}.root().is_null());
+  CHECK(Snapshot{Snapshot::encode(Node{"text"})}.root().as<std::string>() == "text");
+  CHECK(Snapshot{Snapshot::encode(Node{2.5})}.root().node() == Node{2.5});
+}
+
+TEST_CASE("Repeated strings are stored once") {
+  NodeBuilder builder;
+  builder.begin_array();
+  for (int i = 0; i < 100; ++i) {
+    builder.begin_object();
+    builder.key("a key that is repeated");
+    builder.value("a value that is repeated as well");
+    builder.end_object();
+  }
+  builder.end_array();
+
+  const auto bytes = Snapshot::encode(builder.finish());
+  // An entry per array element and object member, a key per member, plus the header and strings.
+  CHECK(bytes.size() < 100 * (16 + 16 + 8) + 200);
+}
+
+TEST_CASE("Invalid snapshots") {
+  const auto bytes = Snapshot::encode(make_document());
+
+  CHECK_THROWS_AS(Snapshot{""}, std::invalid_argument);
+  CHECK_THROWS_AS(Snapshot{"not a snapshot, but long enough to hold a header"},
+                  std::invalid_argument);
+  CHECK_THROWS_AS(Snapshot{bytes.substr(0, bytes.size() - 8)}, std::invalid_argument);
+
+  auto corrupt = bytes;
+  corrupt[bytes.size() / 2] ^= 1;
+  CHECK_THROWS_AS(Snapshot{corrupt}, std::invalid_argument);
+
+  auto future = bytes;
+  future[8] = 2;
+  CHECK_THROWS_AS(Snapshot{future}, std::invalid_argument);
+
+  // Offsets are checked even if the checksum matches.
+  CHECK_NOTHROW(Snapshot{craft(bytes, 0, bytes[0])});
+  const auto root = sizeof(detail::snapshot_header);
+  [[maybe_unused]] const auto payload = offsetof(detail::snapshot_entry, payload);
+  [[maybe_unused]] const auto size = offsetof(detail::snapshot_entry, size);
+  [[maybe_unused]] const auto kind = offsetof(detail::snapshot_entry, kind);
+  CHECK_THROWS_AS(Snapshot{craft(bytes, root + payload, std::uint64_t{1} << 40)},
+                  std::invalid_argument);
+  CHECK_THROWS_AS(Snapshot{craft(bytes, root + payload, std::uint64_t{root})},
+                  std::invalid_argument);
+  CHECK_THROWS_AS(Snapshot{craft(bytes, root + size, std::uint32_t{1} << 30)},
+                  std::invalid_argument);
+  CHECK_THROWS_AS(Snapshot{craft(bytes, root + kind, std::uint8_t{42})}, std::invalid_argument);
+
+  const auto text = Snapshot::encode(Node{"a string too long to be stored in its node"});
+  CHECK_THROWS_AS(Snapshot{craft(text, root + size, std::uint32_t{1000})},
+                  std::invalid_argument);
+
+  // The first member of an object follows its only child.
+  const auto object = Snapshot::encode(SnapshotCache::parse_json(R"({"key": 1})"));
+  [[maybe_unused]] const auto key = root + 2 * sizeof(detail::snapshot_entry);
+  CHECK_NOTHROW(Snapshot{object});
+  CHECK_THROWS_AS(Snapshot{craft(object, key, std::uint32_t{1000})}, std::invalid_argument);
+}
+
+TEST_CASE("Files") {
+  const TemporaryDirectory directory;
+  std::filesystem::create_directories(directory.path);
+  const auto path = directory.path / "tree.snapshot";
+  const auto node = make_document();
+
+  Snapshot::write(node, path, 7);
+  const auto snapshot = Snapshot::open(path);
+  CHECK(snapshot.source_hash() == 7);
+  CHECK(snapshot.root().node() == node);
+
+  // Copies share the mapping, which outlives the original.
+  std::optional<Snapshot> copy;
+  {
+    const auto original = Snapshot::open(path);
+    copy = original;
+  }
+  CHECK(copy->root().at("service").as<std::string>() == repeated);
+
+  CHECK_THROWS_AS(Snapshot::open(directory.path / "missing.snapshot"), std::runtime_error);
+}
+
+TEST_CASE("Cache") {
+  const TemporaryDirectory directory;
+  int parsed = 0;
+  const auto document = std::string{R"({"port": 8080, "hosts": ["a", "b"]})"};
+  StringConjurer conjurer{document};
+
+  SUBCASE("serves loaded texts from memory") {
+    SnapshotCache cache{directory.path, CountingParser{&parsed}};
+    const auto first = cache.load(conjurer);
+    const auto second = cache.load(conjurer);
+    CHECK(parsed == 1);
+    CHECK(cache.size() == 1);
+    CHECK(second.root().at("port").as<int>() == 8080);
+    CHECK(second.source_hash() == detail::content_hash(document));
+  }
+
+  SUBCASE("reuses the snapshots of earlier caches") {
+    SnapshotCache{directory.path, CountingParser{&parsed}}.load(conjurer);
+    SnapshotCache cache{directory.path, CountingParser{&parsed}};
+    CHECK(cache.load(conjurer).root().at("hosts").at(1).as<std::string>() == "b");
+    CHECK(parsed == 1);
+  }
+
+  SUBCASE("parses changed texts") {
+    SnapshotCache cache{directory.path, CountingParser{&parsed}};
+    cache.load(conjurer);
+    StringConjurer changed{R"({"port": 9090})"};
+    CHECK(cache.load(changed).root().at("port").as<int>() == 9090);
+    CHECK(parsed == 2);
+    CHECK(cache.size() == 2);
+  }
+
+  SUBCASE("replaces corrupt snapshots") {
+    SnapshotCache{directory.path, CountingParser{&parsed}}.load(conjurer);
+    for (const auto& file : std::filesystem::directory_iterator{directory.path}) {
+      std::ofstream{file.path(), std::ios::trunc} << "garbage";
+    }
+
+    SnapshotCache cache{directory.path, CountingParser{&parsed}};
+    CHECK(cache.load(conjurer).root().at("port").as<int>() == 8080);
+    CHECK(parsed == 2);
+  }
+}
+
+TEST_CASE("Content hash") {
+  std::string text(100, 'x');
+  const auto hash = detail::content_hash(text);
+  CHECK(detail::content_hash(text) == hash);
+  for (std::size_t i = 0; i < text.size(); ++i) {
+    auto changed = text;
+    changed[i] = 'y';
+    CHECK(detail::content_hash(changed) != hash);
+    CHECK(detail::content_hash(std::string_view{text}.substr(0, i)) != hash);
+  }
+}
+
+TEST_SUITE_END();
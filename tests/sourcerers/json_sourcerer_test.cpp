@@ -0,0 +1,136 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+
+#include <array>
+#include <cstdint>
+#include <doctest.h>
+#include <memory_resource>
+#include <stdexcept>
+#include <utility>
+
+TEST_SUITE_BEGIN("[JsonSourcerer]");
+using namespace sourcerer;
+
+TEST_CASE("Source") {
+  StringConjurer conjurer{R"({"name": "sourcerer", "list": [1, 2, 3], "nested": {"flag": true}})"};
+  JsonSourcerer sourcerer{conjurer};
+  const auto node = sourcerer.source();
+
+  CHECK(node.is_object());
+  CHECK(node.at("name").as<std::string>() == "sourcerer");
+  CHECK(node.at("list").size() == 3);
+  CHECK(node.at("list").at(2).as<int>() == 3);
+  CHECK(node.at("nested").at("flag").as<bool>());
+}
+
+TEST_CASE("Scalars keep their type") {
+  StringConjurer conjurer{R"({"s": "1", "b": false, "i": -1, "u": 1, "f": 0.5, "n": null})"};
+  JsonSourcerer sourcerer{conjurer};
+  const auto node = sourcerer.source();
+
+  CHECK(node.at("s").is_string());
+  CHECK(node.at("b").is_bool());
+  CHECK(node.at("i").as<std::int64_t>() == -1);
+  CHECK(node.at("u").as<std::uint64_t>() == 1);
+  CHECK(node.at("f").is_floating());
+  CHECK(node.at("f").as<double>() == 0.5);
+  CHECK(node.at("n").is_null());
+}
+
+TEST_CASE("Objects share their keys") {
+  StringConjurer conjurer{R"([{"host": "a", "port": 1}, {"host": "b", "port": 2}, {}, []])"};
+  JsonSourcerer sourcerer{conjurer};
+  const auto node = sourcerer.source();
+
+  const auto keys = node.at(0).keys();
+  REQUIRE(keys != nullptr);
+  CHECK(keys == node.at(1).keys());
+  CHECK(keys->size() == 2);
+
+  const auto host = keys->intern("host");
+  CHECK(node.at(1).at(host).as<std::string>() == "b");
+
+  CHECK(node.at(2).is_object());
+  CHECK(node.at(2).empty());
+  CHECK(node.at(3).is_array());
+}
+
+TEST_CASE("Snapshots share the tree") {
+  StringConjurer conjurer{R"({"list": [1, 2, 3], "nested": {"flag": true}})"};
+  JsonSourcerer sourcerer{conjurer};
+
+  auto first = sourcerer.source();
+  const auto second = sourcerer.source();
+  CHECK(&std::as_const(first).at("nested") == &second.at("nested"));
+
+  first["list"].push_back(4);
+  CHECK(std::as_const(first).at("list").size() == 4);
+  CHECK(second.at("list").size() == 3);
+  CHECK(sourcerer.source().at("list").size() == 3);
+}
+
+TEST_CASE("Snapshots outlive the sourcerer") {
+  Node snapshot;
+  {
+    StringConjurer conjurer{R"({"name": "a rather long string value", "list": [1, 2, 3]})"};
+    JsonSourcerer sourcerer{conjurer};
+    snapshot = sourcerer.source();
+  }
+
+  CHECK(std::as_const(snapshot).at("name").as<std::string>() == "a rather long string value");
+  snapshot["list"].push_back(4);
+  CHECK(snapshot.at("list").size() == 4);
+}
+
+TEST_CASE("Parse modes build the same tree") {
+  StringConjurer conjurer{
+      R"({"s": "a rather long string value", "b": true, "i": -1, "u": 18446744073709551615,
+          "f": 0.5, "n": null, "list": [1, [2, {}], {"k": []}], "nested": {"z": 1, "a": 2}})"};
+  JsonSourcerer sax{conjurer};
+  JsonSourcerer dom{conjurer, nullptr, JsonSourcerer::parse_mode::dom};
+  JsonSourcerer simd{conjurer, nullptr, JsonSourcerer::parse_mode::simd};
+
+  const auto node = sax.source();
+  CHECK(node == dom.source());
+  CHECK(node == simd.source());
+  CHECK(node.at("u").as<std::uint64_t>() == 18446744073709551615ULL);
+  CHECK(node.at("list").at(1).at(1).is_object());
+  CHECK(node.at("list").at(2).at("k").is_array());
+}
+
+TEST_CASE("Parse modes agree on duplicate keys") {
+  StringConjurer conjurer{R"({"key": 1, "other": 2, "key": 3})"};
+  for (const auto mode : {JsonSourcerer::parse_mode::sax, JsonSourcerer::parse_mode::dom,
+                          JsonSourcerer::parse_mode::simd}) {
+    JsonSourcerer sourcerer{conjurer, nullptr, mode};
+    const auto node = sourcerer.source();
+    CHECK(node.size() == 2);
+    CHECK(node.at("key").as<int>() == 3);
+  }
+}
+
+TEST_CASE("Invalid JSON throws") {
+  for (const auto* text : {R"({"key": })", R"([1, 2)", R"({"a": 1} trailing)", ""}) {
+    StringConjurer conjurer{text};
+    CHECK_THROWS_AS(JsonSourcerer{conjurer}, nlohmann::json::parse_error);
+    CHECK_THROWS_AS((JsonSourcerer{conjurer, nullptr, JsonSourcerer::parse_mode::dom}),
+                    nlohmann::json::parse_error);
+    CHECK_THROWS_AS((JsonSourcerer{conjurer, nullptr, JsonSourcerer::parse_mode::simd}),
+                    std::invalid_argument);
+  }
+}
+
+TEST_CASE("Source into a user supplied resource") {
+  std::array<std::byte, 4096> buffer{};
+  std::pmr::monotonic_buffer_resource resource{buffer.data(), buffer.size(),
+                                               std::pmr::null_memory_resource()};
+
+  StringConjurer conjurer{R"({"a_rather_long_key_name": ["a rather long string value"]})"};
+  JsonSourcerer sourcerer{conjurer, &resource};
+
+  const auto node = sourcerer.source();
+  CHECK(node.at("a_rather_long_key_name").at(0).as<std::string>() == "a rather long string value");
+  CHECK(node.get_allocator().resource() == std::pmr::get_default_resource());
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,194 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+#include <sourcerer/sourcerers/layered_sourcerer.hpp>
+
+#include <doctest.h>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_SUITE_BEGIN("[LayeredSourcerer]");
+using namespace sourcerer;
+
+namespace {
+
+constexpr auto defaults = R"({
+  "name": "service",
+  "port": 80,
+  "tls": {"enabled": false, "cert": "default.pem", "ciphers": ["a", "b"]},
+  "limits": {"connections": 100, "timeouts": {"read": 5, "write": 5}},
+  "hosts": ["a", "b"]
+})";
+
+constexpr auto site = R"({
+  "tls": {"enabled": true},
+  "limits": {"timeouts": {"read": 10}},
+  "region": "eu"
+})";
+
+constexpr auto overrides = R"({
+  "port": 8080,
+  "limits": {"timeouts": {"write": 20}},
+  "hosts": ["c"]
+})";
+
+constexpr auto merged = R"({
+  "name": "service",
+  "port": 8080,
+  "tls": {"enabled": true, "cert": "default.pem", "ciphers": ["a", "b"]},
+  "limits": {"connections": 100, "timeouts": {"read": 10, "write": 20}},
+  "hosts": ["c"],
+  "region": "eu"
+})";
+
+Node parse(const char* text) {
+  StringConjurer conjurer{text};
+  return JsonSourcerer{conjurer}.source();
+}
+
+// Sources a tree that can be replaced, like a file that is edited.
+class Layer : public Sourcerer {
+ public:
+  explicit Layer(const char* text) : node_{parse(text)} {}
+
+  Node source() override { return node_; }
+
+  void set(const char* text) { node_ = parse(text); }
+
+ private:
+  Node node_;
+};
+
+}  // namespace
+
+TEST_CASE("Lookups fall through the layers") {
+  Layer bottom{defaults};
+  Layer middle{site};
+  Layer top{overrides};
+  LayeredSourcerer sourcerer{{bottom, middle, top}};
+  const auto root = sourcerer.root();
+
+  CHECK(sourcerer.layers() == 3);
+  CHECK(root.is_object());
+  CHECK(root.at("name").as<std::string>() == "service");
+  CHECK(root.at("port").as<int>() == 8080);
+  CHECK(root.at("region").as<std::string>() == "eu");
+  CHECK(root["tls"]["enabled"].as<bool>());
+  CHECK(root["tls"]["cert"].as<std::string>() == "default.pem");
+  CHECK(root["tls"]["ciphers"][1].as<std::string>() == "b");
+  CHECK(root["limits"]["connections"].as<int>() == 100);
+  CHECK(root["limits"]["timeouts"]["read"].as<int>() == 10);
+  CHECK(root["limits"]["timeouts"]["write"].as<int>() == 20);
+
+  // Arrays are replaced, not merged.
+  CHECK(root.at("hosts").size() == 1);
+  CHECK(root.at("hosts").at(0).as<std::string>() == "c");
+
+  CHECK(root.size() == 6);
+  CHECK(root.at("limits").at("timeouts").size() == 2);
+  CHECK_FALSE(root.contains("missing"));
+  CHECK_THROWS_AS(root.at("missing"), std::out_of_range);
+  CHECK_THROWS_AS(root.at("hosts").at(1), std::out_of_range);
+  CHECK_THROWS_AS(root.at(0), std::invalid_argument);
+  CHECK_THROWS_AS(root.at("name").at("name"), std::invalid_argument);
+
+  // Only the objects several layers have are merged: the roots, tls, limits and timeouts.
+  CHECK(sourcerer.merged() == 4);
+}
+
+TEST_CASE("Values hide the layers below them") {
+  Layer bottom{R"({"a": {"x": 1}, "b": {"x": 1}})"};
+  Layer middle{R"({"a": 5, "b": {"y": 2}})"};
+  Layer top{R"({"a": {"y": 2}, "b": null})"};
+  LayeredSourcerer sourcerer{{bottom, middle, top}};
+  const auto root = sourcerer.root();
+
+  CHECK_FALSE(root.at("a").contains("x"));
+  CHECK(root.at("a").at("y").as<int>() == 2);
+  CHECK(root.at("b").is_null());
+
+  Layer scalar{"1"};
+  LayeredSourcerer hidden{{bottom, scalar}};
+  CHECK(hidden.root().as<int>() == 1);
+  LayeredSourcerer shown{{scalar, bottom}};
+  CHECK(shown.root().at("a").at("x").as<int>() == 1);
+}
+
+TEST_CASE("Iterate") {
+  Layer bottom{defaults};
+  Layer middle{site};
+  Layer top{overrides};
+  LayeredSourcerer sourcerer{{bottom, middle, top}};
+  const auto root = sourcerer.root();
+
+  std::vector<std::string> keys;
+  for (const auto member : root) {
+    keys.emplace_back(member.key());
+  }
+  CHECK(keys == std::vector<std::string>{"hosts", "limits", "name", "port", "region", "tls"});
+
+  std::vector<std::string> timeouts;
+  for (const auto member : root.at("limits").at("timeouts")) {
+    timeouts.push_back(std::string{member.key()} + "=" + member.as<std::string>());
+  }
+  CHECK(timeouts == std::vector<std::string>{"read=10", "write=20"});
+
+  const auto ciphers = root.at("tls").at("ciphers");
+  CHECK(std::distance(ciphers.begin(), ciphers.end()) == 2);
+  CHECK_THROWS_AS((*ciphers.begin()).key(), std::logic_error);
+
+  // Values iterate over themselves.
+  const auto name = root.at("name");
+  CHECK(std::distance(name.begin(), name.end()) == 1);
+  CHECK((*name.begin()).as<std::string>() == "service");
+}
+
+TEST_CASE("Source") {
+  Layer bottom{defaults};
+  Layer middle{site};
+  Layer top{overrides};
+  LayeredSourcerer sourcerer{{bottom, middle, top}};
+
+  CHECK(sourcerer.source() == parse(merged));
+  CHECK(sourcerer.root().at("tls").node() == parse(merged).at("tls"));
+  CHECK(sourcerer.root().at("hosts").node() == parse(merged).at("hosts"));
+
+  // The layers stay untouched.
+  CHECK(bottom.source() == parse(defaults));
+  CHECK(middle.source() == parse(site));
+
+  // Copies of the merged tree share its containers, merging didn't leak them.
+  const auto tree = sourcerer.source();
+  Node copies;
+  copies.push_back(tree);
+  copies.push_back(tree);
+  Node nulls;
+  nulls.push_back(Node{});
+  nulls.push_back(Node{});
+  CHECK(copies.memory_usage().containers ==
+        nulls.memory_usage().containers + tree.memory_usage().containers);
+}
+
+TEST_CASE("Reload") {
+  Layer bottom{defaults};
+  Layer top{overrides};
+  LayeredSourcerer sourcerer{{bottom, top}};
+  CHECK(sourcerer.root().at("port").as<int>() == 8080);
+
+  top.set(R"({"port": 9090})");
+  CHECK(sourcerer.root().at("port").as<int>() == 8080);
+  sourcerer.reload(1);
+  CHECK(sourcerer.root().at("port").as<int>() == 9090);
+  CHECK(sourcerer.root().at("hosts").size() == 2);
+
+  bottom.set(R"({"name": "renamed"})");
+  sourcerer.reload();
+  CHECK(sourcerer.root().at("name").as<std::string>() == "renamed");
+  CHECK(sourcerer.root().size() == 2);
+
+  CHECK_THROWS_AS(sourcerer.reload(2), std::out_of_range);
+  CHECK_THROWS_AS(LayeredSourcerer{{}}, std::invalid_argument);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,133 @@
+#include <sourcerer/conjurers/string_conjurer.hpp>
+#include <sourcerer/sourcerers/json_sourcerer.hpp>
+#include <sourcerer/sourcerers/lazy_json_sourcerer.hpp>
+
+#include <cstdint>
+#include <doctest.h>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST_SUITE_BEGIN("[LazyJsonSourcerer]");
+using namespace sourcerer;
+
+namespace {
+
+constexpr auto document = R"({
+  "name": "sourcerer",
+  "servers": [
+    {"host": "a", "port": 1, "tls": {"cert": "a.pem"}},
+    {"host": "b", "port": 2, "tls": {"cert": "b.pem"}}
+  ],
+  "limits": {"u": 18446744073709551615, "i": -1, "f": 0.5, "flag": true, "none": null},
+  "escaped \"key\"": "line\nbreak",
+  "duplicate": 1,
+  "duplicate": 2
+})";
+
+}  // namespace
+
+TEST_CASE("Navigate") {
+  StringConjurer conjurer{document};
+  LazyJsonSourcerer sourcerer{conjurer};
+  const auto root = sourcerer.root();
+
+  CHECK(sourcerer.cached() == 0);
+  CHECK(root.is_object());
+  CHECK(root.at("name").as<std::string>() == "sourcerer");
+  CHECK(root["servers"][1]["tls"]["cert"].as<std::string>() == "b.pem");
+  CHECK(root.at("servers").size() == 2);
+  CHECK(root.at("limits").at("u").as<std::uint64_t>() == 18446744073709551615ULL);
+  CHECK(root.at("limits").at("i").as<int>() == -1);
+  CHECK(root.at("limits").at("f").as<double>() == 0.5);
+  CHECK(root.at("limits").at("flag").as<bool>());
+  CHECK(root.at("limits").at("none").is_null());
+  CHECK(root.at("escaped \"key\"").as<std::string>() == "line\nbreak");
+  CHECK(root.at("duplicate").as<int>() == 2);
+
+  CHECK_FALSE(root.contains("missing"));
+  CHECK_THROWS_AS(root.at("missing"), std::out_of_range);
+  CHECK_THROWS_AS(root.at("servers").at(2), std::out_of_range);
+  CHECK_THROWS_AS(root.at(0), std::invalid_argument);
+  CHECK_THROWS_AS(root.at("name").at("name"), std::invalid_argument);
+
+  // Only the containers that were looked into have a directory.
+  CHECK(sourcerer.cached() == 5);
+}
+
+TEST_CASE("Iterate") {
+  StringConjurer conjurer{document};
+  LazyJsonSourcerer sourcerer{conjurer};
+  const auto root = sourcerer.root();
+
+  std::vector<std::string> keys;
+  for (const auto member : root) {
+    keys.push_back(member.key());
+  }
+  CHECK(keys == std::vector<std::string>{"name", "servers", "limits", "escaped \"key\"",
+                                         "duplicate", "duplicate"});
+  // Repeated keys are a member each, lookups and node() see the last one.
+  CHECK(root.size() == 6);
+  CHECK(root.node().size() == 5);
+  CHECK(root.at("duplicate").as<int>() == 2);
+
+  std::vector<int> ports;
+  for (const auto server : root.at("servers")) {
+    ports.push_back(server.at("port").as<int>());
+  }
+  CHECK(ports == std::vector<int>{1, 2});
+  CHECK_THROWS_AS(root.at("servers").at(0).key(), std::logic_error);
+
+  // Values iterate over themselves.
+  const auto name = root.at("name");
+  CHECK(std::distance(name.begin(), name.end()) == 1);
+  CHECK((*name.begin()).as<std::string>() == "sourcerer");
+  CHECK(root.at("limits").at("none").begin() == root.at("limits").at("none").end());
+}
+
+TEST_CASE("Materialize") {
+  StringConjurer conjurer{document};
+  LazyJsonSourcerer sourcerer{conjurer};
+  JsonSourcerer eager{conjurer};
+
+  CHECK(sourcerer.source() == eager.source());
+
+  const auto servers = sourcerer.root().at("servers");
+  const auto first = servers.node();
+  const auto second = servers.node();
+  CHECK(first == eager.source().at("servers"));
+  // Later calls share the cached subtree.
+  CHECK(&first.at(0) == &second.at(0));
+
+  CHECK(sourcerer.root().at("name").node().as<std::string>() == "sourcerer");
+}
+
+TEST_CASE("Evict") {
+  StringConjurer conjurer{document};
+  LazyJsonSourcerer sourcerer{conjurer, 2};
+  const auto root = sourcerer.root();
+
+  auto snapshot = root.at("servers").node();
+  CHECK(root.at("limits").at("i").as<int>() == -1);
+  CHECK(root.at("servers").at(0).at("host").as<std::string>() == "a");
+  CHECK(sourcerer.cached() == 2);
+
+  sourcerer.evict();
+  CHECK(sourcerer.cached() == 0);
+
+  // Snapshots outlive the cache, and evicted containers are rebuilt.
+  CHECK(snapshot.at(1).at("host").as<std::string>() == "b");
+  snapshot[0]["port"] = Node{3};
+  CHECK(root.at("servers").node().at(0).at("port").as<int>() == 1);
+}
+
+TEST_CASE("Invalid JSON throws") {
+  // Escapes are checked up front too, not when their strings are read.
+  for (const auto* text : {R"({"key": [1, 2})", R"(["\ud800"])", R"(["\udc00"])",
+                           R"(["\ud800\u0041"])", R"({"\ud800x": 1})"}) {
+    StringConjurer conjurer{text};
+    CHECK_THROWS_AS(LazyJsonSourcerer{conjurer}, std::invalid_argument);
+  }
+}
+
+TEST_SUITE_END();
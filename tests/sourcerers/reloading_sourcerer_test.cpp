@@ -0,0 +1,187 @@
+#include <sourcerer/sourcerers/reloading_sourcerer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <doctest.h>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+TEST_SUITE_BEGIN("[ReloadingSourcerer]");
+using namespace sourcerer;
+
+namespace {
+
+constexpr std::chrono::seconds timeout{5};
+
+// A directory of its own for every test, removed at the end of it.
+class Directory {
+ public:
+  explicit Directory(const std::string& name)
+      : path_{std::filesystem::temp_directory_path() / ("sourcerer_reloading_" + name)} {
+    std::filesystem::remove_all(path_);
+    std::filesystem::create_directories(path_);
+  }
+  ~Directory() { std::filesystem::remove_all(path_); }
+
+  std::filesystem::path write(const std::string& name, const std::string& text) const {
+    const auto file = path_ / name;
+    std::ofstream{file} << text;
+    return file;
+  }
+
+  // Writes a new file next to the old one and renames it over it, like editors do.
+  void replace(const std::string& name, const std::string& text) const {
+    write(name + ".tmp", text);
+    std::filesystem::rename(path_ / (name + ".tmp"), path_ / name);
+  }
+
+ private:
+  std::filesystem::path path_;
+};
+
+std::vector<std::string> paths(const ReloadReport& report) {
+  std::vector<std::string> result;
+  for (const auto& path : report.changed) {
+    result.push_back(path.str());
+  }
+  return result;
+}
+
+}  // namespace
+
+TEST_CASE("Patch the changes") {
+  Directory directory{"patch"};
+  const auto file = directory.write("config.json", R"({
+    "name": "service",
+    "db": {"host": "localhost", "port": 5432, "pool": {"size": 10, "idle": 2}},
+    "hosts": ["a", "b", "c"],
+    "limits": {"rate": 1}
+  })");
+
+  ReloadingSourcerer sourcerer{file};
+  const auto& root = sourcerer.root();
+  CHECK(root.at("db").at("port").as<int>() == 5432);
+  CHECK(sourcerer.poll().empty());
+
+  const auto* pool = &root.at("db").at("pool");
+  const auto* size = &pool->at("size");
+  const auto* name = &root.at("name");
+
+  directory.write("config.json", R"({
+    "name": "service",
+    "db": {"host": "db.internal", "port": 5432, "pool": {"size": 10, "idle": 2}},
+    "hosts": ["a", "x"],
+    "limits": {"rate": 1.5, "burst": 5}
+  })");
+  const auto report = sourcerer.wait(timeout);
+  CHECK(report.failed.empty());
+  CHECK(paths(report) ==
+        std::vector<std::string>{"db.host", "hosts[1]", "hosts[2]", "limits.rate", "limits.burst"});
+
+  // Unchanged nodes stay where they are, and references to them see the new values.
+  CHECK(root.at("db").at("host").as<std::string>() == "db.internal");
+  CHECK(&root.at("db").at("pool") == pool);
+  CHECK(&root.at("db").at("pool").at("size") == size);
+  CHECK(&root.at("name") == name);
+  CHECK(root.at("hosts").size() == 2);
+  CHECK(root.at("limits").at("rate").is_floating());
+
+  // Writing the same tree again changes nothing.
+  directory.write("config.json", R"({
+    "name": "service",
+    "db": {"host": "db.internal", "port": 5432, "pool": {"size": 10, "idle": 2}},
+    "hosts": ["a", "x"],
+    "limits": {"rate": 1.5, "burst": 5}
+  })");
+  CHECK(sourcerer.wait(timeout).empty());
+
+  // Values are replaced in place, even by a value of another type.
+  const auto* db = &root.at("db");
+  directory.replace("config.json", R"({"name": "service", "db": 5})");
+  CHECK(paths(sourcerer.wait(timeout)) == std::vector<std::string>{"hosts", "limits", "db"});
+  CHECK(root.at("db").as<int>() == 5);
+  CHECK(&root.at("db") == db);
+
+  // Integers that round to the same double are different values.
+  directory.write("config.json", R"({"name": "service", "db": 5, "ts": 1760000000000000001})");
+  CHECK(paths(sourcerer.wait(timeout)) == std::vector<std::string>{"ts"});
+  directory.write("config.json", R"({"name": "service", "db": 5, "ts": 1760000000000000100})");
+  CHECK(paths(sourcerer.wait(timeout)) == std::vector<std::string>{"ts"});
+  CHECK(root.at("ts").as<std::int64_t>() == 1760000000000000100);
+}
+
+TEST_CASE("Mounted files") {
+  Directory directory{"mounted"};
+  const auto first = directory.write("first.json", R"({"a": {"b": 1}})");
+  const auto second = directory.write("second.json", R"([1, 2])");
+
+  ReloadingSourcerer sourcerer{{{"first", first}, {"second.json", second}}};
+  CHECK(sourcerer.files() == 2);
+  const auto& root = sourcerer.root();
+  CHECK(root.at("first").at("a").at("b").as<int>() == 1);
+  CHECK(root.at("second.json").at(1).as<int>() == 2);
+
+  // A snapshot keeps the tree it was taken of.
+  const auto snapshot = sourcerer.source();
+
+  directory.write("second.json", R"([1, 3])");
+  directory.write("unrelated.json", R"([])");
+  const auto report = sourcerer.wait(timeout);
+  CHECK(paths(report) == std::vector<std::string>{R"(["second.json"][1])"});
+  CHECK(Path{report.changed.front().str()}.at(root).as<int>() == 3);
+  CHECK(snapshot.at("second.json").at(1).as<int>() == 2);
+
+  CHECK(paths(sourcerer.reload()).empty());
+  directory.write("first.json", R"({"a": {"b": 2}})");
+  CHECK(paths(sourcerer.reload(0)) == std::vector<std::string>{"first.a.b"});
+  CHECK_THROWS_AS(sourcerer.reload(2), std::out_of_range);
+
+  CHECK_THROWS_AS(ReloadingSourcerer({{"first", first}, {"first", second}}), std::invalid_argument);
+}
+
+// Files fail to load with the exceptions of their parsers.
+#if SOURCERER_EXCEPTIONS
+TEST_CASE("Failing files") {
+  Directory directory{"failing"};
+  const auto file = directory.write("config.json", R"({"port": 80})");
+  ReloadingSourcerer sourcerer{file};
+
+  directory.write("config.json", R"({"port": )");
+  const auto report = sourcerer.wait(timeout);
+  CHECK(report.changed.empty());
+  REQUIRE(report.failed.size() == 1);
+  CHECK(report.failed.front().first == file);
+  CHECK(sourcerer.root().at("port").as<int>() == 80);
+
+  directory.write("config.json", R"({"port": 81})");
+  CHECK(paths(sourcerer.wait(timeout)) == std::vector<std::string>{"port"});
+
+  CHECK_THROWS_AS(ReloadingSourcerer{directory.write("broken.json", "{")}, std::exception);
+}
+
+TEST_CASE("Failing construction") {
+  // The descriptors this process has open, where the system lists them.
+  const auto descriptors = [] {
+    std::error_code error;
+    std::filesystem::directory_iterator it{"/proc/self/fd", error};
+    return error ? 0 : std::distance(it, std::filesystem::directory_iterator{});
+  };
+
+  Directory directory{"construction"};
+  const auto file = directory.write("config.json", "{}");
+  const auto missing = file.parent_path() / "missing.json";
+  const auto before = descriptors();
+
+  // Constructors that throw close the descriptors they opened.
+  CHECK_THROWS_AS(ReloadingSourcerer{missing}, std::exception);
+  CHECK_THROWS_AS(ReloadingSourcerer({{"config", file}, {"missing", missing}}), std::exception);
+  CHECK(descriptors() == before);
+}
+#endif
+
+TEST_SUITE_END();
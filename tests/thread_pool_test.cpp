@@ -0,0 +1,80 @@
+#include <sourcerer/thread_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <doctest.h>
+#include <functional>
+#include <latch>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+TEST_SUITE_BEGIN("[ThreadPool]");
+using namespace sourcerer;
+
+TEST_CASE("Execute") {
+  std::atomic<int> sum{0};
+  {
+    ThreadPool pool{4};
+    CHECK(pool.size() == 4);
+    for (int i = 1; i <= 1000; ++i) {
+      pool.execute([&sum, i] { sum += i; });
+    }
+  }
+  // The destructor runs the queued tasks.
+  CHECK(sum == 500500);
+
+  CHECK(ThreadPool::default_size() >= 1);
+  CHECK_THROWS_AS(ThreadPool{0}, std::invalid_argument);
+}
+
+TEST_CASE("Tasks submit tasks") {
+  std::atomic<int> count{0};
+  std::latch done{1 + 10 + 100};
+  ThreadPool pool{3};
+
+  std::function<void(int)> spawn = [&](const int depth) {
+    ++count;
+    if (depth < 2) {
+      for (int i = 0; i < 10; ++i) {
+        pool.execute([&spawn, depth] { spawn(depth + 1); });
+      }
+    }
+    done.count_down();
+  };
+  pool.execute([&] { spawn(0); });
+  done.wait();
+  CHECK(count == 111);
+}
+
+TEST_CASE("Idle threads steal") {
+  ThreadPool pool{4};
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  std::thread::id blocked;
+  std::latch done{4};
+
+  // One task submits all others to the queue of its own thread and blocks that thread, so the
+  // others can only run if they are stolen.
+  pool.execute([&] {
+    blocked = std::this_thread::get_id();
+    for (int i = 0; i < 3; ++i) {
+      pool.execute([&] {
+        {
+          std::scoped_lock lock{mutex};
+          threads.insert(std::this_thread::get_id());
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds{1});
+        done.count_down();
+      });
+    }
+    done.count_down();
+    done.wait();
+  });
+  done.wait();
+  CHECK_FALSE(threads.empty());
+  CHECK_FALSE(threads.contains(blocked));
+}
+
+TEST_SUITE_END();